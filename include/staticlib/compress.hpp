@@ -26,15 +26,46 @@
 
 #include "staticlib/config.hpp"
 
+#include "staticlib/compress/adaptive_level.hpp"
+#include "staticlib/compress/auto_decompress_source.hpp"
+#include "staticlib/compress/compress_batch.hpp"
 #include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/compressed_buffer.hpp"
+#include "staticlib/compress/decode_result.hpp"
+#include "staticlib/compress/deflate_buffer.hpp"
+#include "staticlib/compress/deflate_dictionary.hpp"
+#include "staticlib/compress/deflate_memory_profile.hpp"
 #include "staticlib/compress/deflate_sink.hpp"
+#include "staticlib/compress/deflate_source.hpp"
+#include "staticlib/compress/deflate_stream.hpp"
+#include "staticlib/compress/inflate_decoder.hpp"
+#include "staticlib/compress/inflate_sink.hpp"
 #include "staticlib/compress/inflate_source.hpp"
+#include "staticlib/compress/latency_histogram.hpp"
 #ifdef STATCILIB_COMPRESS_ENABLE_XZ
+#include "staticlib/compress/lzma_buffer.hpp"
+#include "staticlib/compress/lzma_decode_sink.hpp"
+#include "staticlib/compress/lzma_decoder.hpp"
+#include "staticlib/compress/lzma_encode_source.hpp"
+#include "staticlib/compress/lzma_encode_stream.hpp"
+#include "staticlib/compress/lzma_filter_chain.hpp"
+#include "staticlib/compress/lzma_seekable_source.hpp"
 #include "staticlib/compress/lzma_sink.hpp"
 #include "staticlib/compress/lzma_source.hpp"
 #endif // STATCILIB_COMPRESS_ENABLE_XZ
+#include "staticlib/compress/parallel_inflate_source.hpp"
+#include "staticlib/compress/rsyncable_chunker.hpp"
+#include "staticlib/compress/thread_local_contexts.hpp"
+#include "staticlib/compress/timed_sink.hpp"
+#include "staticlib/compress/timed_source.hpp"
 #include "staticlib/compress/zip_compression_method.hpp"
+#include "staticlib/compress/zip_entry.hpp"
+#include "staticlib/compress/zip_entry_cache.hpp"
+#include "staticlib/compress/zip_extract.hpp"
+#include "staticlib/compress/zip_reader.hpp"
 #include "staticlib/compress/zip_sink.hpp"
+#include "staticlib/compress/zip_source.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
 
 #endif /* STATICLIB_COMPRESS_HPP */
 
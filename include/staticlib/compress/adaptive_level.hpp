@@ -0,0 +1,145 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   adaptive_level.hpp
+ * Author: alex
+ *
+ * Created on October 20, 2026, 3:10 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_ADAPTIVE_LEVEL_HPP
+#define STATICLIB_COMPRESS_ADAPTIVE_LEVEL_HPP
+
+#include <cstdint>
+#include <algorithm>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Controller that adjusts compression level of a stream depending
+ * on the time spent in the codec and in the downstream sink.
+ * After each window of input data level is lowered if compression
+ * took noticeably longer than writing the output (CPU-bound), and raised
+ * if the output sink was the bottleneck (link-bound), so the compression
+ * stays off the critical path with the best ratio the sink speed allows.
+ */
+class adaptive_level {
+    int min_level;
+    int max_level;
+    uint64_t window_size;
+    int level;
+    uint64_t window_bytes = 0;
+    uint64_t codec_nanos = 0;
+    uint64_t sink_nanos = 0;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param min_level minimal compression level
+     * @param max_level maximal compression level
+     * @param window_size number of input bytes between level adjustments
+     */
+    adaptive_level(int min_level = 1, int max_level = 9, uint64_t window_size = 1 << 20) :
+    min_level(min_level),
+    max_level(max_level),
+    window_size(window_size),
+    level(max_level) {
+        if (min_level < 0 || max_level > 9 || min_level > max_level) throw compress_exception(TRACEMSG(
+                "Invalid compression levels range, min: [" + sl::support::to_string(min_level) + "]," +
+                " max: [" + sl::support::to_string(max_level) + "]"));
+        if (0 == window_size) throw compress_exception(TRACEMSG(
+                "Invalid zero window size"));
+    }
+
+    /**
+     * Sets the current level, value is clamped to the allowed range
+     *
+     * @param initial_level compression level
+     */
+    void reset(int initial_level) {
+        level = clamp(initial_level);
+        window_bytes = 0;
+        codec_nanos = 0;
+        sink_nanos = 0;
+    }
+
+    /**
+     * Records the measurements of a single write call
+     *
+     * @param bytes_in number of input bytes processed
+     * @param codec time spent in the codec, in nanoseconds
+     * @param sink time spent in the downstream sink, in nanoseconds
+     * @return true if window is complete and "adjust()" should be called
+     */
+    bool record(uint64_t bytes_in, uint64_t codec, uint64_t sink) {
+        window_bytes += bytes_in;
+        codec_nanos += codec;
+        sink_nanos += sink;
+        return window_bytes >= window_size;
+    }
+
+    /**
+     * Chooses the level for the next window and starts a new window
+     *
+     * @return compression level for the next window
+     */
+    int adjust() {
+        // hysteresis: codec time within [sink/2, sink*5/4] keeps the level
+        if (4 * codec_nanos > 5 * sink_nanos) {
+            level = std::max(level - 1, min_level);
+        } else if (2 * codec_nanos < sink_nanos) {
+            level = std::min(level + 1, max_level);
+        }
+        window_bytes = 0;
+        codec_nanos = 0;
+        sink_nanos = 0;
+        return level;
+    }
+
+    /**
+     * Clamps specified level to the allowed range
+     *
+     * @param lvl compression level
+     * @return level within [min_level, max_level]
+     */
+    int clamp(int lvl) const {
+        return std::min(std::max(lvl, min_level), max_level);
+    }
+
+    /**
+     * Current level accessor
+     *
+     * @return current compression level
+     */
+    int get_level() const {
+        return level;
+    }
+
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_ADAPTIVE_LEVEL_HPP */
+
@@ -0,0 +1,427 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   auto_decompress_source.hpp
+ * Author: alex
+ *
+ * Created on October 20, 2026, 5:20 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_AUTO_DECOMPRESS_SOURCE_HPP
+#define STATICLIB_COMPRESS_AUTO_DECOMPRESS_SOURCE_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <array>
+#include <ios>
+#include <memory>
+#include <type_traits>
+
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+#include "lzma.h"
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Formats of compressed data recognized by "auto_decompress_source"
+ */
+enum class compression_format {
+    unknown,
+    raw_deflate,
+    zlib,
+    gzip,
+    xz
+};
+
+/**
+ * Detects the format of compressed data from its first bytes,
+ * data without known magic number is assumed to be raw Deflate
+ *
+ * @param head first bytes of compressed data, 6 bytes are enough
+ * @return detected format, "unknown" if specified span is empty
+ */
+inline compression_format detect_compression_format(sl::io::span<const char> head) {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(head.data());
+    size_t len = head.size();
+    if (0 == len) {
+        return compression_format::unknown;
+    }
+    if (len >= 3 && 0x1f == data[0] && 0x8b == data[1] && 0x08 == data[2]) {
+        return compression_format::gzip;
+    }
+    if (len >= 6 && 0xfd == data[0] && 0 == std::memcmp(data + 1, "7zXZ\0", 5)) {
+        return compression_format::xz;
+    }
+    // CM = 8, CINFO <= 7, header checksum
+    if (len >= 2 && 8 == (data[0] & 0x0f) && (data[0] >> 4) <= 7 &&
+            0 == ((static_cast<unsigned int>(data[0]) << 8) + data[1]) % 31) {
+        return compression_format::zlib;
+    }
+    return compression_format::raw_deflate;
+}
+
+/**
+ * Source wrapper that decompresses raw Deflate, zlib, gzip and XZ data,
+ * format is detected from the magic number at the start of each member.
+ * Concatenated members of different formats are decompressed into
+ * a single stream. Format dispatch happens once per read call, decoders
+ * are created lazily and are reused for the subsequent members.
+ * XZ is supported only when the library is built with XZ support.
+ */
+template <typename Source, std::size_t buf_size = 4096>
+class auto_decompress_source {
+    /**
+     * Source of compressed data
+     */
+    Source src;
+    /**
+     * Internal buffer
+     */
+    std::array<char, buf_size> buf;
+    /**
+     * Zlib decompressing stream, used for Deflate, zlib and gzip
+     */
+    detail::zlib_stream* zstrm = nullptr;
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+    /**
+     * LZMA decompressing stream
+     */
+    lzma_stream* xstrm = nullptr;
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+    /**
+     * Start position in internal buffer
+     */
+    size_t pos = 0;
+    /**
+     * Number of bytes available in internal buffer
+     */
+    size_t avail = 0;
+    /**
+     * Source EOF flag
+     */
+    bool exhausted = false;
+    /**
+     * Format of the member being decompressed, "unknown" between members
+     */
+    compression_format format = compression_format::unknown;
+    /**
+     * Format of the last started member
+     */
+    compression_format last_format = compression_format::unknown;
+
+public:
+    /**
+     * Constructor, created object will own the specified source
+     *
+     * @param src source to read compressed data from
+     */
+    auto_decompress_source(Source src) :
+    src(std::move(src)) { }
+
+    ~auto_decompress_source() STATICLIB_NOEXCEPT {
+        free_streams();
+    }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    auto_decompress_source(const auto_decompress_source&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    auto_decompress_source& operator=(const auto_decompress_source&) = delete;
+
+    /**
+     * Move constructor
+     *
+     * @param other other instance
+     */
+    auto_decompress_source(auto_decompress_source&& other) :
+    src(std::move(other.src)),
+    buf(std::move(other.buf)),
+    zstrm(other.zstrm),
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+    xstrm(other.xstrm),
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+    pos(other.pos),
+    avail(other.avail),
+    exhausted(other.exhausted),
+    format(other.format),
+    last_format(other.last_format) {
+        other.zstrm = nullptr;
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+        other.xstrm = nullptr;
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+    }
+
+    /**
+     * Move assignment operator
+     *
+     * @param other other instance
+     * @return this instance
+     */
+    auto_decompress_source& operator=(auto_decompress_source&& other) {
+        free_streams();
+        src = std::move(other.src);
+        buf = std::move(other.buf);
+        zstrm = other.zstrm;
+        other.zstrm = nullptr;
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+        xstrm = other.xstrm;
+        other.xstrm = nullptr;
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+        pos = other.pos;
+        avail = other.avail;
+        exhausted = other.exhausted;
+        format = other.format;
+        last_format = other.last_format;
+        return *this;
+    }
+
+    /**
+     * Read implementation
+     *
+     * @param span output span
+     * @return number of bytes written into specified span
+     */
+    std::streamsize read(sl::io::span<char> span) {
+        for (;;) {
+            if (compression_format::unknown == format && !start_member()) {
+                return std::char_traits<char>::eof();
+            }
+            bool member_end = false;
+            std::streamsize written = compression_format::xz == format ?
+                    read_xz(span, member_end) : read_zlib(span, member_end);
+            if (member_end) {
+                format = compression_format::unknown;
+            }
+            if (written > 0 || !member_end) {
+                return written;
+            }
+        }
+    }
+
+    /**
+     * Format accessor
+     *
+     * @return format of the current (or last finished) member,
+     *         "unknown" if no data was read yet
+     */
+    compression_format get_format() const {
+        return last_format;
+    }
+
+    /**
+     * Underlying source accessor
+     *
+     * @return underlying source reference
+     */
+    Source& get_source() {
+        return src;
+    }
+
+private:
+    void fill(size_t min_avail) {
+        if (avail >= min_avail || exhausted) return;
+        if (avail > 0 && pos > 0) {
+            std::memmove(buf.data(), buf.data() + pos, avail);
+        }
+        pos = 0;
+        size_t len = buf.size() - avail;
+        size_t read = sl::io::read_all(src, {buf.data() + avail, len});
+        avail += read;
+        exhausted = read < len;
+    }
+
+    bool start_member() {
+        fill(6);
+        // XZ streams may be followed by zero padding
+        while (compression_format::xz == last_format && avail > 0 && '\0' == buf[pos]) {
+            pos += 1;
+            avail -= 1;
+            fill(6);
+        }
+        auto detected = detect_compression_format({buf.data() + pos, avail});
+        switch (detected) {
+        case compression_format::unknown:
+            return false;
+        case compression_format::xz:
+            reset_xz();
+            break;
+        case compression_format::zlib:
+            reset_zlib(MAX_WBITS);
+            break;
+        case compression_format::gzip:
+            reset_zlib(MAX_WBITS + 16);
+            break;
+        default:
+            reset_zlib(-MAX_WBITS);
+        }
+        format = detected;
+        last_format = detected;
+        return true;
+    }
+
+    std::streamsize read_zlib(sl::io::span<char> span, bool& member_end) {
+        fill(1);
+        zstrm->next_in = reinterpret_cast<unsigned char*> (buf.data() + pos);
+        zstrm->avail_in = static_cast<detail::zlib_uint> (avail);
+        zstrm->next_out = reinterpret_cast<unsigned char*> (span.data());
+        zstrm->avail_out = static_cast<detail::zlib_uint> (span.size());
+        auto err = detail::zlib_inflate(zstrm, Z_NO_FLUSH);
+        if (Z_OK != err && Z_STREAM_END != err && Z_BUF_ERROR != err) throw compress_exception(TRACEMSG(
+                "Inflate error: [" + detail::zlib_error(err) + "]"));
+        size_t read = avail - zstrm->avail_in;
+        size_t written = span.size() - zstrm->avail_out;
+        consume(read, written, span.size());
+        member_end = Z_STREAM_END == err;
+        return static_cast<std::streamsize>(written);
+    }
+
+    std::streamsize read_xz(sl::io::span<char> span, bool& member_end) {
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+        fill(1);
+        xstrm->next_in = reinterpret_cast<uint8_t*> (buf.data() + pos);
+        xstrm->avail_in = avail;
+        xstrm->next_out = reinterpret_cast<uint8_t*> (span.data());
+        xstrm->avail_out = span.size();
+        auto err = ::lzma_code(xstrm, LZMA_RUN);
+        if (LZMA_OK != err && LZMA_STREAM_END != err && LZMA_BUF_ERROR != err) throw compress_exception(TRACEMSG(
+                "LZMA error, code: [" + sl::support::to_string(err) + "]"));
+        size_t read = avail - xstrm->avail_in;
+        size_t written = span.size() - xstrm->avail_out;
+        consume(read, written, span.size());
+        member_end = LZMA_STREAM_END == err;
+        return static_cast<std::streamsize>(written);
+#else
+        (void) span;
+        (void) member_end;
+        throw compress_exception(TRACEMSG("XZ support is not enabled"));
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+    }
+
+    void consume(size_t read, size_t written, size_t out_size) {
+        if (0 == read && 0 == written && out_size > 0 && 0 == avail && exhausted) {
+            throw compress_exception(TRACEMSG(
+                    "Unexpected end of compressed data"));
+        }
+        pos += read;
+        avail -= read;
+    }
+
+    void reset_zlib(int window_bits) {
+        if (nullptr == zstrm) {
+            detail::zlib_stream* stream = static_cast<detail::zlib_stream*> (std::malloc(sizeof(detail::zlib_stream)));
+            if (nullptr == stream) throw compress_exception(TRACEMSG(
+                    "Error creating inflate stream: 'malloc' failed"));
+            std::memset(stream, 0, sizeof (detail::zlib_stream));
+            auto err = detail::zlib_inflate_init2(stream, window_bits);
+            if (Z_OK != err) {
+                std::free(stream);
+                throw compress_exception(TRACEMSG(
+                        "Error initializing inflate stream: [" + detail::zlib_error(err) + "]"));
+            }
+            zstrm = stream;
+        } else {
+            auto err = detail::zlib_inflate_reset2(zstrm, window_bits);
+            if (Z_OK != err) throw compress_exception(TRACEMSG(
+                    "Error resetting inflate stream: [" + detail::zlib_error(err) + "]"));
+        }
+    }
+
+    void reset_xz() {
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+        if (nullptr == xstrm) {
+            lzma_stream* stream = static_cast<lzma_stream*> (std::malloc(sizeof(lzma_stream)));
+            if (nullptr == stream) throw compress_exception(TRACEMSG(
+                    "Error creating lzma stream: 'malloc' failed"));
+            *stream = LZMA_STREAM_INIT;
+            xstrm = stream;
+        }
+        // coder memory is reused by liblzma
+        auto err = ::lzma_stream_decoder(xstrm, UINT64_MAX, 0);
+        if (LZMA_OK != err) throw compress_exception(TRACEMSG(
+                "Error initializing LZMA stream, code: [" + sl::support::to_string(err) + "]"));
+#else
+        throw compress_exception(TRACEMSG("XZ support is not enabled"));
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+    }
+
+    void free_streams() STATICLIB_NOEXCEPT {
+        if (nullptr != zstrm) {
+            detail::zlib_inflate_end(zstrm);
+            std::free(zstrm);
+            zstrm = nullptr;
+        }
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+        if (nullptr != xstrm) {
+            ::lzma_end(xstrm);
+            std::free(xstrm);
+            xstrm = nullptr;
+        }
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+    }
+
+};
+
+/**
+ * Factory function for creating auto decompress sources,
+ * created object will own the specified source
+ *
+ * @param source input source
+ * @return auto decompress source
+ */
+template <typename Source,
+        class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+auto_decompress_source<Source> make_auto_decompress_source(Source&& source) {
+    return auto_decompress_source<Source>(std::move(source));
+}
+
+/**
+ * Factory function for creating auto decompress sources,
+ * created object will NOT own the specified source
+ *
+ * @param source input source
+ * @return auto decompress source
+ */
+template <typename Source>
+auto_decompress_source<sl::io::reference_source<Source>> make_auto_decompress_source(Source& source) {
+    return auto_decompress_source<sl::io::reference_source<Source>> (
+            sl::io::make_reference_source(source));
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_AUTO_DECOMPRESS_SOURCE_HPP */
+
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   compress_batch.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 3:05 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_COMPRESS_BATCH_HPP
+#define STATICLIB_COMPRESS_COMPRESS_BATCH_HPP
+
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/deflate_buffer.hpp"
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+#include "staticlib/compress/lzma_buffer.hpp"
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+#include "staticlib/compress/worker_pool.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Codecs supported for batch compression
+ */
+enum class batch_codec {
+    deflate,
+    lzma
+};
+
+/**
+ * Result of batch compression: compressed records are stored
+ * one after another in a single contiguous buffer
+ */
+class compressed_batch {
+    std::string data;
+    std::vector<size_t> offsets;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param data compressed records
+     * @param offsets offsets of records in data buffer, last element is data length
+     */
+    compressed_batch(std::string data, std::vector<size_t> offsets) :
+    data(std::move(data)),
+    offsets(std::move(offsets)) { }
+
+    /**
+     * Number of records in batch
+     *
+     * @return number of records
+     */
+    size_t size() const {
+        return offsets.size() - 1;
+    }
+
+    /**
+     * Compressed record accessor
+     *
+     * @param idx record index
+     * @return span pointing to compressed record
+     */
+    sl::io::span<const char> get(size_t idx) const {
+        return sl::io::span<const char>(data.data() + offsets.at(idx), offsets.at(idx + 1) - offsets.at(idx));
+    }
+
+    /**
+     * Buffer accessor
+     *
+     * @return buffer with all compressed records
+     */
+    const std::string& get_data() const {
+        return data;
+    }
+
+    /**
+     * Offsets table accessor
+     *
+     * @return offsets of records in buffer, last element is buffer length
+     */
+    const std::vector<size_t>& get_offsets() const {
+        return offsets;
+    }
+
+    /**
+     * Releases the spare capacity of the buffer and offsets table,
+     * buffer may keep the capacity it was allocated with for
+     * the upper bound of compressed sizes
+     */
+    void shrink_to_fit() {
+        data.shrink_to_fit();
+        offsets.shrink_to_fit();
+    }
+
+};
+
+namespace detail {
+
+inline size_t batch_bound(batch_codec codec, size_t len, int compression_level) {
+    switch (codec) {
+    case batch_codec::deflate: return deflate_bound(len, compression_level);
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+    case batch_codec::lzma: return lzma_encode_bound(len);
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+    default: throw compress_exception(TRACEMSG("Unsupported batch codec"));
+    }
+}
+
+inline size_t batch_compress_into(batch_codec codec, sl::io::span<const char> record,
+        sl::io::span<char> out, int compression_level) {
+    switch (codec) {
+    case batch_codec::deflate: return deflate_into(record, out, compression_level);
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+    case batch_codec::lzma: return lzma_encode_into(record, out, compression_level);
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+    default: throw compress_exception(TRACEMSG("Unsupported batch codec"));
+    }
+}
+
+inline size_t batch_decompress_into(batch_codec codec, sl::io::span<const char> record,
+        sl::io::span<char> out) {
+    switch (codec) {
+    case batch_codec::deflate: return inflate_into(record, out);
+#ifdef STATCILIB_COMPRESS_ENABLE_XZ
+    case batch_codec::lzma: return lzma_decode_into(record, out);
+#endif // STATCILIB_COMPRESS_ENABLE_XZ
+    default: throw compress_exception(TRACEMSG("Unsupported batch codec"));
+    }
+}
+
+} // namespace
+
+/**
+ * Compresses a batch of independent records using multiple threads.
+ * Output buffer is allocated once for the whole batch using the upper bound
+ * of compressed sizes, every record is compressed directly into its slot
+ * by one of the workers, that take records in small chunks and reuse
+ * thread-local codec states. Records are compacted after compression,
+ * when the unused part of the buffer exceeds 1/8 of the compressed size,
+ * compressed records are moved into an exact-size buffer, so the returned
+ * batch does not keep the uncompressed-sized allocation resident.
+ *
+ * @param records records to compress
+ * @param codec compression algorithm
+ * @param compression_level compression level
+ * @param threads number of worker threads, hardware concurrency is used if zero
+ * @return compressed records
+ */
+inline compressed_batch compress_batch(const std::vector<sl::io::span<const char>>& records,
+        batch_codec codec = batch_codec::deflate, int compression_level = 6, size_t threads = 0) {
+    // slots
+    auto offsets = std::vector<size_t>();
+    offsets.reserve(records.size() + 1);
+    size_t total = 0;
+    for (auto& rec : records) {
+        offsets.push_back(total);
+        total += detail::batch_bound(codec, rec.size(), compression_level);
+    }
+    offsets.push_back(total);
+    auto data = std::string();
+    data.resize(total);
+    auto lengths = std::vector<size_t>(records.size(), 0);
+
+    // compress
+    const size_t chunk = 16;
+    size_t chunks_count = (records.size() + chunk - 1) / chunk;
+    std::atomic<size_t> next(0);
+    detail::run_workers(detail::workers_count(threads, chunks_count), [&](const std::atomic<bool>& failed) {
+        for (;;) {
+            size_t ch = next.fetch_add(1);
+            if (ch >= chunks_count || failed.load()) break;
+            size_t end = std::min((ch + 1) * chunk, records.size());
+            for (size_t i = ch * chunk; i < end; i++) {
+                auto slot = sl::io::span<char>(&data[0] + offsets[i], offsets[i + 1] - offsets[i]);
+                lengths[i] = detail::batch_compress_into(codec, records[i], slot, compression_level);
+            }
+        }
+    });
+
+    // compact, records are only moved to the left
+    size_t pos = 0;
+    for (size_t i = 0; i < records.size(); i++) {
+        if (pos != offsets[i]) {
+            std::memmove(&data[0] + pos, data.data() + offsets[i], lengths[i]);
+        }
+        offsets[i] = pos;
+        pos += lengths[i];
+    }
+    offsets.back() = pos;
+    data.resize(pos);
+    bool shrink = data.capacity() - pos > pos / 8;
+    auto res = compressed_batch(std::move(data), std::move(offsets));
+    if (shrink) {
+        res.shrink_to_fit();
+    }
+    return res;
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_COMPRESS_BATCH_HPP */
+
@@ -0,0 +1,341 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   compressed_buffer.hpp
+ * Author: alex
+ *
+ * Created on October 27, 2026, 10:20 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_COMPRESSED_BUFFER_HPP
+#define STATICLIB_COMPRESS_COMPRESSED_BUFFER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <ios>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_batch.hpp"
+#include "staticlib/compress/compress_exception.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * In-memory buffer that keeps appended data compressed in fixed-size blocks.
+ * Compressed blocks are stored one after another in a single buffer with
+ * the table of their offsets, the last incomplete block is kept uncompressed.
+ * Random reads decompress only the blocks they touch, recently decompressed
+ * blocks are kept in a small LRU cache. Can be used as a Sink.
+ * Is not thread-safe, reads modify the cache.
+ */
+class compressed_buffer {
+    /**
+     * Decompressed block
+     */
+    class cached_block {
+    public:
+        size_t idx = 0;
+        uint64_t last_used = 0;
+        std::string data;
+    };
+
+    batch_codec codec;
+    size_t block_size;
+    int compression_level;
+    size_t cache_size;
+
+    std::string data;
+    std::vector<size_t> offsets;
+    std::string tail;
+    std::string scratch;
+
+    std::vector<cached_block> cache;
+    uint64_t clock = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param codec compression algorithm
+     * @param block_size size of uncompressed blocks, that are compressed independently
+     * @param compression_level compression level
+     * @param cache_size max number of decompressed blocks to keep
+     */
+    compressed_buffer(batch_codec codec = batch_codec::deflate, size_t block_size = 1 << 16,
+            int compression_level = 6, size_t cache_size = 4) :
+    codec(codec),
+    block_size(block_size),
+    compression_level(compression_level),
+    cache_size(cache_size) {
+        if (0 == block_size) throw compress_exception(TRACEMSG(
+                "Invalid zero block size"));
+        offsets.push_back(0);
+        tail.reserve(block_size);
+    }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    compressed_buffer(const compressed_buffer&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    compressed_buffer& operator=(const compressed_buffer&) = delete;
+
+    /**
+     * Move constructor
+     *
+     * @param other other instance
+     */
+    compressed_buffer(compressed_buffer&& other) :
+    codec(other.codec),
+    block_size(other.block_size),
+    compression_level(other.compression_level),
+    cache_size(other.cache_size),
+    data(std::move(other.data)),
+    offsets(std::move(other.offsets)),
+    tail(std::move(other.tail)),
+    scratch(std::move(other.scratch)),
+    cache(std::move(other.cache)),
+    clock(other.clock),
+    hits(other.hits),
+    misses(other.misses) { }
+
+    /**
+     * Move assignment operator
+     *
+     * @param other other instance
+     * @return this instance
+     */
+    compressed_buffer& operator=(compressed_buffer&& other) {
+        codec = other.codec;
+        block_size = other.block_size;
+        compression_level = other.compression_level;
+        cache_size = other.cache_size;
+        data = std::move(other.data);
+        offsets = std::move(other.offsets);
+        tail = std::move(other.tail);
+        scratch = std::move(other.scratch);
+        cache = std::move(other.cache);
+        clock = other.clock;
+        hits = other.hits;
+        misses = other.misses;
+        return *this;
+    }
+
+    /**
+     * Appends data to the end of the buffer, every
+     * completed block is compressed immediately
+     *
+     * @param span data to append
+     */
+    void append(sl::io::span<const char> span) {
+        size_t pos = 0;
+        while (pos < span.size()) {
+            size_t len = std::min(span.size() - pos, block_size - tail.length());
+            tail.append(span.data() + pos, len);
+            pos += len;
+            if (tail.length() == block_size) {
+                compress_tail();
+            }
+        }
+    }
+
+    /**
+     * Write implementation, appends data to the end of the buffer
+     *
+     * @param span source span
+     * @return number of bytes processed (read from source span)
+     */
+    std::streamsize write(sl::io::span<const char> span) {
+        append(span);
+        return span.size_signed();
+    }
+
+    /**
+     * No-op flush implementation, incomplete last block
+     * is kept uncompressed until it is filled
+     *
+     * @return zero
+     */
+    std::streamsize flush() {
+        return 0;
+    }
+
+    /**
+     * Reads data starting from the specified offset, blocks
+     * that are not in cache are decompressed
+     *
+     * @param offset offset in uncompressed data
+     * @param span output span
+     * @return number of bytes written into span, less than span size
+     *         only if the end of data is reached
+     */
+    size_t read(uint64_t offset, sl::io::span<char> span) {
+        if (offset > size()) throw compress_exception(TRACEMSG(
+                "Invalid read offset: [" + sl::support::to_string(offset) + "]," +
+                " size: [" + sl::support::to_string(size()) + "]"));
+        size_t written = 0;
+        uint64_t compressed_end = static_cast<uint64_t>(blocks_count()) * block_size;
+        while (written < span.size() && offset < size()) {
+            const char* src = nullptr;
+            size_t avail = 0;
+            if (offset < compressed_end) {
+                size_t idx = static_cast<size_t>(offset / block_size);
+                size_t block_offset = static_cast<size_t>(offset % block_size);
+                const std::string& block = get_block(idx);
+                src = block.data() + block_offset;
+                avail = block.length() - block_offset;
+            } else {
+                size_t tail_offset = static_cast<size_t>(offset - compressed_end);
+                src = tail.data() + tail_offset;
+                avail = tail.length() - tail_offset;
+            }
+            size_t len = std::min(avail, span.size() - written);
+            std::memcpy(span.data() + written, src, len);
+            written += len;
+            offset += len;
+        }
+        return written;
+    }
+
+    /**
+     * Uncompressed size accessor
+     *
+     * @return number of bytes appended to buffer
+     */
+    uint64_t size() const {
+        return static_cast<uint64_t>(blocks_count()) * block_size + tail.length();
+    }
+
+    /**
+     * Memory used for data, without cache
+     *
+     * @return size of compressed blocks, offsets table and uncompressed last block
+     */
+    size_t compressed_size() const {
+        return data.length() + offsets.size() * sizeof(size_t) + tail.length();
+    }
+
+    /**
+     * Number of compressed blocks
+     *
+     * @return number of compressed blocks
+     */
+    size_t blocks_count() const {
+        return offsets.size() - 1;
+    }
+
+    /**
+     * Cache hits counter accessor
+     *
+     * @return number of block lookups served from cache
+     */
+    uint64_t get_cache_hits() const {
+        return hits;
+    }
+
+    /**
+     * Cache misses counter accessor
+     *
+     * @return number of block lookups that required decompression
+     */
+    uint64_t get_cache_misses() const {
+        return misses;
+    }
+
+    /**
+     * Releases the spare capacity of the compressed data buffer,
+     * that is left after its growth, and drops the cache
+     */
+    void shrink_to_fit() {
+        data.shrink_to_fit();
+        offsets.shrink_to_fit();
+        scratch = std::string();
+        cache.clear();
+        cache.shrink_to_fit();
+    }
+
+private:
+    void compress_tail() {
+        size_t bound = detail::batch_bound(codec, tail.length(), compression_level);
+        if (scratch.length() < bound) {
+            scratch.resize(bound);
+        }
+        size_t len = detail::batch_compress_into(codec, {tail.data(), tail.length()},
+                {&scratch.front(), scratch.length()}, compression_level);
+        data.append(scratch.data(), len);
+        offsets.push_back(data.length());
+        tail.clear();
+    }
+
+    const std::string& get_block(size_t idx) {
+        clock += 1;
+        for (cached_block& cb : cache) {
+            if (idx == cb.idx) {
+                hits += 1;
+                cb.last_used = clock;
+                return cb.data;
+            }
+        }
+        misses += 1;
+        cached_block* dest = nullptr;
+        if (cache.size() < std::max(cache_size, static_cast<size_t>(1))) {
+            cache.emplace_back();
+            dest = std::addressof(cache.back());
+            dest->data.resize(block_size);
+        } else {
+            dest = std::addressof(*std::min_element(cache.begin(), cache.end(),
+                    [](const cached_block& a, const cached_block& b) {
+                        return a.last_used < b.last_used;
+                    }));
+        }
+        // mark as empty in case decompression fails
+        dest->idx = SIZE_MAX;
+        auto compressed = sl::io::span<const char>(data.data() + offsets[idx], offsets[idx + 1] - offsets[idx]);
+        size_t len = detail::batch_decompress_into(codec, compressed, {&dest->data.front(), dest->data.length()});
+        if (block_size != len) throw compress_exception(TRACEMSG(
+                "Invalid decompressed block size: [" + sl::support::to_string(len) + "]," +
+                " block: [" + sl::support::to_string(idx) + "]"));
+        dest->idx = idx;
+        dest->last_used = clock;
+        return dest->data;
+    }
+
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_COMPRESSED_BUFFER_HPP */
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   decode_result.hpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 10:10 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_DECODE_RESULT_HPP
+#define STATICLIB_COMPRESS_DECODE_RESULT_HPP
+
+#include <cstddef>
+#include <array>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * State of a push-based decoder after the call
+ */
+enum class decode_status {
+    /**
+     * All input was consumed, more input is required
+     */
+    need_input,
+    /**
+     * Output buffer is full, call again to get more output
+     */
+    output_full,
+    /**
+     * End of compressed stream reached, input after it is not consumed
+     */
+    done
+};
+
+/**
+ * Result of a single call to push-based decoder
+ */
+class decode_result {
+    size_t consumed;
+    size_t produced;
+    decode_status status;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param consumed number of input bytes consumed
+     * @param produced number of output bytes produced
+     * @param status decoder state after the call
+     */
+    decode_result(size_t consumed, size_t produced, decode_status status) :
+    consumed(consumed),
+    produced(produced),
+    status(status) { }
+
+    /**
+     * Consumed bytes accessor
+     *
+     * @return number of input bytes consumed
+     */
+    size_t get_consumed() const {
+        return consumed;
+    }
+
+    /**
+     * Produced bytes accessor
+     *
+     * @return number of output bytes produced
+     */
+    size_t get_produced() const {
+        return produced;
+    }
+
+    /**
+     * Status accessor
+     *
+     * @return decoder state after the call
+     */
+    decode_status get_status() const {
+        return status;
+    }
+
+    /**
+     * Checks whether the end of compressed stream was reached
+     *
+     * @return true if stream is finished
+     */
+    bool is_done() const {
+        return decode_status::done == status;
+    }
+
+};
+
+namespace detail {
+
+/**
+ * Decodes all the specified input with the specified push-based decoder
+ * through a stack buffer, passes every decoded chunk to "emit" callback
+ */
+template <typename Decoder, typename Emit>
+decode_result feed_decoder(Decoder& decoder, sl::io::span<const char> input, Emit& emit) {
+    std::array<char, 4096> buf;
+    size_t consumed = 0;
+    size_t produced = 0;
+    for (;;) {
+        auto res = decoder.decode({input.data() + consumed, input.size() - consumed}, {buf.data(), buf.size()});
+        consumed += res.get_consumed();
+        produced += res.get_produced();
+        if (res.get_produced() > 0) {
+            emit(sl::io::span<const char>(buf.data(), res.get_produced()));
+        }
+        if (decode_status::output_full != res.get_status()) {
+            return decode_result(consumed, produced, res.get_status());
+        }
+    }
+}
+
+} // namespace
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_DECODE_RESULT_HPP */
+
@@ -0,0 +1,380 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   deflate_buffer.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 10:05 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_DEFLATE_BUFFER_HPP
+#define STATICLIB_COMPRESS_DEFLATE_BUFFER_HPP
+
+#include <cstring>
+#include <array>
+#include <memory>
+#include <string>
+
+#ifdef STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+#include "libdeflate.h"
+#endif // STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/thread_local_contexts.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+/**
+ * Reusable Deflate compression state,
+ * is kept per-thread to avoid allocations on every call
+ */
+class deflate_context {
+    detail::zlib_stream strm;
+    int level;
+
+public:
+    deflate_context() :
+    level(Z_DEFAULT_COMPRESSION) {
+        std::memset(std::addressof(strm), 0, sizeof (detail::zlib_stream));
+        auto err = detail::zlib_deflate_init2(std::addressof(strm), level, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        if (Z_OK != err) throw compress_exception(TRACEMSG(
+                "Error initializing deflate stream: [" + detail::zlib_error(err) + "]"));
+    }
+
+    ~deflate_context() STATICLIB_NOEXCEPT {
+        detail::zlib_deflate_end(std::addressof(strm));
+    }
+
+    deflate_context(const deflate_context&) = delete;
+
+    deflate_context& operator=(const deflate_context&) = delete;
+
+    detail::zlib_stream* reset(int compression_level) {
+        auto err = detail::zlib_deflate_reset(std::addressof(strm));
+        if (Z_OK == err && compression_level != level) {
+            // no data was written yet, so no output is produced
+            err = detail::zlib_deflate_params(std::addressof(strm), compression_level, Z_DEFAULT_STRATEGY);
+            level = compression_level;
+        }
+        if (Z_OK != err) throw compress_exception(TRACEMSG(
+                "Error resetting deflate stream: [" + detail::zlib_error(err) + "]"));
+        return std::addressof(strm);
+    }
+
+};
+
+/**
+ * Reusable Deflate decompression state
+ */
+class inflate_context {
+    detail::zlib_stream strm;
+
+public:
+    inflate_context() {
+        std::memset(std::addressof(strm), 0, sizeof (detail::zlib_stream));
+        auto err = detail::zlib_inflate_init2(std::addressof(strm), -MAX_WBITS);
+        if (Z_OK != err) throw compress_exception(TRACEMSG(
+                "Error initializing inflate stream: [" + detail::zlib_error(err) + "]"));
+    }
+
+    ~inflate_context() STATICLIB_NOEXCEPT {
+        detail::zlib_inflate_end(std::addressof(strm));
+    }
+
+    inflate_context(const inflate_context&) = delete;
+
+    inflate_context& operator=(const inflate_context&) = delete;
+
+    detail::zlib_stream* reset() {
+        auto err = detail::zlib_inflate_reset(std::addressof(strm));
+        if (Z_OK != err) throw compress_exception(TRACEMSG(
+                "Error resetting inflate stream: [" + detail::zlib_error(err) + "]"));
+        return std::addressof(strm);
+    }
+
+};
+
+#ifdef STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+
+/**
+ * Reusable libdeflate state, compressors are allocated
+ * lazily for each compression level that is used
+ */
+class libdeflate_context {
+    static const size_t levels_count = 13;
+
+    std::array<libdeflate_compressor*, levels_count> compressors;
+    libdeflate_decompressor* decompressor = nullptr;
+
+public:
+    libdeflate_context() {
+        compressors.fill(nullptr);
+    }
+
+    ~libdeflate_context() STATICLIB_NOEXCEPT {
+        for (libdeflate_compressor* co : compressors) {
+            if (nullptr != co) {
+                ::libdeflate_free_compressor(co);
+            }
+        }
+        if (nullptr != decompressor) {
+            ::libdeflate_free_decompressor(decompressor);
+        }
+    }
+
+    libdeflate_context(const libdeflate_context&) = delete;
+
+    libdeflate_context& operator=(const libdeflate_context&) = delete;
+
+    libdeflate_compressor* compressor(int compression_level) {
+        size_t idx = level_index(compression_level);
+        if (nullptr == compressors[idx]) {
+            compressors[idx] = ::libdeflate_alloc_compressor(static_cast<int>(idx));
+            if (nullptr == compressors[idx]) throw compress_exception(TRACEMSG(
+                    "Error creating libdeflate compressor, level: [" + sl::support::to_string(idx) + "]"));
+        }
+        return compressors[idx];
+    }
+
+    static size_t level_index(int compression_level) {
+        // zlib levels 0-9 have the same meaning in libdeflate
+        size_t idx = Z_DEFAULT_COMPRESSION == compression_level ? 6 : static_cast<size_t>(compression_level);
+        if (compression_level < Z_DEFAULT_COMPRESSION || idx >= levels_count) throw compress_exception(TRACEMSG(
+                "Invalid compression level: [" + sl::support::to_string(compression_level) + "]"));
+        return idx;
+    }
+
+    libdeflate_decompressor* get_decompressor() {
+        if (nullptr == decompressor) {
+            decompressor = ::libdeflate_alloc_decompressor();
+            if (nullptr == decompressor) throw compress_exception(TRACEMSG(
+                    "Error creating libdeflate decompressor"));
+        }
+        return decompressor;
+    }
+
+};
+
+inline libdeflate_context& local_libdeflate_context() {
+#ifdef STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS
+    static thread_local libdeflate_context ctx;
+    return ctx;
+#else
+    static __declspec(thread) libdeflate_context* ctx = nullptr;
+    if (nullptr == ctx) {
+        ctx = new libdeflate_context();
+    }
+    return *ctx;
+#endif // STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS
+}
+
+#else // zlib
+
+inline detail::zlib_stream* local_deflate_stream(int compression_level) {
+#ifdef STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS
+    static thread_local deflate_context ctx;
+    return ctx.reset(compression_level);
+#else
+    // fallback: one context per thread is leaked on exit
+    static __declspec(thread) deflate_context* ctx = nullptr;
+    if (nullptr == ctx) {
+        ctx = new deflate_context();
+    }
+    return ctx->reset(compression_level);
+#endif // STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS
+}
+
+inline detail::zlib_stream* local_inflate_stream() {
+#ifdef STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS
+    static thread_local inflate_context ctx;
+    return ctx.reset();
+#else
+    static __declspec(thread) inflate_context* ctx = nullptr;
+    if (nullptr == ctx) {
+        ctx = new inflate_context();
+    }
+    return ctx->reset();
+#endif // STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS
+}
+
+#endif // STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+
+} // namespace
+
+/**
+ * Returns the upper bound of the compressed size for the data
+ * of the specified length
+ *
+ * @param len length of uncompressed data
+ * @param compression_level Deflate compression level
+ * @return maximum compressed size
+ */
+inline size_t deflate_bound(size_t len, int compression_level = 6) {
+#ifdef STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+    // bound that is valid for any level does not require a compressor,
+    // compressors for high levels take hundreds of KB
+    detail::libdeflate_context::level_index(compression_level);
+    return ::libdeflate_deflate_compress_bound(nullptr, len);
+#else
+    detail::zlib_stream* strm = detail::local_deflate_stream(compression_level);
+    return static_cast<size_t>(detail::zlib_deflate_bound(strm, len));
+#endif // STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+}
+
+/**
+ * Compresses in-memory data into the specified output buffer using
+ * Deflate algorithm, data is compressed with a single call to zlib
+ * using a thread-local compression state;
+ * output is the same as the one produced by "deflate_sink".
+ * When built with libdeflate, it is used instead of zlib, output
+ * is then valid raw Deflate, but differs from "deflate_sink" one
+ *
+ * @param data data to compress
+ * @param out output buffer, "deflate_bound()" bytes are always enough
+ * @param compression_level Deflate compression level
+ * @return number of bytes written into output buffer
+ * @throws compress_exception if output buffer is too small
+ */
+inline size_t deflate_into(sl::io::span<const char> data, sl::io::span<char> out, int compression_level = 6) {
+#ifdef STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+    auto co = detail::local_libdeflate_context().compressor(compression_level);
+    size_t len = ::libdeflate_deflate_compress(co, data.data(), data.size(), out.data(), out.size());
+    if (0 == len) throw compress_exception(TRACEMSG(
+            "Deflate error: [insufficient space], output buffer size: [" + sl::support::to_string(out.size()) + "]"));
+    return len;
+#else
+    detail::zlib_stream* strm = detail::local_deflate_stream(compression_level);
+    strm->next_in = reinterpret_cast<const unsigned char*> (data.data());
+    strm->avail_in = static_cast<detail::zlib_uint> (data.size());
+    strm->next_out = reinterpret_cast<unsigned char*> (out.data());
+    strm->avail_out = static_cast<detail::zlib_uint> (out.size());
+    auto err = detail::zlib_deflate(strm, Z_FINISH);
+    if (Z_STREAM_END != err) throw compress_exception(TRACEMSG(
+            "Deflate error: [" + detail::zlib_error(err) + "], output buffer size: [" + sl::support::to_string(out.size()) + "]"));
+    return static_cast<size_t>(strm->total_out);
+#endif // STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+}
+
+/**
+ * Compresses in-memory data using Deflate algorithm,
+ * output buffer is allocated once using the "deflate_bound()" size
+ *
+ * @param data data to compress
+ * @param compression_level Deflate compression level
+ * @return compressed data
+ */
+inline std::string deflate_buffer(sl::io::span<const char> data, int compression_level = 6) {
+    auto res = std::string();
+    res.resize(deflate_bound(data.size(), compression_level));
+    size_t len = deflate_into(data, {&res.front(), res.length()}, compression_level);
+    res.resize(len);
+    return res;
+}
+
+/**
+ * Decompresses in-memory Deflate data into the specified output buffer,
+ * data is decompressed with a single call to zlib using a thread-local
+ * decompression state
+ *
+ * @param data compressed data
+ * @param out output buffer
+ * @return number of bytes written into output buffer
+ * @throws compress_exception if output buffer is too small or data is invalid
+ */
+inline size_t inflate_into(sl::io::span<const char> data, sl::io::span<char> out) {
+#ifdef STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+    auto dec = detail::local_libdeflate_context().get_decompressor();
+    size_t len = 0;
+    auto err = ::libdeflate_deflate_decompress(dec, data.data(), data.size(), out.data(), out.size(), std::addressof(len));
+    if (LIBDEFLATE_SUCCESS != err) throw compress_exception(TRACEMSG(
+            "Inflate error, code: [" + sl::support::to_string(static_cast<int>(err)) + "]," +
+            " output buffer size: [" + sl::support::to_string(out.size()) + "]"));
+    return len;
+#else
+    detail::zlib_stream* strm = detail::local_inflate_stream();
+    strm->next_in = reinterpret_cast<const unsigned char*> (data.data());
+    strm->avail_in = static_cast<detail::zlib_uint> (data.size());
+    strm->next_out = reinterpret_cast<unsigned char*> (out.data());
+    strm->avail_out = static_cast<detail::zlib_uint> (out.size());
+    auto err = detail::zlib_inflate(strm, Z_FINISH);
+    if (Z_STREAM_END != err) throw compress_exception(TRACEMSG(
+            "Inflate error: [" + detail::zlib_error(err) + "], output buffer size: [" + sl::support::to_string(out.size()) + "]"));
+    return static_cast<size_t>(strm->total_out);
+#endif // STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+}
+
+/**
+ * Decompresses in-memory Deflate data, if uncompressed size is known
+ * it is used to allocate the output buffer exactly once, otherwise
+ * output buffer is grown as needed
+ *
+ * @param data compressed data
+ * @param uncompressed_size size of decompressed data, zero if unknown
+ * @return decompressed data
+ */
+inline std::string inflate_buffer(sl::io::span<const char> data, size_t uncompressed_size = 0) {
+    auto res = std::string();
+    res.resize(uncompressed_size > 0 ? uncompressed_size : data.size() * 4 + 64);
+#ifdef STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+    auto dec = detail::local_libdeflate_context().get_decompressor();
+    for (;;) {
+        size_t len = 0;
+        auto err = ::libdeflate_deflate_decompress(dec, data.data(), data.size(),
+                &res.front(), res.length(), std::addressof(len));
+        if (LIBDEFLATE_SUCCESS == err) {
+            res.resize(len);
+            break;
+        }
+        if (LIBDEFLATE_INSUFFICIENT_SPACE == err) {
+            res.resize(res.length() * 2);
+        } else throw compress_exception(TRACEMSG(
+                "Inflate error, code: [" + sl::support::to_string(static_cast<int>(err)) + "]," +
+                " input size: [" + sl::support::to_string(data.size()) + "]"));
+    }
+#else
+    detail::zlib_stream* strm = detail::local_inflate_stream();
+    strm->next_in = reinterpret_cast<const unsigned char*> (data.data());
+    strm->avail_in = static_cast<detail::zlib_uint> (data.size());
+    for (;;) {
+        strm->next_out = reinterpret_cast<unsigned char*> (&res.front() + strm->total_out);
+        strm->avail_out = static_cast<detail::zlib_uint> (res.length() - strm->total_out);
+        auto err = detail::zlib_inflate(strm, Z_FINISH);
+        if (Z_STREAM_END == err) break;
+        if ((Z_OK == err || Z_BUF_ERROR == err) && 0 == strm->avail_out) {
+            res.resize(res.length() * 2);
+        } else throw compress_exception(TRACEMSG(
+                "Inflate error: [" + detail::zlib_error(err) + "]," +
+                " input bytes left: [" + sl::support::to_string(strm->avail_in) + "]"));
+    }
+    res.resize(static_cast<size_t>(strm->total_out));
+#endif // STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+    return res;
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_DEFLATE_BUFFER_HPP */
+
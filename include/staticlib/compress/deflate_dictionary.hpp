@@ -0,0 +1,254 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   deflate_dictionary.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 3:20 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_DEFLATE_DICTIONARY_HPP
+#define STATICLIB_COMPRESS_DEFLATE_DICTIONARY_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Preset dictionary for Deflate streams, the same dictionary must be used
+ * for compression and decompression. Raw Deflate streams do not carry
+ * dictionary identifiers, so ID is expected to be transferred along with the data.
+ */
+class deflate_dictionary {
+    uint32_t id;
+    std::string data;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param id dictionary identifier (version)
+     * @param data dictionary contents, only last 32KB are used by Deflate
+     */
+    deflate_dictionary(uint32_t id, std::string data) :
+    id(id),
+    data(std::move(data)) { }
+
+    /**
+     * Identifier accessor
+     *
+     * @return dictionary identifier
+     */
+    uint32_t get_id() const {
+        return id;
+    }
+
+    /**
+     * Contents accessor
+     *
+     * @return dictionary contents
+     */
+    const std::string& get_data() const {
+        return data;
+    }
+
+};
+
+/**
+ * Thread-safe registry of versioned dictionaries, that allows
+ * to share dictionaries between all the streams in process
+ */
+class dictionary_registry {
+    std::mutex mutex;
+    std::map<uint32_t, std::shared_ptr<const deflate_dictionary>> dictionaries;
+
+public:
+    /**
+     * Adds specified dictionary to registry,
+     * dictionary with the same ID is replaced
+     *
+     * @param dict dictionary to add
+     * @return shared pointer to registered dictionary
+     */
+    std::shared_ptr<const deflate_dictionary> put(deflate_dictionary dict) {
+        auto ptr = std::make_shared<const deflate_dictionary>(std::move(dict));
+        std::lock_guard<std::mutex> guard{mutex};
+        dictionaries[ptr->get_id()] = ptr;
+        return ptr;
+    }
+
+    /**
+     * Finds dictionary with the specified ID
+     *
+     * @param id dictionary identifier
+     * @return shared pointer to dictionary
+     * @throws compress_exception if dictionary not found
+     */
+    std::shared_ptr<const deflate_dictionary> get(uint32_t id) {
+        std::lock_guard<std::mutex> guard{mutex};
+        auto it = dictionaries.find(id);
+        if (dictionaries.end() == it) throw compress_exception(TRACEMSG(
+                "Dictionary not found, ID: [" + sl::support::to_string(id) + "]"));
+        return it->second;
+    }
+
+    /**
+     * Removes dictionary with the specified ID, streams
+     * that already use it are not affected
+     *
+     * @param id dictionary identifier
+     * @return true if dictionary was removed
+     */
+    bool remove(uint32_t id) {
+        std::lock_guard<std::mutex> guard{mutex};
+        return dictionaries.erase(id) > 0;
+    }
+
+};
+
+/**
+ * Process-wide dictionary registry
+ *
+ * @return registry instance
+ */
+inline dictionary_registry& global_dictionary_registry() {
+    static dictionary_registry registry;
+    return registry;
+}
+
+/**
+ * Builds a dictionary from the sample corpus. Samples are scanned for
+ * the byte sequences that are shared by the most samples, best segments
+ * are selected greedily and placed closer to the end of dictionary,
+ * where Deflate can reference them with the shortest distances.
+ *
+ * @param samples sample messages, that are similar to the ones being compressed
+ * @param dict_size maximum dictionary size, Deflate window is 32KB
+ * @param segment_size length of the segments copied into dictionary
+ * @return dictionary contents
+ */
+inline std::string train_deflate_dictionary(const std::vector<std::string>& samples,
+        size_t dict_size = 32768, size_t segment_size = 64) {
+    // count number of samples that contain each 8-byte sequence
+    const size_t dmer = 8;
+    const size_t table_bits = 20;
+    auto hash = [](const char* ptr) -> size_t {
+        uint64_t val = 0;
+        std::memcpy(std::addressof(val), ptr, sizeof(val));
+        return static_cast<size_t>((val * 0x9E3779B97F4A7C15ULL) >> (64 - table_bits));
+    };
+    auto freqs = std::vector<uint32_t>(static_cast<size_t>(1) << table_bits, 0);
+    auto last_seen = std::vector<uint32_t>(freqs.size(), 0);
+    for (size_t i = 0; i < samples.size(); i++) {
+        const std::string& sa = samples[i];
+        for (size_t j = 0; j + dmer <= sa.length(); j++) {
+            size_t ha = hash(sa.data() + j);
+            if (last_seen[ha] != i + 1) {
+                last_seen[ha] = static_cast<uint32_t>(i + 1);
+                freqs[ha] += 1;
+            }
+        }
+    }
+
+    // pick the best segment from each epoch of the corpus
+    segment_size = std::max(segment_size, dmer);
+    size_t total = 0;
+    for (const std::string& sa : samples) {
+        total += sa.length();
+    }
+    size_t epochs = std::max(dict_size / segment_size, static_cast<size_t>(1));
+    size_t epoch_size = std::max(total / epochs, segment_size);
+    auto segments = std::vector<std::pair<uint64_t, std::string>>();
+    size_t epoch_start = 0;
+    size_t offset = 0;
+    uint64_t best_score = 0;
+    auto best = std::string();
+    auto finish_epoch = [&] {
+        if (best_score > 0) {
+            // selected sequences are not counted twice
+            for (size_t j = 0; j + dmer <= best.length(); j++) {
+                freqs[hash(best.data() + j)] = 0;
+            }
+            segments.emplace_back(best_score, std::move(best));
+        }
+        best_score = 0;
+        best = std::string();
+    };
+    for (const std::string& sa : samples) {
+        if (sa.length() >= segment_size) {
+            for (size_t j = 0; j + segment_size <= sa.length(); j += dmer) {
+                if (offset + j >= epoch_start + epoch_size) {
+                    finish_epoch();
+                    epoch_start = offset + j;
+                }
+                uint64_t score = 0;
+                for (size_t k = j; k + dmer <= j + segment_size; k++) {
+                    uint32_t fr = freqs[hash(sa.data() + k)];
+                    // sequence that occurs in a single sample is useless
+                    score += fr > 1 ? fr : 0;
+                }
+                if (score > best_score) {
+                    best_score = score;
+                    best = sa.substr(j, segment_size);
+                }
+            }
+        }
+        offset += sa.length();
+    }
+    finish_epoch();
+
+    // the most valuable segments go last
+    std::stable_sort(segments.begin(), segments.end(),
+            [](const std::pair<uint64_t, std::string>& a, const std::pair<uint64_t, std::string>& b) {
+        return a.first < b.first;
+    });
+    size_t skip = 0;
+    size_t len = 0;
+    for (auto& pa : segments) {
+        len += pa.second.length();
+    }
+    while (len > dict_size && skip < segments.size()) {
+        len -= segments[skip].second.length();
+        skip += 1;
+    }
+    auto res = std::string();
+    res.reserve(len);
+    for (size_t i = skip; i < segments.size(); i++) {
+        res.append(segments[i].second);
+    }
+    return res;
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_DEFLATE_DICTIONARY_HPP */
+
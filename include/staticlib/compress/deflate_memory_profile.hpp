@@ -0,0 +1,122 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   deflate_memory_profile.hpp
+ * Author: alex
+ *
+ * Created on October 24, 2026, 11:20 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_DEFLATE_MEMORY_PROFILE_HPP
+#define STATICLIB_COMPRESS_DEFLATE_MEMORY_PROFILE_HPP
+
+#include <cstddef>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Memory settings of a Deflate compressing stream. Window size and
+ * memory level define the size of the zlib state (about 256KB with
+ * defaults), without context takeover the state is released after
+ * each message, so idle streams do not hold it at all - the same
+ * trade-off "permessage-deflate" WebSocket extension makes.
+ */
+class deflate_memory_profile {
+    int window_bits;
+    int mem_level;
+    bool context_takeover;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param window_bits base two logarithm of the window size, 9-15
+     * @param mem_level memory used for the internal compression state, 1-9
+     * @param context_takeover whether compression state is kept between messages
+     */
+    deflate_memory_profile(int window_bits = MAX_WBITS, int mem_level = 8, bool context_takeover = true) :
+    window_bits(window_bits),
+    mem_level(mem_level),
+    context_takeover(context_takeover) {
+        if (window_bits < 9 || window_bits > MAX_WBITS) throw compress_exception(TRACEMSG(
+                "Invalid window bits: [" + sl::support::to_string(window_bits) + "]"));
+        if (mem_level < 1 || mem_level > 9) throw compress_exception(TRACEMSG(
+                "Invalid memory level: [" + sl::support::to_string(mem_level) + "]"));
+    }
+
+    /**
+     * Profile for large number of concurrent streams: 1KB window,
+     * small hash tables and no context takeover, takes about 11KB
+     * of zlib state while a message is being compressed
+     *
+     * @return low-memory profile
+     */
+    static deflate_memory_profile low_memory() {
+        return deflate_memory_profile(10, 1, false);
+    }
+
+    /**
+     * Window bits accessor
+     *
+     * @return base two logarithm of the window size
+     */
+    int get_window_bits() const {
+        return window_bits;
+    }
+
+    /**
+     * Memory level accessor
+     *
+     * @return memory level
+     */
+    int get_mem_level() const {
+        return mem_level;
+    }
+
+    /**
+     * Context takeover accessor
+     *
+     * @return whether compression state is kept between messages
+     */
+    bool is_context_takeover() const {
+        return context_takeover;
+    }
+
+    /**
+     * Estimates the size of zlib compression state using
+     * the formula from "zconf.h"
+     *
+     * @return approximate number of bytes allocated by zlib
+     */
+    size_t state_size() const {
+        return (static_cast<size_t>(1) << (window_bits + 2)) +
+                (static_cast<size_t>(1) << (mem_level + 9)) + (6 << 10);
+    }
+
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_DEFLATE_MEMORY_PROFILE_HPP */
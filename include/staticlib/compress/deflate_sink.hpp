@@ -24,25 +24,44 @@
 #ifndef STATICLIB_COMPRESS_DEFLATE_SINK_HPP
 #define STATICLIB_COMPRESS_DEFLATE_SINK_HPP
 
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <chrono>
 #include <ios>
 #include <memory>
+#include <string>
 #include <type_traits>
 
-#include "zlib.h"
-
 #include "staticlib/config.hpp"
 #include "staticlib/io.hpp"
 #include "staticlib/support.hpp"
 
+#include "staticlib/compress/adaptive_level.hpp"
 #include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/deflate_dictionary.hpp"
+#include "staticlib/compress/deflate_memory_profile.hpp"
+#include "staticlib/compress/deflate_stream.hpp"
+#include "staticlib/compress/rsyncable_chunker.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
 
 namespace staticlib {
 namespace compress {
 
+namespace detail {
+
+/**
+ * Final fixed-Huffman block without any data, completes
+ * a raw Deflate stream that ends on a byte boundary
+ */
+const char deflate_empty_final_block[] = {0x03, 0x00};
+
+} // namespace
+
 /**
- * Sink wrapper that compressed written data using Deflate algorithm
+ * Sink wrapper that compressed written data using Deflate algorithm;
+ * zlib state is allocated on the first write, so sinks that never
+ * receive any data do not hold it
  */
 template <typename Sink, int compression_level = 6, std::size_t buf_size = 4096>
 class deflate_sink {
@@ -55,9 +74,33 @@ class deflate_sink {
      */
     std::array<char, buf_size> buf;
     /**
-     * Zlib compressing stream
+     * Zlib compressing stream, is created lazily
+     */
+    detail::zlib_stream* strm = nullptr;
+    /**
+     * Window and memory settings of the stream
+     */
+    deflate_memory_profile memory;
+    /**
+     * Shared preset dictionary, is kept only until the stream is created
+     */
+    std::shared_ptr<const deflate_dictionary> dict;
+    /**
+     * Whether the stream end needs to be written on destruction
      */
-    z_stream* strm;
+    bool open = true;
+    /**
+     * Level controller, is not used by default
+     */
+    std::unique_ptr<adaptive_level> adaptive;
+    /**
+     * Chunker for the rsyncable output, is not used by default
+     */
+    std::unique_ptr<rsyncable_chunker> chunker;
+    /**
+     * Time spent in destination sink during current write call
+     */
+    uint64_t sink_nanos = 0;
     
 public:
     
@@ -67,54 +110,95 @@ public:
      * @param sink destination to write compressed data into
      */
     deflate_sink(Sink&& sink) :
+    sink(std::move(sink)) { }
+
+    /**
+     * Constructor with memory settings, use "deflate_memory_profile::low_memory()"
+     * together with small "buf_size" for large numbers of concurrent streams
+     * 
+     * @param sink destination to write compressed data into
+     * @param memory window, memory level and context takeover settings
+     */
+    deflate_sink(Sink&& sink, const deflate_memory_profile& memory) :
     sink(std::move(sink)),
-    strm([] {
-        z_stream* stream = static_cast<z_stream*> (std::malloc(sizeof(z_stream)));
-        if (nullptr == stream) throw compress_exception(TRACEMSG(
-                "Error creating deflate stream: 'malloc' failed"));
-        std::memset(stream, 0, sizeof (z_stream));
-        auto err = deflateInit2(stream, compression_level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
-        if (Z_OK != err) throw compress_exception(TRACEMSG(
-                "Error initializing deflate stream: [" + ::zError(err) + "]"));
-        return stream;
-    }()) { }
+    memory(memory) { }
+
+    /**
+     * Constructor with preset dictionary, the same dictionary
+     * must be used to decompress the data; zlib state is created
+     * immediately, so the dictionary is not used after construction
+     * 
+     * @param sink destination to write compressed data into
+     * @param dict preset dictionary
+     */
+    deflate_sink(Sink&& sink, const deflate_dictionary& dict) :
+    sink(std::move(sink)) {
+        this->strm = detail::deflate_stream_create(compression_level, memory,
+                {dict.get_data().data(), dict.get_data().length()});
+    }
+
+    /**
+     * Constructor with shared preset dictionary (see "dictionary_registry"),
+     * zlib state is created on the first write, dictionary is referenced
+     * (not copied) until then
+     * 
+     * @param sink destination to write compressed data into
+     * @param dict preset dictionary
+     */
+    deflate_sink(Sink&& sink, std::shared_ptr<const deflate_dictionary> dict) :
+    sink(std::move(sink)),
+    dict(std::move(dict)) { }
+
+    /**
+     * Constructor with adaptive compression level, compression starts
+     * with "compression_level" (clamped to the controller range), then the level
+     * is changed mid-stream after each window of input data
+     * 
+     * @param sink destination to write compressed data into
+     * @param controller level controller configuration
+     */
+    deflate_sink(Sink&& sink, const adaptive_level& controller) :
+    sink(std::move(sink)) {
+        adaptive.reset(new adaptive_level(controller));
+        adaptive->reset(compression_level);
+    }
+
+    /**
+     * Constructor for "rsyncable" output, compressed data is flushed
+     * on content-defined chunk boundaries, so compressed output resynchronizes
+     * shortly after any change in input data, see "rsyncable_chunker"
+     * for the ratio cost.
+     * 
+     * @param sink destination to write compressed data into
+     * @param chunker chunker configuration
+     */
+    deflate_sink(Sink&& sink, const rsyncable_chunker& chunker) :
+    sink(std::move(sink)) {
+        this->chunker.reset(new rsyncable_chunker(chunker));
+        this->chunker->reset();
+    }
 
     ~deflate_sink() STATICLIB_NOEXCEPT {
-        if (nullptr == strm) return;
+        if (!open) return;
+        if (nullptr == strm) {
+            // stream was not created or was released after a message,
+            // data written so far ends on a byte boundary, so
+            // an empty final block completes it
+            try {
+                sl::io::write_all(sink, {detail::deflate_empty_final_block, 2});
+            } catch(...) {
+                // cannot report any error safely - we are in destructor
+            }
+            return;
+        }
         auto deferred = sl::support::defer([this]() STATICLIB_NOEXCEPT {
-            ::deflateEnd(this->strm);
-            ::free(this->strm);
+            detail::deflate_stream_destroy(this->strm);
         });
         // finish encoding
-        strm->next_in = nullptr;
-        strm->avail_in = 0;
-        strm->next_out = reinterpret_cast<unsigned char*> (buf.data());
-        strm->avail_out = static_cast<uInt> (buf.size());
-        // call deflate
-        bool deflating = true;
-        while(deflating) {
-            auto err = ::deflate(strm, Z_FINISH);
+        try {
+            flush_stream(Z_FINISH);
+        } catch(...) {
             // cannot report any error safely - we are in destructor
-            switch (err) {
-            case Z_OK:
-                if (strm->avail_out < buf.size()) {
-                    sl::io::write_all(sink, {buf.data(), buf.size() - strm->avail_out});
-                    strm->next_out = reinterpret_cast<unsigned char*> (buf.data());
-                    strm->avail_out = static_cast<uInt> (buf.size());
-                }
-                // still not finished
-                break;
-            case Z_STREAM_END:
-                if (strm->avail_out < buf.size()) {
-                    sl::io::write_all(sink, {buf.data(), buf.size() - strm->avail_out});
-                }
-                // finished
-                deflating = false;
-                break;
-            default:
-                // finish
-                deflating = false;
-            }
         }
     }
     
@@ -141,8 +225,14 @@ public:
     deflate_sink(deflate_sink&& other) :
     sink(std::move(other.sink)),
     buf(std::move(other.buf)),
-    strm(other.strm) {
+    strm(other.strm),
+    memory(other.memory),
+    dict(std::move(other.dict)),
+    open(other.open),
+    adaptive(std::move(other.adaptive)),
+    chunker(std::move(other.chunker)) {
         other.strm = nullptr;
+        other.open = false;
     }
 
     /**
@@ -156,6 +246,12 @@ public:
         buf = std::move(other.buf);
         strm = other.strm;
         other.strm = nullptr;
+        memory = other.memory;
+        dict = std::move(other.dict);
+        open = other.open;
+        other.open = false;
+        adaptive = std::move(other.adaptive);
+        chunker = std::move(other.chunker);
         return *this;
     }
 
@@ -166,26 +262,13 @@ public:
      * @return number of bytes processed (read from source span)
      */
     std::streamsize write(sl::io::span<const char> span) {
-        // prepare zlib stream
-        strm->next_in = reinterpret_cast<const unsigned char*> (span.data());
-        strm->avail_in = static_cast<uInt> (span.size());
-        strm->next_out = reinterpret_cast<unsigned char*> (buf.data());
-        strm->avail_out = static_cast<uInt> (buf.size());
-        // call deflate
-        while(strm->avail_in > 0) {
-            auto err = ::deflate(strm, Z_NO_FLUSH);
-            switch (err) {
-            case Z_OK:
-                if (strm->avail_out < buf.size()) {
-                    sl::io::write_all(sink, {buf.data(), buf.size() - strm->avail_out});
-                    strm->next_out = reinterpret_cast<unsigned char*> (buf.data());
-                    strm->avail_out = static_cast<uInt> (buf.size());
-                }
-                break;
-            default: throw compress_exception(TRACEMSG(
-                        "Deflate error: [" + ::zError(err) + "]"));
-            }
+        if (nullptr != adaptive) {
+            return write_adaptive(span);
+        }
+        if (nullptr != chunker) {
+            return write_rsyncable(span);
         }
+        deflate_span(span);
         return span.size_signed();
     }
 
@@ -200,6 +283,29 @@ public:
         return sink.flush();
     }
 
+    /**
+     * Completes current message: pending compressed data is flushed
+     * to the destination with Z_SYNC_FLUSH, so everything written so far
+     * can be decompressed by the receiver. Without context takeover
+     * zlib state is released and will be created again on the next write.
+     */
+    void end_message() {
+        if (nullptr == strm) return;
+        flush_stream(Z_SYNC_FLUSH);
+        if (!memory.is_context_takeover()) {
+            release_stream();
+        }
+    }
+
+    /**
+     * Checks whether zlib state is currently allocated
+     * 
+     * @return true if the stream holds zlib state
+     */
+    bool is_initialized() const {
+        return nullptr != strm;
+    }
+
     /**
      * Underlying sink accessor
      * 
@@ -209,6 +315,118 @@ public:
         return sink;
     }
 
+    /**
+     * Compression level accessor
+     * 
+     * @return level currently used for compression
+     */
+    int get_compression_level() const {
+        return nullptr != adaptive ? adaptive->get_level() : compression_level;
+    }
+
+private:
+    void deflate_span(sl::io::span<const char> span) {
+        if (0 == span.size()) return;
+        if (nullptr == strm) {
+            init_stream();
+        }
+        detail::deflate_stream_pump(strm, span, {buf.data(), buf.size()}, Z_NO_FLUSH,
+                [this](sl::io::span<const char> out) {
+                    this->write_buf(out.size());
+                });
+    }
+
+    void flush_stream(int mode) {
+        detail::deflate_stream_pump(strm, {nullptr, 0}, {buf.data(), buf.size()}, mode,
+                [this](sl::io::span<const char> out) {
+                    this->write_buf(out.size());
+                });
+    }
+
+    std::streamsize write_rsyncable(sl::io::span<const char> span) {
+        size_t pos = 0;
+        while (pos < span.size()) {
+            auto rest = sl::io::span<const char>(span.data() + pos, span.size() - pos);
+            size_t len = chunker->next_boundary(rest);
+            if (0 == len) {
+                deflate_span(rest);
+                break;
+            }
+            deflate_span({rest.data(), len});
+            // next chunk starts in a new byte-aligned block, with
+            // full flush it also does not reference previous data
+            flush_stream(chunker->is_full_flush() ? Z_FULL_FLUSH : Z_SYNC_FLUSH);
+            pos += len;
+        }
+        return span.size_signed();
+    }
+
+    void write_buf(size_t len) {
+        if (nullptr == adaptive) {
+            sl::io::write_all(sink, {buf.data(), len});
+        } else {
+            auto start = std::chrono::steady_clock::now();
+            sl::io::write_all(sink, {buf.data(), len});
+            sink_nanos += elapsed_nanos(start);
+        }
+    }
+
+    std::streamsize write_adaptive(sl::io::span<const char> span) {
+        auto start = std::chrono::steady_clock::now();
+        sink_nanos = 0;
+        deflate_span(span);
+        uint64_t total = elapsed_nanos(start);
+        uint64_t codec = total > sink_nanos ? total - sink_nanos : 0;
+        if (adaptive->record(span.size(), codec, sink_nanos)) {
+            int prev = adaptive->get_level();
+            int next = adaptive->adjust();
+            if (next != prev) {
+                change_level(next);
+            }
+        }
+        return span.size_signed();
+    }
+
+    void change_level(int level) {
+        // stream that is not created yet will be initialized with the new level
+        if (nullptr == strm) return;
+        // all input is consumed at this point, pending output is flushed
+        // by zlib with Z_BLOCK before switching parameters
+        for (;;) {
+            strm->next_out = reinterpret_cast<unsigned char*> (buf.data());
+            strm->avail_out = static_cast<detail::zlib_uint> (buf.size());
+            auto err = detail::zlib_deflate_params(strm, level, Z_DEFAULT_STRATEGY);
+            size_t produced = buf.size() - strm->avail_out;
+            if (produced > 0) {
+                sl::io::write_all(sink, {buf.data(), produced});
+            }
+            if (Z_OK == err) break;
+            if (Z_BUF_ERROR != err || 0 == produced) throw compress_exception(TRACEMSG(
+                    "Error changing deflate level: [" + detail::zlib_error(err) + "]," +
+                    " level: [" + sl::support::to_string(level) + "]"));
+        }
+    }
+
+    static uint64_t elapsed_nanos(std::chrono::steady_clock::time_point start) {
+        auto dur = std::chrono::steady_clock::now() - start;
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(dur).count());
+    }
+
+    void init_stream() {
+        auto dict_span = nullptr != dict.get() ?
+                sl::io::span<const char>(dict->get_data().data(), dict->get_data().length()) :
+                sl::io::span<const char>(nullptr, 0);
+        this->strm = detail::deflate_stream_create(get_compression_level(), memory, dict_span);
+        // dictionary is used only with default memory profile, that keeps
+        // the stream for the whole lifetime of the sink
+        dict.reset();
+    }
+
+    void release_stream() {
+        detail::deflate_stream_destroy(strm);
+        this->strm = nullptr;
+    }
+
 };
 
 /**
@@ -237,6 +455,147 @@ deflate_sink<sl::io::reference_sink<Sink>> make_deflate_sink(Sink& sink) {
             sl::io::make_reference_sink(sink));
 }
 
+/**
+ * Factory function for creating deflate sinks with preset dictionary,
+ * created object will own the specified sink
+ * 
+ * @param sink output sink
+ * @param dict preset dictionary
+ * @return deflate sink
+ */
+template <typename Sink,
+        class = typename std::enable_if<!std::is_lvalue_reference<Sink>::value>::type>
+deflate_sink<Sink> make_deflate_sink(Sink&& sink, const deflate_dictionary& dict) {
+    return deflate_sink<Sink>(std::move(sink), dict);
+}
+
+/**
+ * Factory function for creating deflate sinks with preset dictionary,
+ * created object will NOT own the specified sink
+ * 
+ * @param sink output sink
+ * @param dict preset dictionary
+ * @return deflate sink
+ */
+template <typename Sink>
+deflate_sink<sl::io::reference_sink<Sink>> make_deflate_sink(Sink& sink, const deflate_dictionary& dict) {
+    return deflate_sink<sl::io::reference_sink<Sink>> (
+            sl::io::make_reference_sink(sink), dict);
+}
+
+/**
+ * Factory function for creating deflate sinks with shared preset dictionary,
+ * created object will own the specified sink
+ * 
+ * @param sink output sink
+ * @param dict preset dictionary
+ * @return deflate sink
+ */
+template <typename Sink,
+        class = typename std::enable_if<!std::is_lvalue_reference<Sink>::value>::type>
+deflate_sink<Sink> make_deflate_sink(Sink&& sink, std::shared_ptr<const deflate_dictionary> dict) {
+    return deflate_sink<Sink>(std::move(sink), std::move(dict));
+}
+
+/**
+ * Factory function for creating deflate sinks with shared preset dictionary,
+ * created object will NOT own the specified sink
+ * 
+ * @param sink output sink
+ * @param dict preset dictionary
+ * @return deflate sink
+ */
+template <typename Sink>
+deflate_sink<sl::io::reference_sink<Sink>> make_deflate_sink(Sink& sink,
+        std::shared_ptr<const deflate_dictionary> dict) {
+    return deflate_sink<sl::io::reference_sink<Sink>> (
+            sl::io::make_reference_sink(sink), std::move(dict));
+}
+
+/**
+ * Factory function for creating deflate sinks with memory settings,
+ * created object will own the specified sink
+ * 
+ * @param sink output sink
+ * @param memory window, memory level and context takeover settings
+ * @return deflate sink
+ */
+template <typename Sink,
+        class = typename std::enable_if<!std::is_lvalue_reference<Sink>::value>::type>
+deflate_sink<Sink> make_deflate_sink(Sink&& sink, const deflate_memory_profile& memory) {
+    return deflate_sink<Sink>(std::move(sink), memory);
+}
+
+/**
+ * Factory function for creating deflate sinks with memory settings,
+ * created object will NOT own the specified sink
+ * 
+ * @param sink output sink
+ * @param memory window, memory level and context takeover settings
+ * @return deflate sink
+ */
+template <typename Sink>
+deflate_sink<sl::io::reference_sink<Sink>> make_deflate_sink(Sink& sink, const deflate_memory_profile& memory) {
+    return deflate_sink<sl::io::reference_sink<Sink>> (
+            sl::io::make_reference_sink(sink), memory);
+}
+
+/**
+ * Factory function for creating deflate sinks with "rsyncable" output,
+ * created object will own the specified sink
+ * 
+ * @param sink output sink
+ * @param chunker chunker configuration
+ * @return deflate sink
+ */
+template <typename Sink,
+        class = typename std::enable_if<!std::is_lvalue_reference<Sink>::value>::type>
+deflate_sink<Sink> make_deflate_sink(Sink&& sink, const rsyncable_chunker& chunker) {
+    return deflate_sink<Sink>(std::move(sink), chunker);
+}
+
+/**
+ * Factory function for creating deflate sinks with "rsyncable" output,
+ * created object will NOT own the specified sink
+ * 
+ * @param sink output sink
+ * @param chunker chunker configuration
+ * @return deflate sink
+ */
+template <typename Sink>
+deflate_sink<sl::io::reference_sink<Sink>> make_deflate_sink(Sink& sink, const rsyncable_chunker& chunker) {
+    return deflate_sink<sl::io::reference_sink<Sink>> (
+            sl::io::make_reference_sink(sink), chunker);
+}
+
+/**
+ * Factory function for creating deflate sinks with adaptive compression level,
+ * created object will own the specified sink
+ * 
+ * @param sink output sink
+ * @param controller level controller configuration
+ * @return deflate sink
+ */
+template <typename Sink,
+        class = typename std::enable_if<!std::is_lvalue_reference<Sink>::value>::type>
+deflate_sink<Sink> make_deflate_sink(Sink&& sink, const adaptive_level& controller) {
+    return deflate_sink<Sink>(std::move(sink), controller);
+}
+
+/**
+ * Factory function for creating deflate sinks with adaptive compression level,
+ * created object will NOT own the specified sink
+ * 
+ * @param sink output sink
+ * @param controller level controller configuration
+ * @return deflate sink
+ */
+template <typename Sink>
+deflate_sink<sl::io::reference_sink<Sink>> make_deflate_sink(Sink& sink, const adaptive_level& controller) {
+    return deflate_sink<sl::io::reference_sink<Sink>> (
+            sl::io::make_reference_sink(sink), controller);
+}
+
 } // namespace
 }
 
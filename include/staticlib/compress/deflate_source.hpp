@@ -0,0 +1,296 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   deflate_source.hpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 3:20 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_DEFLATE_SOURCE_HPP
+#define STATICLIB_COMPRESS_DEFLATE_SOURCE_HPP
+
+#include <array>
+#include <ios>
+#include <memory>
+#include <type_traits>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/deflate_dictionary.hpp"
+#include "staticlib/compress/deflate_memory_profile.hpp"
+#include "staticlib/compress/deflate_stream.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Source wrapper that compresses the data read from the underlying
+ * source using Deflate algorithm, output is the same as the one
+ * produced by "deflate_sink"
+ */
+template <typename Source, int compression_level = 6, std::size_t buf_size = 4096>
+class deflate_source {
+    /**
+     * Source of uncompressed data
+     */
+    Source src;
+    /**
+     * Internal buffer
+     */
+    std::array<char, buf_size> buf;
+    /**
+     * Zlib compressing stream
+     */
+    detail::zlib_stream* strm;
+    /**
+     * Start position in internal buffer
+     */
+    size_t pos = 0;
+    /**
+     * Number of bytes available in internal buffer
+     */
+    size_t avail = 0;
+    /**
+     * Source EOF flag
+     */
+    bool exhausted = false;
+    /**
+     * End of compressed stream flag
+     */
+    bool finished = false;
+
+public:
+    /**
+     * Constructor, created object will own the specified source
+     *
+     * @param src source to read uncompressed data from
+     */
+    deflate_source(Source src) :
+    deflate_source(std::move(src), sl::io::span<const char>(nullptr, 0), deflate_memory_profile()) { }
+
+    /**
+     * Constructor with memory settings, context takeover
+     * setting is not used, output is a single message
+     *
+     * @param src source to read uncompressed data from
+     * @param memory window and memory level settings
+     */
+    deflate_source(Source src, const deflate_memory_profile& memory) :
+    deflate_source(std::move(src), sl::io::span<const char>(nullptr, 0), memory) { }
+
+    /**
+     * Constructor with preset dictionary, the same dictionary
+     * must be used to decompress the data
+     *
+     * @param src source to read uncompressed data from
+     * @param dict preset dictionary, is not used after construction
+     */
+    deflate_source(Source src, const deflate_dictionary& dict) :
+    deflate_source(std::move(src), sl::io::span<const char>(dict.get_data().data(), dict.get_data().length()),
+            deflate_memory_profile()) { }
+
+    ~deflate_source() STATICLIB_NOEXCEPT {
+        detail::deflate_stream_destroy(strm);
+    }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    deflate_source(const deflate_source&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    deflate_source& operator=(const deflate_source&) = delete;
+
+    /**
+     * Move constructor
+     *
+     * @param other other instance
+     */
+    deflate_source(deflate_source&& other) :
+    src(std::move(other.src)),
+    buf(std::move(other.buf)),
+    strm(other.strm),
+    pos(other.pos),
+    avail(other.avail),
+    exhausted(other.exhausted),
+    finished(other.finished) {
+        other.strm = nullptr;
+    }
+
+    /**
+     * Move assignment operator
+     *
+     * @param other other instance
+     * @return this instance
+     */
+    deflate_source& operator=(deflate_source&& other) {
+        src = std::move(other.src);
+        buf = std::move(other.buf);
+        strm = other.strm;
+        other.strm = nullptr;
+        pos = other.pos;
+        avail = other.avail;
+        exhausted = other.exhausted;
+        finished = other.finished;
+        return *this;
+    }
+
+    /**
+     * Read implementation
+     *
+     * @param span output span
+     * @return number of bytes written into specified span
+     */
+    std::streamsize read(sl::io::span<char> span) {
+        while (!finished) {
+            // fill buffer if empty
+            if (0 == avail && !exhausted) {
+                avail = sl::io::read_all(src, {buf.data(), buf.size()});
+                pos = 0;
+                exhausted = avail < buf.size();
+            }
+            size_t read = 0;
+            size_t produced = 0;
+            auto err = detail::deflate_stream_step(strm, {buf.data() + pos, avail}, span,
+                    exhausted ? Z_FINISH : Z_NO_FLUSH, read, produced);
+            pos += read;
+            avail -= read;
+            finished = Z_STREAM_END == err;
+            std::streamsize written = static_cast<std::streamsize> (produced);
+            if (written > 0 || 0 == span.size()) {
+                return written;
+            }
+        }
+        return std::char_traits<char>::eof();
+    }
+
+    /**
+     * Underlying source accessor
+     *
+     * @return underlying source reference
+     */
+    Source& get_source() {
+        return src;
+    }
+
+private:
+    deflate_source(Source&& src, sl::io::span<const char> dict, const deflate_memory_profile& memory) :
+    src(std::move(src)),
+    strm(detail::deflate_stream_create(compression_level, memory, dict)) { }
+
+};
+
+/**
+ * Factory function for creating deflate sources,
+ * created object will own the specified source
+ *
+ * @param source input source
+ * @return deflate source
+ */
+template <typename Source,
+        class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+deflate_source<Source> make_deflate_source(Source&& source) {
+    return deflate_source<Source>(std::move(source));
+}
+
+/**
+ * Factory function for creating deflate sources,
+ * created object will NOT own the specified source
+ *
+ * @param source input source
+ * @return deflate source
+ */
+template <typename Source>
+deflate_source<sl::io::reference_source<Source>> make_deflate_source(Source& source) {
+    return deflate_source<sl::io::reference_source<Source>> (
+            sl::io::make_reference_source(source));
+}
+
+/**
+ * Factory function for creating deflate sources with preset dictionary,
+ * created object will own the specified source
+ *
+ * @param source input source
+ * @param dict preset dictionary
+ * @return deflate source
+ */
+template <typename Source,
+        class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+deflate_source<Source> make_deflate_source(Source&& source, const deflate_dictionary& dict) {
+    return deflate_source<Source>(std::move(source), dict);
+}
+
+/**
+ * Factory function for creating deflate sources with preset dictionary,
+ * created object will NOT own the specified source
+ *
+ * @param source input source
+ * @param dict preset dictionary
+ * @return deflate source
+ */
+template <typename Source>
+deflate_source<sl::io::reference_source<Source>> make_deflate_source(Source& source,
+        const deflate_dictionary& dict) {
+    return deflate_source<sl::io::reference_source<Source>> (
+            sl::io::make_reference_source(source), dict);
+}
+
+/**
+ * Factory function for creating deflate sources with memory settings,
+ * created object will own the specified source
+ *
+ * @param source input source
+ * @param memory window and memory level settings
+ * @return deflate source
+ */
+template <typename Source,
+        class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+deflate_source<Source> make_deflate_source(Source&& source, const deflate_memory_profile& memory) {
+    return deflate_source<Source>(std::move(source), memory);
+}
+
+/**
+ * Factory function for creating deflate sources with memory settings,
+ * created object will NOT own the specified source
+ *
+ * @param source input source
+ * @param memory window and memory level settings
+ * @return deflate source
+ */
+template <typename Source>
+deflate_source<sl::io::reference_source<Source>> make_deflate_source(Source& source,
+        const deflate_memory_profile& memory) {
+    return deflate_source<sl::io::reference_source<Source>> (
+            sl::io::make_reference_source(source), memory);
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_DEFLATE_SOURCE_HPP */
+
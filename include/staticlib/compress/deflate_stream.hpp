@@ -0,0 +1,152 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   deflate_stream.hpp
+ * Author: alex
+ *
+ * Created on October 29, 2026, 2:30 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_DEFLATE_STREAM_HPP
+#define STATICLIB_COMPRESS_DEFLATE_STREAM_HPP
+
+#include <cstdlib>
+#include <cstring>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/deflate_memory_profile.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+// Stream setup and codec loop shared by "deflate_sink" and "deflate_source"
+
+/**
+ * Allocates and initializes raw Deflate compressing stream
+ *
+ * @param level compression level
+ * @param memory window and memory level settings
+ * @param dict preset dictionary, may be empty
+ * @return initialized stream, must be released with "deflate_stream_destroy"
+ */
+inline zlib_stream* deflate_stream_create(int level, const deflate_memory_profile& memory,
+        sl::io::span<const char> dict) {
+    zlib_stream* stream = static_cast<zlib_stream*> (std::malloc(sizeof(zlib_stream)));
+    if (nullptr == stream) throw compress_exception(TRACEMSG(
+            "Error creating deflate stream: 'malloc' failed"));
+    std::memset(stream, 0, sizeof (zlib_stream));
+    auto err = zlib_deflate_init2(stream, level, -memory.get_window_bits(),
+            memory.get_mem_level(), Z_DEFAULT_STRATEGY);
+    if (Z_OK != err) {
+        std::free(stream);
+        throw compress_exception(TRACEMSG(
+                "Error initializing deflate stream: [" + zlib_error(err) + "]"));
+    }
+    if (dict.size() > 0) {
+        err = zlib_deflate_set_dictionary(stream, dict.data(), dict.size());
+        if (Z_OK != err) {
+            zlib_deflate_end(stream);
+            std::free(stream);
+            throw compress_exception(TRACEMSG(
+                    "Error setting deflate dictionary: [" + zlib_error(err) + "]"));
+        }
+    }
+    return stream;
+}
+
+/**
+ * Releases stream created with "deflate_stream_create"
+ *
+ * @param strm stream, may be null
+ */
+inline void deflate_stream_destroy(zlib_stream* strm) STATICLIB_NOEXCEPT {
+    if (nullptr == strm) return;
+    zlib_deflate_end(strm);
+    std::free(strm);
+}
+
+/**
+ * Single deflate call
+ *
+ * @param strm stream
+ * @param input input data
+ * @param out output buffer
+ * @param flush zlib flush mode
+ * @param consumed number of input bytes consumed
+ * @param produced number of output bytes produced
+ * @return zlib result code, Z_OK, Z_STREAM_END or Z_BUF_ERROR (no progress possible)
+ */
+inline int deflate_stream_step(zlib_stream* strm, sl::io::span<const char> input, sl::io::span<char> out,
+        int flush, size_t& consumed, size_t& produced) {
+    strm->next_in = reinterpret_cast<const unsigned char*> (input.data());
+    strm->avail_in = static_cast<zlib_uint> (input.size());
+    strm->next_out = reinterpret_cast<unsigned char*> (out.data());
+    strm->avail_out = static_cast<zlib_uint> (out.size());
+    auto err = zlib_deflate(strm, flush);
+    if (Z_OK != err && Z_STREAM_END != err && Z_BUF_ERROR != err) throw compress_exception(TRACEMSG(
+            "Deflate error: [" + zlib_error(err) + "]"));
+    consumed = input.size() - strm->avail_in;
+    produced = out.size() - strm->avail_out;
+    return err;
+}
+
+/**
+ * Compresses all the specified input through the specified buffer, passes
+ * every filled part of the buffer to "emit" callback. With Z_NO_FLUSH
+ * returns once all input is consumed, with flush modes - once all pending
+ * output is flushed, with Z_FINISH - when the end of stream is written.
+ *
+ * @param strm stream
+ * @param input input data, may be empty
+ * @param buf output buffer
+ * @param flush zlib flush mode
+ * @param emit callback that takes "sl::io::span<const char>" with compressed data
+ */
+template <typename Emit>
+void deflate_stream_pump(zlib_stream* strm, sl::io::span<const char> input, sl::io::span<char> buf,
+        int flush, Emit emit) {
+    size_t pos = 0;
+    for (;;) {
+        size_t consumed = 0;
+        size_t produced = 0;
+        auto err = deflate_stream_step(strm, {input.data() + pos, input.size() - pos}, buf,
+                flush, consumed, produced);
+        pos += consumed;
+        if (produced > 0) {
+            emit(sl::io::span<const char>(buf.data(), produced));
+        }
+        if (Z_STREAM_END == err) break;
+        if (pos < input.size()) continue;
+        if (Z_NO_FLUSH == flush) break;
+        if (Z_FINISH != flush && produced < buf.size()) break;
+        if (Z_BUF_ERROR == err && 0 == produced) break;
+    }
+}
+
+} // namespace
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_DEFLATE_STREAM_HPP */
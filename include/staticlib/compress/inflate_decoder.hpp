@@ -0,0 +1,284 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   inflate_decoder.hpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 10:30 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_INFLATE_DECODER_HPP
+#define STATICLIB_COMPRESS_INFLATE_DECODER_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/decode_result.hpp"
+#include "staticlib/compress/deflate_dictionary.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Push-based Deflate decoder, compressed data is passed to it
+ * as it arrives and it never reads from any source, so it can be used
+ * from event loops. Decoder keeps only zlib state (about 40KB),
+ * output is written into caller-provided buffers.
+ */
+class inflate_decoder {
+    /**
+     * Zlib decompressing stream
+     */
+    detail::zlib_stream* strm;
+    /**
+     * Shared preset dictionary, is applied again on "reset()",
+     * null if not used or if it was passed by reference
+     */
+    std::shared_ptr<const deflate_dictionary> dict;
+    /**
+     * End of stream flag
+     */
+    bool finished = false;
+
+public:
+    /**
+     * Constructor
+     */
+    inflate_decoder() :
+    inflate_decoder(std::shared_ptr<const deflate_dictionary>(), sl::io::span<const char>(nullptr, 0)) { }
+
+    /**
+     * Constructor with preset dictionary, dictionary is applied
+     * immediately and is not kept, "reset(dict)" must be used
+     * to decode next stream with the same dictionary
+     *
+     * @param dict preset dictionary that was used for compression
+     */
+    explicit inflate_decoder(const deflate_dictionary& dict) :
+    inflate_decoder(std::shared_ptr<const deflate_dictionary>(),
+            {dict.get_data().data(), dict.get_data().length()}) { }
+
+    /**
+     * Constructor with shared preset dictionary (see "dictionary_registry"),
+     * dictionary is referenced (not copied) and is applied again on "reset()"
+     *
+     * @param dict preset dictionary that was used for compression
+     */
+    explicit inflate_decoder(std::shared_ptr<const deflate_dictionary> dict) :
+    inflate_decoder(dict, nullptr != dict.get() ?
+            sl::io::span<const char>(dict->get_data().data(), dict->get_data().length()) :
+            sl::io::span<const char>(nullptr, 0)) { }
+
+    ~inflate_decoder() STATICLIB_NOEXCEPT {
+        if (nullptr == strm) return;
+        detail::zlib_inflate_end(strm);
+        std::free(strm);
+    }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    inflate_decoder(const inflate_decoder&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    inflate_decoder& operator=(const inflate_decoder&) = delete;
+
+    /**
+     * Move constructor
+     *
+     * @param other other instance
+     */
+    inflate_decoder(inflate_decoder&& other) :
+    strm(other.strm),
+    dict(std::move(other.dict)),
+    finished(other.finished) {
+        other.strm = nullptr;
+    }
+
+    /**
+     * Move assignment operator
+     *
+     * @param other other instance
+     * @return this instance
+     */
+    inflate_decoder& operator=(inflate_decoder&& other) {
+        if (nullptr != strm) {
+            detail::zlib_inflate_end(strm);
+            std::free(strm);
+        }
+        strm = other.strm;
+        other.strm = nullptr;
+        dict = std::move(other.dict);
+        finished = other.finished;
+        return *this;
+    }
+
+    /**
+     * Decodes as much of the specified input as fits into the specified output
+     *
+     * @param input compressed data
+     * @param output buffer for decompressed data
+     * @return number of bytes consumed and produced, and decoder state
+     * @throws compress_exception on invalid data
+     */
+    decode_result decode(sl::io::span<const char> input, sl::io::span<char> output) {
+        if (finished) {
+            return decode_result(0, 0, decode_status::done);
+        }
+        strm->next_in = reinterpret_cast<const unsigned char*> (input.data());
+        strm->avail_in = static_cast<detail::zlib_uint> (input.size());
+        strm->next_out = reinterpret_cast<unsigned char*> (output.data());
+        strm->avail_out = static_cast<detail::zlib_uint> (output.size());
+        auto err = detail::zlib_inflate(strm, Z_NO_FLUSH);
+        if (Z_OK != err && Z_STREAM_END != err && Z_BUF_ERROR != err) throw compress_exception(TRACEMSG(
+                "Inflate error: [" + detail::zlib_error(err) + "]"));
+        size_t consumed = input.size() - strm->avail_in;
+        size_t produced = output.size() - strm->avail_out;
+        if (Z_STREAM_END == err) {
+            finished = true;
+            return decode_result(consumed, produced, decode_status::done);
+        }
+        return decode_result(consumed, produced, 0 == strm->avail_out ?
+                decode_status::output_full : decode_status::need_input);
+    }
+
+    /**
+     * Decodes all the specified input passing the decompressed data
+     * to the specified callback in chunks, stack buffer is used for output
+     *
+     * @param input compressed data
+     * @param emit callable that takes "sl::io::span<const char>"
+     * @return number of bytes consumed and produced, status is
+     *         either "need_input" or "done"
+     * @throws compress_exception on invalid data
+     */
+    template <typename Emit>
+    decode_result feed(sl::io::span<const char> input, Emit emit) {
+        return detail::feed_decoder(*this, input, emit);
+    }
+
+    /**
+     * Prepares decoder for the next stream, allocated memory is reused,
+     * shared dictionary passed to constructor is applied again
+     */
+    void reset() {
+        if (nullptr != dict.get()) {
+            reset({dict->get_data().data(), dict->get_data().length()});
+        } else {
+            reset(sl::io::span<const char>(nullptr, 0));
+        }
+    }
+
+    /**
+     * Prepares decoder for the next stream that was compressed with
+     * the specified preset dictionary, allocated memory is reused
+     *
+     * @param dictionary preset dictionary contents, is not used after this call
+     */
+    void reset(sl::io::span<const char> dictionary) {
+        auto err = detail::zlib_inflate_reset(strm);
+        if (Z_OK == err) {
+            err = set_dictionary(strm, dictionary);
+        }
+        if (Z_OK != err) throw compress_exception(TRACEMSG(
+                "Error resetting inflate stream: [" + detail::zlib_error(err) + "]"));
+        finished = false;
+    }
+
+    /**
+     * Prepares decoder to continue decoding a Deflate stream from a block
+     * boundary in the middle of it, allocated memory is reused
+     *
+     * @param window up to 32KB of data that was decompressed before the boundary
+     * @param bits number of bits (0-7) of the partially consumed byte,
+     *        that belong to the block, such byte is NOT passed to "decode()"
+     * @param value these bits placed in the lowest positions
+     */
+    void resume(sl::io::span<const char> window, int bits, int value) {
+        auto err = detail::zlib_inflate_reset(strm);
+        if (Z_OK == err && window.size() > 0) {
+            err = detail::zlib_inflate_set_dictionary(strm, window.data(), window.size());
+        }
+        if (Z_OK == err && bits > 0) {
+            err = detail::zlib_inflate_prime(strm, bits, value);
+        }
+        if (Z_OK != err) throw compress_exception(TRACEMSG(
+                "Error resuming inflate stream: [" + detail::zlib_error(err) + "]"));
+        finished = false;
+    }
+
+    /**
+     * Checks whether the end of compressed stream was reached
+     *
+     * @return true if stream is finished
+     */
+    bool is_done() const {
+        return finished;
+    }
+
+private:
+    inflate_decoder(std::shared_ptr<const deflate_dictionary> shared, sl::io::span<const char> dictionary) :
+    strm([&dictionary] {
+        detail::zlib_stream* stream = static_cast<detail::zlib_stream*> (std::malloc(sizeof(detail::zlib_stream)));
+        if (nullptr == stream) throw compress_exception(TRACEMSG(
+                "Error creating inflate stream: 'malloc' failed"));
+        std::memset(stream, 0, sizeof (detail::zlib_stream));
+        auto err = detail::zlib_inflate_init2(stream, -MAX_WBITS);
+        if (Z_OK == err) {
+            err = set_dictionary(stream, dictionary);
+            if (Z_OK != err) {
+                detail::zlib_inflate_end(stream);
+            }
+        }
+        if (Z_OK != err) {
+            std::free(stream);
+            throw compress_exception(TRACEMSG(
+                    "Error initializing inflate stream: [" + detail::zlib_error(err) + "]"));
+        }
+        return stream;
+    }()),
+    dict(std::move(shared)) { }
+
+    static int set_dictionary(detail::zlib_stream* stream, sl::io::span<const char> dictionary) {
+        if (0 == dictionary.size()) {
+            return Z_OK;
+        }
+        // raw inflate accepts dictionary right after initialization
+        return detail::zlib_inflate_set_dictionary(stream, dictionary.data(), dictionary.size());
+    }
+
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_INFLATE_DECODER_HPP */
+
@@ -30,12 +30,12 @@
 #include <memory>
 #include <type_traits>
 
-#include "zlib.h"
-
 #include "staticlib/config.hpp"
 #include "staticlib/io.hpp"
 
 #include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/deflate_dictionary.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
 
 
 namespace staticlib {
@@ -57,7 +57,7 @@ class inflate_source {
     /**
      * Zlib decompressing stream
      */
-    z_stream* strm;
+    detail::zlib_stream* strm;
     /**
      * Start position in internal buffer
      */
@@ -78,21 +78,20 @@ public:
      * @param src source to read compressed data from
      */
     inflate_source(Source src) :
-    src(std::move(src)),
-    strm([]{
-        z_stream* stream = static_cast<z_stream*> (std::malloc(sizeof(z_stream)));
-        if (nullptr == stream) throw compress_exception(TRACEMSG(
-                "Error creating inflate stream: 'malloc' failed"));
-        std::memset(stream, 0, sizeof (z_stream));
-        auto err = inflateInit2(stream, -MAX_WBITS);
-        if (Z_OK != err) throw compress_exception(TRACEMSG(
-                "Error initializing inflate stream: [" + ::zError(err) + "]"));
-        return stream;
-    }()) { }
+    inflate_source(std::move(src), sl::io::span<const char>(nullptr, 0)) { }
+
+    /**
+     * Constructor with preset dictionary, created object will own the specified source
+     * 
+     * @param src source to read compressed data from
+     * @param dict preset dictionary that was used for compression
+     */
+    inflate_source(Source src, const deflate_dictionary& dict) :
+    inflate_source(std::move(src), sl::io::span<const char>(dict.get_data().data(), dict.get_data().length())) { }
 
     ~inflate_source() STATICLIB_NOEXCEPT {
         if (nullptr == strm) return;
-        ::inflateEnd(strm);
+        detail::zlib_inflate_end(strm);
         std::free(strm);
     }
 
@@ -158,11 +157,11 @@ public:
             }
             // prepare zlib stream
             strm->next_in = reinterpret_cast<unsigned char*> (buf.data() + pos);
-            strm->avail_in = static_cast<uInt> (avail);
+            strm->avail_in = static_cast<detail::zlib_uint> (avail);
             strm->next_out = reinterpret_cast<unsigned char*> (span.data());
-            strm->avail_out = static_cast<uInt> (span.size());
+            strm->avail_out = static_cast<detail::zlib_uint> (span.size());
             // call inflate
-            auto err = ::inflate(strm, Z_FINISH);
+            auto err = detail::zlib_inflate(strm, Z_FINISH);
             if (Z_OK == err || Z_STREAM_END == err || Z_BUF_ERROR == err) {
                 std::streamsize read = avail - strm->avail_in;
                 std::streamsize written = span.size_signed() - strm->avail_out;
@@ -175,7 +174,7 @@ public:
                 exhausted = true;
                 return std::char_traits<char>::eof();
             } else throw compress_exception(TRACEMSG(
-                    + "Inflate error: [" + ::zError(err) + "]"));
+                    + "Inflate error: [" + detail::zlib_error(err) + "]"));
         } else {
             return std::char_traits<char>::eof();
         }
@@ -189,6 +188,30 @@ public:
     Source& get_source() {
         return src;
     }  
+
+private:
+    inflate_source(Source src, sl::io::span<const char> dict) :
+    src(std::move(src)),
+    strm([&dict] {
+        detail::zlib_stream* stream = static_cast<detail::zlib_stream*> (std::malloc(sizeof(detail::zlib_stream)));
+        if (nullptr == stream) throw compress_exception(TRACEMSG(
+                "Error creating inflate stream: 'malloc' failed"));
+        std::memset(stream, 0, sizeof (detail::zlib_stream));
+        auto err = detail::zlib_inflate_init2(stream, -MAX_WBITS);
+        if (Z_OK != err) throw compress_exception(TRACEMSG(
+                "Error initializing inflate stream: [" + detail::zlib_error(err) + "]"));
+        // raw inflate accepts dictionary right after initialization
+        if (dict.size() > 0) {
+            err = detail::zlib_inflate_set_dictionary(stream, dict.data(), dict.size());
+            if (Z_OK != err) {
+                detail::zlib_inflate_end(stream);
+                std::free(stream);
+                throw compress_exception(TRACEMSG(
+                        "Error setting inflate dictionary: [" + detail::zlib_error(err) + "]"));
+            }
+        }
+        return stream;
+    }()) { }
     
 };
 
@@ -218,6 +241,34 @@ inflate_source<sl::io::reference_source<Source>> make_inflate_source(Source& sou
             sl::io::make_reference_source(source));
 }
 
+/**
+ * Factory function for creating inflate sources with preset dictionary,
+ * created object will own the specified source
+ * 
+ * @param source input source
+ * @param dict preset dictionary that was used for compression
+ * @return inflate source
+ */
+template <typename Source, 
+        class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+inflate_source<Source> make_inflate_source(Source&& source, const deflate_dictionary& dict) {
+    return inflate_source<Source>(std::move(source), dict);
+}
+
+/**
+ * Factory function for creating inflate sources with preset dictionary,
+ * created object will NOT own the specified source
+ * 
+ * @param source input source
+ * @param dict preset dictionary that was used for compression
+ * @return inflate source
+ */
+template <typename Source>
+inflate_source<sl::io::reference_source<Source>> make_inflate_source(Source& source, const deflate_dictionary& dict) {
+    return inflate_source<sl::io::reference_source<Source>>(
+            sl::io::make_reference_source(source), dict);
+}
+
 } // namespace
 }
 
@@ -0,0 +1,358 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   latency_histogram.hpp
+ * Author: alex
+ *
+ * Created on October 25, 2026, 10:15 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_LATENCY_HISTOGRAM_HPP
+#define STATICLIB_COMPRESS_LATENCY_HISTOGRAM_HPP
+
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+inline uint64_t elapsed_nanos(std::chrono::steady_clock::time_point start) {
+    auto dur = std::chrono::steady_clock::now() - start;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(dur).count());
+}
+
+inline std::string format_micros(uint64_t nanos) {
+    uint64_t tenths = (nanos + 50) / 100;
+    return sl::support::to_string(tenths / 10) + "." + sl::support::to_string(tenths % 10) + "us";
+}
+
+} // namespace
+
+/**
+ * Histogram of latencies in nanoseconds with HDR-style log-linear buckets:
+ * every power of two range is split into 32 equal sub-buckets, so recorded
+ * values are kept with about 3% precision over the whole 64-bit range
+ * using fixed 15KB of memory
+ */
+class latency_histogram {
+    static const int sub_bits = 5;
+    static const uint64_t sub_count = 1 << sub_bits;
+
+    std::vector<uint64_t> counts;
+    uint64_t count = 0;
+    uint64_t total = 0;
+    uint64_t min_value = UINT64_MAX;
+    uint64_t max_value = 0;
+
+public:
+    /**
+     * Constructor
+     */
+    latency_histogram() :
+    counts(static_cast<size_t>((64 - sub_bits + 1) * sub_count), 0) { }
+
+    /**
+     * Records single value
+     *
+     * @param nanos latency in nanoseconds
+     */
+    void record(uint64_t nanos) {
+        counts[bucket_index(nanos)] += 1;
+        count += 1;
+        total += nanos;
+        min_value = std::min(min_value, nanos);
+        max_value = std::max(max_value, nanos);
+    }
+
+    /**
+     * Adds all values recorded in other histogram to this one
+     *
+     * @param other histogram to merge
+     */
+    void merge(const latency_histogram& other) {
+        for (size_t i = 0; i < counts.size(); i++) {
+            counts[i] += other.counts[i];
+        }
+        count += other.count;
+        total += other.total;
+        min_value = std::min(min_value, other.min_value);
+        max_value = std::max(max_value, other.max_value);
+    }
+
+    /**
+     * Removes all recorded values
+     */
+    void reset() {
+        std::fill(counts.begin(), counts.end(), 0);
+        count = 0;
+        total = 0;
+        min_value = UINT64_MAX;
+        max_value = 0;
+    }
+
+    /**
+     * Returns the value below or equal to which the specified
+     * percentage of the recorded values fall
+     *
+     * @param percentile percentile in [0, 100] range
+     * @return latency in nanoseconds, zero if histogram is empty
+     */
+    uint64_t get_percentile(double percentile) const {
+        if (percentile < 0 || percentile > 100) throw compress_exception(TRACEMSG(
+                "Invalid percentile: [" + sl::support::to_string(percentile) + "]"));
+        if (0 == count) return 0;
+        if (0 == percentile) return min_value;
+        uint64_t target = static_cast<uint64_t>(percentile * static_cast<double>(count) / 100.0 + 0.5);
+        target = std::max(target, static_cast<uint64_t>(1));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+            seen += counts[i];
+            if (seen >= target) {
+                return std::min(std::max(bucket_highest(i), min_value), max_value);
+            }
+        }
+        return max_value;
+    }
+
+    /**
+     * Number of recorded values accessor
+     *
+     * @return number of recorded values
+     */
+    uint64_t get_count() const {
+        return count;
+    }
+
+    /**
+     * Sum of recorded values accessor
+     *
+     * @return sum of recorded values in nanoseconds
+     */
+    uint64_t get_total() const {
+        return total;
+    }
+
+    /**
+     * Min recorded value accessor
+     *
+     * @return min value in nanoseconds, zero if histogram is empty
+     */
+    uint64_t get_min() const {
+        return 0 == count ? 0 : min_value;
+    }
+
+    /**
+     * Max recorded value accessor
+     *
+     * @return max value in nanoseconds
+     */
+    uint64_t get_max() const {
+        return max_value;
+    }
+
+    /**
+     * Mean of recorded values
+     *
+     * @return mean value in nanoseconds, zero if histogram is empty
+     */
+    uint64_t get_mean() const {
+        return 0 == count ? 0 : total / count;
+    }
+
+    /**
+     * Formats percentile summary of the recorded values,
+     * e.g. "count: 1000, min: 1.2us, p50: 3.4us, p90: 5.6us,
+     * p99: 20.1us, p99.9: 150.0us, max: 310.5us"
+     *
+     * @return summary string
+     */
+    std::string summary() const {
+        return "count: " + sl::support::to_string(count) +
+                ", min: " + detail::format_micros(get_min()) +
+                ", p50: " + detail::format_micros(get_percentile(50)) +
+                ", p90: " + detail::format_micros(get_percentile(90)) +
+                ", p99: " + detail::format_micros(get_percentile(99)) +
+                ", p99.9: " + detail::format_micros(get_percentile(99.9)) +
+                ", max: " + detail::format_micros(get_max());
+    }
+
+private:
+    static size_t bucket_index(uint64_t value) {
+        if (value < sub_count) {
+            return static_cast<size_t>(value);
+        }
+        int msb = 0;
+        for (uint64_t v = value; v > 1; v >>= 1) {
+            msb += 1;
+        }
+        int group = msb - sub_bits + 1;
+        uint64_t top = value >> (group - 1);
+        return static_cast<size_t>(group * sub_count + (top - sub_count));
+    }
+
+    static uint64_t bucket_highest(size_t index) {
+        if (index < sub_count) {
+            return static_cast<uint64_t>(index);
+        }
+        int group = static_cast<int>(index / sub_count);
+        uint64_t sub = static_cast<uint64_t>(index % sub_count);
+        uint64_t lowest = (sub_count + sub) << (group - 1);
+        return lowest + ((static_cast<uint64_t>(1) << (group - 1)) - 1);
+    }
+
+};
+
+/**
+ * Stream operations, latencies of which are recorded separately
+ */
+enum class latency_op {
+    read,
+    write,
+    flush,
+    finalize
+};
+
+/**
+ * Role of a timed wrapper in the streams chain
+ */
+enum class latency_role {
+    /**
+     * Wraps the codec (e.g. "deflate_sink"), records
+     * the latencies of every call
+     */
+    codec,
+    /**
+     * Wraps the underlying stream of the codec (e.g. "file_sink"),
+     * adds its time to the current codec call
+     */
+    io
+};
+
+/**
+ * Set of latency histograms for a stream of codec wrappers,
+ * for every operation it holds the histogram of time spent in
+ * the codec itself and the histogram of time spent in the underlying
+ * I/O during the same call. Is filled by "timed_sink" and "timed_source"
+ * wrappers, is not thread-safe.
+ */
+class latency_recorder {
+    std::array<latency_histogram, 4> codec;
+    std::array<latency_histogram, 4> io;
+    uint64_t call_io_nanos = 0;
+    bool call_io_happened = false;
+
+public:
+    /**
+     * Codec time histogram accessor
+     *
+     * @param op stream operation
+     * @return histogram of time spent in codec, without I/O time
+     */
+    const latency_histogram& get_codec(latency_op op) const {
+        return codec[static_cast<size_t>(op)];
+    }
+
+    /**
+     * I/O time histogram accessor
+     *
+     * @param op stream operation
+     * @return histogram of time spent in underlying I/O per codec call,
+     *         calls that did not reach underlying stream are not recorded
+     */
+    const latency_histogram& get_io(latency_op op) const {
+        return io[static_cast<size_t>(op)];
+    }
+
+    /**
+     * Removes all recorded values
+     */
+    void reset() {
+        for (size_t i = 0; i < codec.size(); i++) {
+            codec[i].reset();
+            io[i].reset();
+        }
+    }
+
+    /**
+     * Formats percentile summaries of all non-empty histograms,
+     * one histogram per line
+     *
+     * @return summary string
+     */
+    std::string summary() const {
+        static const char* names[] = {"read", "write", "flush", "finalize"};
+        auto res = std::string();
+        for (size_t i = 0; i < codec.size(); i++) {
+            if (codec[i].get_count() > 0) {
+                res += std::string(names[i]) + " codec: " + codec[i].summary() + "\n";
+            }
+            if (io[i].get_count() > 0) {
+                res += std::string(names[i]) + " io: " + io[i].summary() + "\n";
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Starts measurement of a codec call
+     */
+    void begin_call() {
+        call_io_nanos = 0;
+        call_io_happened = false;
+    }
+
+    /**
+     * Adds time spent in underlying I/O to the current codec call
+     *
+     * @param nanos I/O time in nanoseconds
+     */
+    void add_io(uint64_t nanos) {
+        call_io_nanos += nanos;
+        call_io_happened = true;
+    }
+
+    /**
+     * Completes measurement of a codec call
+     *
+     * @param op stream operation
+     * @param total_nanos overall time of the call, including I/O
+     */
+    void end_call(latency_op op, uint64_t total_nanos) {
+        size_t idx = static_cast<size_t>(op);
+        codec[idx].record(total_nanos > call_io_nanos ? total_nanos - call_io_nanos : 0);
+        if (call_io_happened) {
+            io[idx].record(call_io_nanos);
+        }
+    }
+
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_LATENCY_HISTOGRAM_HPP */
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lzma_buffer.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 11:20 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_LZMA_BUFFER_HPP
+#define STATICLIB_COMPRESS_LZMA_BUFFER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "lzma.h"
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/thread_local_contexts.hpp"
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+/**
+ * Reusable LZMA stream, liblzma keeps the allocated coder memory
+ * when the stream is reinitialized with the same filters
+ */
+class lzma_context {
+    lzma_stream strm;
+
+public:
+    lzma_context() :
+    strm(LZMA_STREAM_INIT) { }
+
+    ~lzma_context() STATICLIB_NOEXCEPT {
+        ::lzma_end(std::addressof(strm));
+    }
+
+    lzma_context(const lzma_context&) = delete;
+
+    lzma_context& operator=(const lzma_context&) = delete;
+
+    lzma_stream* reset_encoder(uint32_t preset) {
+        auto err = ::lzma_easy_encoder(std::addressof(strm), preset, LZMA_CHECK_CRC64);
+        if (LZMA_OK != err) throw compress_exception(TRACEMSG(
+                "Error initializing LZMA stream, code: [" + sl::support::to_string(err) + "]"));
+        return std::addressof(strm);
+    }
+
+    lzma_stream* reset_decoder() {
+        auto err = ::lzma_stream_decoder(std::addressof(strm), UINT64_MAX, 0);
+        if (LZMA_OK != err) throw compress_exception(TRACEMSG(
+                "Error initializing LZMA stream, code: [" + sl::support::to_string(err) + "]"));
+        return std::addressof(strm);
+    }
+
+};
+
+inline lzma_context& local_lzma_encoder_context() {
+#ifdef STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS
+    static thread_local lzma_context ctx;
+    return ctx;
+#else
+    // fallback: one context per thread is leaked on exit
+    static __declspec(thread) lzma_context* ctx = nullptr;
+    if (nullptr == ctx) {
+        ctx = new lzma_context();
+    }
+    return *ctx;
+#endif // STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS
+}
+
+inline lzma_context& local_lzma_decoder_context() {
+#ifdef STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS
+    static thread_local lzma_context ctx;
+    return ctx;
+#else
+    static __declspec(thread) lzma_context* ctx = nullptr;
+    if (nullptr == ctx) {
+        ctx = new lzma_context();
+    }
+    return *ctx;
+#endif // STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS
+}
+
+} // namespace
+
+/**
+ * Returns the upper bound of the XZ-compressed size for the data
+ * of the specified length
+ *
+ * @param len length of uncompressed data
+ * @return maximum compressed size
+ */
+inline size_t lzma_encode_bound(size_t len) {
+    return static_cast<size_t>(::lzma_stream_buffer_bound(len));
+}
+
+/**
+ * Compresses in-memory data into the specified output buffer using
+ * LZMA algorithm (XZ format), data is compressed with a single call
+ * to liblzma using a thread-local compression state;
+ * output is the same as the one produced by "lzma_sink"
+ *
+ * @param data data to compress
+ * @param out output buffer, "lzma_encode_bound()" bytes are always enough
+ * @param compression_level LZMA compression level
+ * @return number of bytes written into output buffer
+ * @throws compress_exception if output buffer is too small
+ */
+inline size_t lzma_encode_into(sl::io::span<const char> data, sl::io::span<char> out, int compression_level = 6) {
+    lzma_stream* strm = detail::local_lzma_encoder_context().reset_encoder(static_cast<uint32_t>(compression_level));
+    strm->next_in = reinterpret_cast<const uint8_t*> (data.data());
+    strm->avail_in = data.size();
+    strm->next_out = reinterpret_cast<uint8_t*> (out.data());
+    strm->avail_out = out.size();
+    auto err = ::lzma_code(strm, LZMA_FINISH);
+    if (LZMA_STREAM_END != err) throw compress_exception(TRACEMSG(
+            "LZMA error code: [" + sl::support::to_string(err) + "]," +
+            " output buffer size: [" + sl::support::to_string(out.size()) + "]"));
+    return static_cast<size_t>(strm->total_out);
+}
+
+/**
+ * Compresses in-memory data using LZMA algorithm (XZ format),
+ * output buffer is allocated once using the "lzma_encode_bound()" size
+ *
+ * @param data data to compress
+ * @param compression_level LZMA compression level
+ * @return compressed data
+ */
+inline std::string lzma_encode_buffer(sl::io::span<const char> data, int compression_level = 6) {
+    auto res = std::string();
+    res.resize(lzma_encode_bound(data.size()));
+    size_t len = lzma_encode_into(data, {&res.front(), res.length()}, compression_level);
+    res.resize(len);
+    return res;
+}
+
+/**
+ * Decompresses in-memory XZ data into the specified output buffer
+ * using a thread-local decompression state
+ *
+ * @param data compressed data
+ * @param out output buffer
+ * @return number of bytes written into output buffer
+ * @throws compress_exception if output buffer is too small or data is invalid
+ */
+inline size_t lzma_decode_into(sl::io::span<const char> data, sl::io::span<char> out) {
+    lzma_stream* strm = detail::local_lzma_decoder_context().reset_decoder();
+    strm->next_in = reinterpret_cast<const uint8_t*> (data.data());
+    strm->avail_in = data.size();
+    strm->next_out = reinterpret_cast<uint8_t*> (out.data());
+    strm->avail_out = out.size();
+    auto err = ::lzma_code(strm, LZMA_FINISH);
+    if (LZMA_STREAM_END != err) throw compress_exception(TRACEMSG(
+            "LZMA error code: [" + sl::support::to_string(err) + "]," +
+            " output buffer size: [" + sl::support::to_string(out.size()) + "]"));
+    return static_cast<size_t>(strm->total_out);
+}
+
+/**
+ * Decompresses in-memory XZ data, if uncompressed size is known
+ * it is used to allocate the output buffer exactly once, otherwise
+ * output buffer is grown as needed
+ *
+ * @param data compressed data
+ * @param uncompressed_size size of decompressed data, zero if unknown
+ * @return decompressed data
+ */
+inline std::string lzma_decode_buffer(sl::io::span<const char> data, size_t uncompressed_size = 0) {
+    auto res = std::string();
+    res.resize(uncompressed_size > 0 ? uncompressed_size : data.size() * 4 + 64);
+    lzma_stream* strm = detail::local_lzma_decoder_context().reset_decoder();
+    strm->next_in = reinterpret_cast<const uint8_t*> (data.data());
+    strm->avail_in = data.size();
+    for (;;) {
+        strm->next_out = reinterpret_cast<uint8_t*> (&res.front() + strm->total_out);
+        strm->avail_out = res.length() - static_cast<size_t>(strm->total_out);
+        auto err = ::lzma_code(strm, LZMA_FINISH);
+        if (LZMA_STREAM_END == err) break;
+        if ((LZMA_OK == err || LZMA_BUF_ERROR == err) && 0 == strm->avail_out) {
+            res.resize(res.length() * 2);
+        } else throw compress_exception(TRACEMSG(
+                "LZMA error code: [" + sl::support::to_string(err) + "]," +
+                " input bytes left: [" + sl::support::to_string(strm->avail_in) + "]"));
+    }
+    res.resize(static_cast<size_t>(strm->total_out));
+    return res;
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_LZMA_BUFFER_HPP */
+
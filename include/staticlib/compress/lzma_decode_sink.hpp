@@ -0,0 +1,187 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lzma_decode_sink.hpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 2:40 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_LZMA_DECODE_SINK_HPP
+#define STATICLIB_COMPRESS_LZMA_DECODE_SINK_HPP
+
+#include <cstdint>
+#include <ios>
+#include <type_traits>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/lzma_decoder.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Sink wrapper that decompresses written XZ data
+ * and writes the result into destination sink
+ */
+template <typename Sink>
+class lzma_decode_sink {
+    /**
+     * Destination sink for the decompressed data
+     */
+    Sink sink;
+    /**
+     * Push-based decoder
+     */
+    lzma_decoder decoder;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param sink destination to write decompressed data into
+     */
+    lzma_decode_sink(Sink&& sink) :
+    sink(std::move(sink)) { }
+
+    /**
+     * Constructor with decoder memory limit
+     *
+     * @param sink destination to write decompressed data into
+     * @param memlimit max memory to use for decoding
+     */
+    lzma_decode_sink(Sink&& sink, uint64_t memlimit) :
+    sink(std::move(sink)),
+    decoder(memlimit) { }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    lzma_decode_sink(const lzma_decode_sink&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    lzma_decode_sink& operator=(const lzma_decode_sink&) = delete;
+
+    /**
+     * Move constructor
+     *
+     * @param other other instance
+     */
+    lzma_decode_sink(lzma_decode_sink&& other) :
+    sink(std::move(other.sink)),
+    decoder(std::move(other.decoder)) { }
+
+    /**
+     * Move assignment operator
+     *
+     * @param other other instance
+     * @return this instance
+     */
+    lzma_decode_sink& operator=(lzma_decode_sink&& other) {
+        sink = std::move(other.sink);
+        decoder = std::move(other.decoder);
+        return *this;
+    }
+
+    /**
+     * Write implementation
+     *
+     * @param span source span
+     * @return number of bytes processed (read from source span)
+     * @throws compress_exception on invalid data or on data after the end of stream
+     */
+    std::streamsize write(sl::io::span<const char> span) {
+        auto res = decoder.feed(span, [this](sl::io::span<const char> out) {
+            sl::io::write_all(this->sink, out);
+        });
+        if (res.get_consumed() < span.size()) throw compress_exception(TRACEMSG(
+                "Unexpected data after the end of XZ stream, bytes left: [" +
+                sl::support::to_string(span.size() - res.get_consumed()) + "]"));
+        return span.size_signed();
+    }
+
+    /**
+     * Calls flush on dest stream
+     *
+     * @return value returned by dest stream
+     */
+    std::streamsize flush() {
+        return sink.flush();
+    }
+
+    /**
+     * Checks whether the end of XZ stream was written
+     *
+     * @return true if stream is finished
+     */
+    bool is_done() const {
+        return decoder.is_done();
+    }
+
+    /**
+     * Underlying sink accessor
+     *
+     * @return underlying sink reference
+     */
+    Sink& get_sink() {
+        return sink;
+    }
+
+};
+
+/**
+ * Factory function for creating lzma decode sinks,
+ * created object will own the specified sink
+ *
+ * @param sink output sink
+ * @return lzma decode sink
+ */
+template <typename Sink,
+        class = typename std::enable_if<!std::is_lvalue_reference<Sink>::value>::type>
+lzma_decode_sink<Sink> make_lzma_decode_sink(Sink&& sink) {
+    return lzma_decode_sink<Sink>(std::move(sink));
+}
+
+/**
+ * Factory function for creating lzma decode sinks,
+ * created object will NOT own the specified sink
+ *
+ * @param sink output sink
+ * @return lzma decode sink
+ */
+template <typename Sink>
+lzma_decode_sink<sl::io::reference_sink<Sink>> make_lzma_decode_sink(Sink& sink) {
+    return lzma_decode_sink<sl::io::reference_sink<Sink>> (
+            sl::io::make_reference_sink(sink));
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_LZMA_DECODE_SINK_HPP */
+
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lzma_decoder.hpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 11:15 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_LZMA_DECODER_HPP
+#define STATICLIB_COMPRESS_LZMA_DECODER_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+#include "lzma.h"
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/decode_result.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Push-based XZ decoder, compressed data is passed to it
+ * as it arrives and it never reads from any source, so it can be used
+ * from event loops. Memory used by decoder is bounded by the
+ * specified limit, output is written into caller-provided buffers.
+ */
+class lzma_decoder {
+    /**
+     * LZMA decompressing stream
+     */
+    lzma_stream* strm;
+    /**
+     * Decoder memory limit
+     */
+    uint64_t memlimit;
+    /**
+     * End of stream flag
+     */
+    bool finished = false;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param memlimit max memory to use for decoding, streams
+     *        that require more memory are rejected
+     */
+    explicit lzma_decoder(uint64_t memlimit = UINT64_MAX) :
+    strm([] {
+        lzma_stream* stream = static_cast<lzma_stream*> (std::malloc(sizeof(lzma_stream)));
+        if (nullptr == stream) throw compress_exception(TRACEMSG(
+                "Error creating lzma stream: 'malloc' failed"));
+        *stream = LZMA_STREAM_INIT;
+        return stream;
+    }()),
+    memlimit(memlimit) {
+        auto err = ::lzma_stream_decoder(strm, memlimit, 0);
+        if (LZMA_OK != err) {
+            std::free(strm);
+            throw compress_exception(TRACEMSG(
+                    "Error initializing LZMA stream, code: [" + sl::support::to_string(err) + "]"));
+        }
+    }
+
+    ~lzma_decoder() STATICLIB_NOEXCEPT {
+        if (nullptr == strm) return;
+        ::lzma_end(strm);
+        std::free(strm);
+    }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    lzma_decoder(const lzma_decoder&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    lzma_decoder& operator=(const lzma_decoder&) = delete;
+
+    /**
+     * Move constructor
+     *
+     * @param other other instance
+     */
+    lzma_decoder(lzma_decoder&& other) :
+    strm(other.strm),
+    memlimit(other.memlimit),
+    finished(other.finished) {
+        other.strm = nullptr;
+    }
+
+    /**
+     * Move assignment operator
+     *
+     * @param other other instance
+     * @return this instance
+     */
+    lzma_decoder& operator=(lzma_decoder&& other) {
+        if (nullptr != strm) {
+            ::lzma_end(strm);
+            std::free(strm);
+        }
+        strm = other.strm;
+        other.strm = nullptr;
+        memlimit = other.memlimit;
+        finished = other.finished;
+        return *this;
+    }
+
+    /**
+     * Decodes as much of the specified input as fits into the specified output
+     *
+     * @param input compressed data
+     * @param output buffer for decompressed data
+     * @return number of bytes consumed and produced, and decoder state
+     * @throws compress_exception on invalid data or if memory limit is exceeded
+     */
+    decode_result decode(sl::io::span<const char> input, sl::io::span<char> output) {
+        if (finished) {
+            return decode_result(0, 0, decode_status::done);
+        }
+        strm->next_in = reinterpret_cast<const uint8_t*> (input.data());
+        strm->avail_in = input.size();
+        strm->next_out = reinterpret_cast<uint8_t*> (output.data());
+        strm->avail_out = output.size();
+        auto err = ::lzma_code(strm, LZMA_RUN);
+        if (LZMA_OK != err && LZMA_STREAM_END != err && LZMA_BUF_ERROR != err) throw compress_exception(TRACEMSG(
+                "LZMA error, code: [" + sl::support::to_string(err) + "]"));
+        size_t consumed = input.size() - strm->avail_in;
+        size_t produced = output.size() - strm->avail_out;
+        if (LZMA_STREAM_END == err) {
+            finished = true;
+            return decode_result(consumed, produced, decode_status::done);
+        }
+        return decode_result(consumed, produced, 0 == strm->avail_out ?
+                decode_status::output_full : decode_status::need_input);
+    }
+
+    /**
+     * Decodes all the specified input passing the decompressed data
+     * to the specified callback in chunks, stack buffer is used for output
+     *
+     * @param input compressed data
+     * @param emit callable that takes "sl::io::span<const char>"
+     * @return number of bytes consumed and produced, status is
+     *         either "need_input" or "done"
+     * @throws compress_exception on invalid data
+     */
+    template <typename Emit>
+    decode_result feed(sl::io::span<const char> input, Emit emit) {
+        return detail::feed_decoder(*this, input, emit);
+    }
+
+    /**
+     * Prepares decoder for the next stream, allocated memory is reused
+     */
+    void reset() {
+        auto err = ::lzma_stream_decoder(strm, memlimit, 0);
+        if (LZMA_OK != err) throw compress_exception(TRACEMSG(
+                "Error resetting LZMA stream, code: [" + sl::support::to_string(err) + "]"));
+        finished = false;
+    }
+
+    /**
+     * Checks whether the end of compressed stream was reached
+     *
+     * @return true if stream is finished
+     */
+    bool is_done() const {
+        return finished;
+    }
+
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_LZMA_DECODER_HPP */
+
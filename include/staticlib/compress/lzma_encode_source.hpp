@@ -0,0 +1,257 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lzma_encode_source.hpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 4:00 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_LZMA_ENCODE_SOURCE_HPP
+#define STATICLIB_COMPRESS_LZMA_ENCODE_SOURCE_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <array>
+#include <ios>
+#include <memory>
+#include <type_traits>
+
+#include "lzma.h"
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/lzma_encode_stream.hpp"
+#include "staticlib/compress/lzma_filter_chain.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Source wrapper that compresses the data read from the underlying
+ * source using LZMA algorithm (XZ format), output is the same as the one
+ * produced by "lzma_sink"
+ */
+template <typename Source, int compression_level = 6, std::size_t buf_size = 4096>
+class lzma_encode_source {
+    /**
+     * Source of uncompressed data
+     */
+    Source src;
+    /**
+     * Internal buffer
+     */
+    std::array<char, buf_size> buf;
+    /**
+     * LZMA compressing stream
+     */
+    lzma_stream* strm;
+    /**
+     * Start position in internal buffer
+     */
+    size_t pos = 0;
+    /**
+     * Number of bytes available in internal buffer
+     */
+    size_t avail = 0;
+    /**
+     * Source EOF flag
+     */
+    bool exhausted = false;
+    /**
+     * End of compressed stream flag
+     */
+    bool finished = false;
+
+public:
+    /**
+     * Constructor, created object will own the specified source
+     *
+     * @param src source to read uncompressed data from
+     */
+    lzma_encode_source(Source src) :
+    src(std::move(src)),
+    strm(detail::lzma_encoder_create(compression_level)) { }
+
+    /**
+     * Constructor, compresses data using the specified filter chain,
+     * "compression_level" template parameter is ignored
+     *
+     * @param src source to read uncompressed data from
+     * @param chain filters and LZMA2 options, is not used after construction
+     */
+    lzma_encode_source(Source src, const lzma_filter_chain& chain) :
+    src(std::move(src)),
+    strm(detail::lzma_encoder_create(chain)) { }
+
+    ~lzma_encode_source() STATICLIB_NOEXCEPT {
+        detail::lzma_encoder_destroy(strm);
+    }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    lzma_encode_source(const lzma_encode_source&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    lzma_encode_source& operator=(const lzma_encode_source&) = delete;
+
+    /**
+     * Move constructor
+     *
+     * @param other other instance
+     */
+    lzma_encode_source(lzma_encode_source&& other) :
+    src(std::move(other.src)),
+    buf(std::move(other.buf)),
+    strm(other.strm),
+    pos(other.pos),
+    avail(other.avail),
+    exhausted(other.exhausted),
+    finished(other.finished) {
+        other.strm = nullptr;
+    }
+
+    /**
+     * Move assignment operator
+     *
+     * @param other other instance
+     * @return this instance
+     */
+    lzma_encode_source& operator=(lzma_encode_source&& other) {
+        src = std::move(other.src);
+        buf = std::move(other.buf);
+        strm = other.strm;
+        other.strm = nullptr;
+        pos = other.pos;
+        avail = other.avail;
+        exhausted = other.exhausted;
+        finished = other.finished;
+        return *this;
+    }
+
+    /**
+     * Read implementation
+     *
+     * @param span output span
+     * @return number of bytes written into specified span
+     */
+    std::streamsize read(sl::io::span<char> span) {
+        while (!finished) {
+            // fill buffer if empty
+            if (0 == avail && !exhausted) {
+                avail = sl::io::read_all(src, {buf.data(), buf.size()});
+                pos = 0;
+                exhausted = avail < buf.size();
+            }
+            size_t read = 0;
+            size_t produced = 0;
+            auto err = detail::lzma_encoder_step(strm, {buf.data() + pos, avail}, span,
+                    exhausted ? LZMA_FINISH : LZMA_RUN, read, produced);
+            pos += read;
+            avail -= read;
+            finished = LZMA_STREAM_END == err;
+            std::streamsize written = static_cast<std::streamsize> (produced);
+            if (written > 0 || 0 == span.size()) {
+                return written;
+            }
+        }
+        return std::char_traits<char>::eof();
+    }
+
+    /**
+     * Underlying source accessor
+     *
+     * @return underlying source reference
+     */
+    Source& get_source() {
+        return src;
+    }
+
+};
+
+/**
+ * Factory function for creating lzma encode sources,
+ * created object will own the specified source
+ *
+ * @param source input source
+ * @return lzma encode source
+ */
+template <typename Source,
+        class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+lzma_encode_source<Source> make_lzma_encode_source(Source&& source) {
+    return lzma_encode_source<Source>(std::move(source));
+}
+
+/**
+ * Factory function for creating lzma encode sources,
+ * created object will NOT own the specified source
+ *
+ * @param source input source
+ * @return lzma encode source
+ */
+template <typename Source>
+lzma_encode_source<sl::io::reference_source<Source>> make_lzma_encode_source(Source& source) {
+    return lzma_encode_source<sl::io::reference_source<Source>> (
+            sl::io::make_reference_source(source));
+}
+
+/**
+ * Factory function for creating lzma encode sources with custom filter chain,
+ * created object will own the specified source
+ *
+ * @param source input source
+ * @param chain filters and LZMA2 options
+ * @return lzma encode source
+ */
+template <typename Source,
+        class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+lzma_encode_source<Source> make_lzma_encode_source(Source&& source, const lzma_filter_chain& chain) {
+    return lzma_encode_source<Source>(std::move(source), chain);
+}
+
+/**
+ * Factory function for creating lzma encode sources with custom filter chain,
+ * created object will NOT own the specified source
+ *
+ * @param source input source
+ * @param chain filters and LZMA2 options
+ * @return lzma encode source
+ */
+template <typename Source>
+lzma_encode_source<sl::io::reference_source<Source>> make_lzma_encode_source(Source& source,
+        const lzma_filter_chain& chain) {
+    return lzma_encode_source<sl::io::reference_source<Source>> (
+            sl::io::make_reference_source(source), chain);
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_LZMA_ENCODE_SOURCE_HPP */
+
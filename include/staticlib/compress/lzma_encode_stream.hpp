@@ -0,0 +1,159 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   lzma_encode_stream.hpp
+ * Author: alex
+ *
+ * Created on October 29, 2026, 4:15 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_LZMA_ENCODE_STREAM_HPP
+#define STATICLIB_COMPRESS_LZMA_ENCODE_STREAM_HPP
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "lzma.h"
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/lzma_filter_chain.hpp"
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+// Stream setup and codec loop shared by "lzma_sink" and "lzma_encode_source"
+
+template <typename Init>
+lzma_stream* lzma_encoder_create_with(Init init) {
+    lzma_stream* stream = static_cast<lzma_stream*> (std::malloc(sizeof(lzma_stream)));
+    if (nullptr == stream) throw compress_exception(TRACEMSG(
+            "Error creating lzma stream: 'malloc' failed"));
+    *stream = LZMA_STREAM_INIT;
+    auto err = init(stream);
+    if (LZMA_OK != err) {
+        ::lzma_end(stream);
+        std::free(stream);
+        throw compress_exception(TRACEMSG(
+                "Error initializing LZMA stream, code: [" + sl::support::to_string(err) + "]"));
+    }
+    return stream;
+}
+
+/**
+ * Allocates and initializes XZ compressing stream with the preset settings
+ *
+ * @param level compression level (preset)
+ * @return initialized stream, must be released with "lzma_encoder_destroy"
+ */
+inline lzma_stream* lzma_encoder_create(int level) {
+    return lzma_encoder_create_with([level](lzma_stream* stream) {
+        return ::lzma_easy_encoder(stream, static_cast<uint32_t>(level), LZMA_CHECK_CRC64);
+    });
+}
+
+/**
+ * Allocates and initializes XZ compressing stream with the specified filter chain
+ *
+ * @param chain filters and LZMA2 options, is not used after the call
+ * @return initialized stream, must be released with "lzma_encoder_destroy"
+ */
+inline lzma_stream* lzma_encoder_create(const lzma_filter_chain& chain) {
+    return lzma_encoder_create_with([&chain](lzma_stream* stream) {
+        auto filters = chain.get_filters();
+        return ::lzma_stream_encoder(stream, filters.data(), LZMA_CHECK_CRC64);
+    });
+}
+
+/**
+ * Releases stream created with "lzma_encoder_create"
+ *
+ * @param strm stream, may be null
+ */
+inline void lzma_encoder_destroy(lzma_stream* strm) STATICLIB_NOEXCEPT {
+    if (nullptr == strm) return;
+    ::lzma_end(strm);
+    std::free(strm);
+}
+
+/**
+ * Single "lzma_code" call
+ *
+ * @param strm stream
+ * @param input input data
+ * @param out output buffer
+ * @param action liblzma action
+ * @param consumed number of input bytes consumed
+ * @param produced number of output bytes produced
+ * @return LZMA_OK or LZMA_STREAM_END
+ */
+inline lzma_ret lzma_encoder_step(lzma_stream* strm, sl::io::span<const char> input, sl::io::span<char> out,
+        lzma_action action, size_t& consumed, size_t& produced) {
+    strm->next_in = reinterpret_cast<const uint8_t*> (input.data());
+    strm->avail_in = input.size();
+    strm->next_out = reinterpret_cast<uint8_t*> (out.data());
+    strm->avail_out = out.size();
+    auto err = ::lzma_code(strm, action);
+    if (LZMA_OK != err && LZMA_STREAM_END != err) throw compress_exception(TRACEMSG(
+            "LZMA error code: [" + sl::support::to_string(err) + "]"));
+    consumed = input.size() - strm->avail_in;
+    produced = out.size() - strm->avail_out;
+    return err;
+}
+
+/**
+ * Compresses all the specified input through the specified buffer, passes
+ * every filled part of the buffer to "emit" callback. With LZMA_RUN returns
+ * once all input is consumed, with other actions - once liblzma reports
+ * that the flush or the stream is completed.
+ *
+ * @param strm stream
+ * @param input input data, may be empty
+ * @param buf output buffer
+ * @param action liblzma action
+ * @param emit callback that takes "sl::io::span<const char>" with compressed data
+ */
+template <typename Emit>
+void lzma_encoder_pump(lzma_stream* strm, sl::io::span<const char> input, sl::io::span<char> buf,
+        lzma_action action, Emit emit) {
+    size_t pos = 0;
+    for (;;) {
+        size_t consumed = 0;
+        size_t produced = 0;
+        auto err = lzma_encoder_step(strm, {input.data() + pos, input.size() - pos}, buf,
+                action, consumed, produced);
+        pos += consumed;
+        if (produced > 0) {
+            emit(sl::io::span<const char>(buf.data(), produced));
+        }
+        if (LZMA_STREAM_END == err) break;
+        if (LZMA_RUN == action && pos == input.size()) break;
+    }
+}
+
+} // namespace
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_LZMA_ENCODE_STREAM_HPP */
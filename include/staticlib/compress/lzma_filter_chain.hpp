@@ -0,0 +1,224 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lzma_filter_chain.hpp
+ * Author: alex
+ *
+ * Created on October 20, 2026, 1:15 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_LZMA_FILTER_CHAIN_HPP
+#define STATICLIB_COMPRESS_LZMA_FILTER_CHAIN_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "lzma.h"
+
+#include "staticlib/config.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * LZMA2 compression modes
+ */
+enum class lzma2_mode {
+    fast = LZMA_MODE_FAST,
+    normal = LZMA_MODE_NORMAL
+};
+
+/**
+ * LZMA2 match finders
+ */
+enum class lzma2_match_finder {
+    hc3 = LZMA_MF_HC3,
+    hc4 = LZMA_MF_HC4,
+    bt2 = LZMA_MF_BT2,
+    bt3 = LZMA_MF_BT3,
+    bt4 = LZMA_MF_BT4
+};
+
+/**
+ * Filter chain configuration for "lzma_sink": optional BCJ and Delta
+ * filters followed by LZMA2 with custom options. Filter IDs and options
+ * are stored in the XZ block headers, so streams created with any chain
+ * are decoded by "lzma_source" without additional configuration.
+ */
+class lzma_filter_chain {
+    struct stage {
+        lzma_vli id;
+        lzma_options_delta delta;
+    };
+
+    std::vector<stage> stages;
+    lzma_options_lzma lzma2;
+
+public:
+    /**
+     * Constructor, LZMA2 options are initialized from the specified preset
+     *
+     * @param preset LZMA compression level (0-9), may be combined with "LZMA_PRESET_EXTREME"
+     */
+    explicit lzma_filter_chain(uint32_t preset = 6) {
+        std::memset(std::addressof(lzma2), 0, sizeof(lzma2));
+        if (::lzma_lzma_preset(std::addressof(lzma2), preset)) throw compress_exception(TRACEMSG(
+                "Unsupported LZMA preset: [" + sl::support::to_string(preset) + "]"));
+    }
+
+    /**
+     * Appends x86 BCJ filter, that improves compression of x86 and x86-64 executables
+     *
+     * @return this instance
+     */
+    lzma_filter_chain& add_x86() {
+        return add_stage(LZMA_FILTER_X86);
+    }
+
+    /**
+     * Appends ARM64 BCJ filter, that improves compression of ARM64 executables,
+     * requires liblzma 5.4 or later
+     *
+     * @return this instance
+     */
+    lzma_filter_chain& add_arm64() {
+#ifdef LZMA_FILTER_ARM64
+        return add_stage(LZMA_FILTER_ARM64);
+#else
+        throw compress_exception(TRACEMSG(
+                "ARM64 BCJ filter is not supported by this version of liblzma"));
+#endif // LZMA_FILTER_ARM64
+    }
+
+    /**
+     * Appends Delta filter, that improves compression of tables with fixed-width records
+     *
+     * @param distance distance in bytes between the compared values (record width), 1-256
+     * @return this instance
+     */
+    lzma_filter_chain& add_delta(uint32_t distance) {
+        if (distance < LZMA_DELTA_DIST_MIN || distance > LZMA_DELTA_DIST_MAX) throw compress_exception(TRACEMSG(
+                "Invalid Delta distance: [" + sl::support::to_string(distance) + "]"));
+        add_stage(LZMA_FILTER_DELTA);
+        stages.back().delta.type = LZMA_DELTA_TYPE_BYTE;
+        stages.back().delta.dist = distance;
+        return *this;
+    }
+
+    /**
+     * Sets LZMA2 dictionary size
+     *
+     * @param size dictionary size in bytes, at least 4096
+     * @return this instance
+     */
+    lzma_filter_chain& set_dict_size(uint32_t size) {
+        if (size < LZMA_DICT_SIZE_MIN) throw compress_exception(TRACEMSG(
+                "Invalid LZMA2 dictionary size: [" + sl::support::to_string(size) + "]"));
+        lzma2.dict_size = size;
+        return *this;
+    }
+
+    /**
+     * Sets LZMA2 nice length of a match
+     *
+     * @param len nice length, 2-273
+     * @return this instance
+     */
+    lzma_filter_chain& set_nice_len(uint32_t len) {
+        if (len < 2 || len > 273) throw compress_exception(TRACEMSG(
+                "Invalid LZMA2 nice length: [" + sl::support::to_string(len) + "]"));
+        lzma2.nice_len = len;
+        return *this;
+    }
+
+    /**
+     * Sets LZMA2 compression mode
+     *
+     * @param mode compression mode
+     * @return this instance
+     */
+    lzma_filter_chain& set_mode(lzma2_mode mode) {
+        lzma2.mode = static_cast<lzma_mode>(mode);
+        return *this;
+    }
+
+    /**
+     * Sets LZMA2 match finder
+     *
+     * @param finder match finder
+     * @return this instance
+     */
+    lzma_filter_chain& set_match_finder(lzma2_match_finder finder) {
+        auto mf = static_cast<lzma_match_finder>(finder);
+        if (!::lzma_mf_is_supported(mf)) throw compress_exception(TRACEMSG(
+                "Unsupported LZMA2 match finder: [" + sl::support::to_string(static_cast<int>(mf)) + "]"));
+        lzma2.mf = mf;
+        return *this;
+    }
+
+    /**
+     * Returns the LZMA_VLI_UNKNOWN-terminated filters array to pass
+     * to liblzma, returned array points to the options stored in this instance
+     * and must not outlive it; liblzma copies options on encoder initialization
+     *
+     * @return filters array
+     */
+    std::vector<lzma_filter> get_filters() const {
+        auto res = std::vector<lzma_filter>();
+        for (const stage& st : stages) {
+            lzma_filter fi;
+            fi.id = st.id;
+            // options are not modified by encoder
+            fi.options = LZMA_FILTER_DELTA == st.id ?
+                    const_cast<lzma_options_delta*>(std::addressof(st.delta)) : nullptr;
+            res.push_back(fi);
+        }
+        lzma_filter last;
+        last.id = LZMA_FILTER_LZMA2;
+        last.options = const_cast<lzma_options_lzma*>(std::addressof(lzma2));
+        res.push_back(last);
+        lzma_filter term;
+        term.id = LZMA_VLI_UNKNOWN;
+        term.options = nullptr;
+        res.push_back(term);
+        return res;
+    }
+
+private:
+    lzma_filter_chain& add_stage(lzma_vli id) {
+        // LZMA2 is always the last one
+        if (stages.size() + 1 >= LZMA_FILTERS_MAX) throw compress_exception(TRACEMSG(
+                "Too many filters in chain, max: [" + sl::support::to_string(LZMA_FILTERS_MAX - 1) + "]"));
+        stage st;
+        std::memset(std::addressof(st), 0, sizeof(st));
+        st.id = id;
+        stages.push_back(st);
+        return *this;
+    }
+
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_LZMA_FILTER_CHAIN_HPP */
+
@@ -0,0 +1,565 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lzma_seekable_source.hpp
+ * Author: alex
+ *
+ * Created on October 20, 2026, 10:40 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_LZMA_SEEKABLE_SOURCE_HPP
+#define STATICLIB_COMPRESS_LZMA_SEEKABLE_SOURCE_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <ios>
+#include <list>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lzma.h"
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/seekable.hpp"
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+/**
+ * Default size of decoded windows kept in cache
+ */
+const size_t xz_window_size = 1 << 20;
+
+/**
+ * Default memory limit for a block decoder, enough for all "xz" presets
+ */
+const uint64_t xz_memory_limit = 1 << 28;
+
+/**
+ * Size of the buffer for compressed data
+ */
+const size_t xz_cursor_buffer_size = 1 << 16;
+
+/**
+ * Streaming decoder of a single XZ block, keeps the position in uncompressed
+ * data so sequential reads continue decoding instead of restarting the block.
+ * Is allocated on heap, because liblzma keeps pointers to "block" member.
+ */
+class xz_block_cursor {
+public:
+    lzma_stream strm;
+    lzma_block block;
+    std::array<lzma_filter, LZMA_FILTERS_MAX + 1> filters;
+    std::array<uint8_t, xz_cursor_buffer_size> buf;
+    uint64_t in_offset = 0;
+    uint64_t in_end = 0;
+    uint64_t block_start = 0;
+    uint64_t block_end = 0;
+    uint64_t out_pos = 0;
+
+    xz_block_cursor() :
+    strm(LZMA_STREAM_INIT) {
+        std::memset(std::addressof(block), 0, sizeof(block));
+        filters[0].id = LZMA_VLI_UNKNOWN;
+        filters[0].options = nullptr;
+    }
+
+    ~xz_block_cursor() STATICLIB_NOEXCEPT {
+        ::lzma_end(std::addressof(strm));
+        for (lzma_filter& fi : filters) {
+            if (LZMA_VLI_UNKNOWN == fi.id) break;
+            std::free(fi.options);
+        }
+    }
+
+    xz_block_cursor(const xz_block_cursor&) = delete;
+
+    xz_block_cursor& operator=(const xz_block_cursor&) = delete;
+};
+
+} // namespace
+
+/**
+ * Source that allows random access to the XZ data stored in a seekable source.
+ * Index of XZ blocks is read from the end of the file on construction,
+ * on reads only the block that contains the requested position is decoded.
+ * Blocks are decoded in a streaming mode, only a fixed-size window of
+ * uncompressed data around the requested position is kept, so memory usage
+ * does not depend on the block size. Recently decoded windows are kept
+ * in a small LRU cache, sequential reads continue decoding of the current
+ * block instead of restarting it. Random access is efficient only for
+ * files with multiple blocks (created with "xz --block-size" or "xz -T"),
+ * concatenated XZ streams are supported.
+ */
+template <typename Source>
+class lzma_seekable_source {
+    /**
+     * Seekable source of compressed data
+     */
+    Source src;
+    /**
+     * Combined index of all streams in file
+     */
+    lzma_index* index;
+    /**
+     * Current position in uncompressed data
+     */
+    uint64_t pos = 0;
+    /**
+     * Max number of decoded windows in cache
+     */
+    size_t cache_size;
+    /**
+     * Max size of decoded window
+     */
+    size_t window_size;
+    /**
+     * Max memory usage of the block decoder
+     */
+    uint64_t memory_limit;
+    /**
+     * Decoded windows, most recently used go first
+     */
+    std::list<std::pair<uint64_t, std::string>> cache;
+    /**
+     * Decoder of the most recently accessed block
+     */
+    std::unique_ptr<detail::xz_block_cursor> cursor;
+
+public:
+    /**
+     * Constructor, created object will own the specified source
+     *
+     * @param src seekable source to read compressed data from
+     * @param cache_size max number of decoded windows to keep in memory
+     * @param window_size max size of decoded window
+     * @param memory_limit max memory usage of the block decoder (mostly defined
+     *        by the dictionary size used for compression), blocks that require
+     *        more memory are rejected
+     */
+    lzma_seekable_source(Source&& src, size_t cache_size = 4,
+            size_t window_size = detail::xz_window_size,
+            uint64_t memory_limit = detail::xz_memory_limit) :
+    src(std::move(src)),
+    index(nullptr),
+    cache_size(std::max(cache_size, static_cast<size_t>(1))),
+    window_size(std::max(window_size, static_cast<size_t>(1))),
+    memory_limit(memory_limit) {
+        index = read_index(this->src);
+    }
+
+    ~lzma_seekable_source() STATICLIB_NOEXCEPT {
+        if (nullptr == index) return;
+        ::lzma_index_end(index, nullptr);
+    }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    lzma_seekable_source(const lzma_seekable_source&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    lzma_seekable_source& operator=(const lzma_seekable_source&) = delete;
+
+    /**
+     * Move constructor
+     *
+     * @param other other instance
+     */
+    lzma_seekable_source(lzma_seekable_source&& other) :
+    src(std::move(other.src)),
+    index(other.index),
+    pos(other.pos),
+    cache_size(other.cache_size),
+    window_size(other.window_size),
+    memory_limit(other.memory_limit),
+    cache(std::move(other.cache)),
+    cursor(std::move(other.cursor)) {
+        other.index = nullptr;
+    }
+
+    /**
+     * Move assignment operator
+     *
+     * @param other other instance
+     * @return this instance
+     */
+    lzma_seekable_source& operator=(lzma_seekable_source&& other) {
+        if (nullptr != index) {
+            ::lzma_index_end(index, nullptr);
+        }
+        src = std::move(other.src);
+        index = other.index;
+        other.index = nullptr;
+        pos = other.pos;
+        cache_size = other.cache_size;
+        window_size = other.window_size;
+        memory_limit = other.memory_limit;
+        cache = std::move(other.cache);
+        cursor = std::move(other.cursor);
+        return *this;
+    }
+
+    /**
+     * Read implementation
+     *
+     * @param span output span
+     * @return number of bytes written into specified span
+     */
+    std::streamsize read(sl::io::span<char> span) {
+        if (pos >= size()) return std::char_traits<char>::eof();
+        const std::pair<uint64_t, std::string>& window = find_window(pos);
+        size_t offset = static_cast<size_t>(pos - window.first);
+        size_t len = std::min(span.size(), window.second.length() - offset);
+        std::memcpy(span.data(), window.second.data() + offset, len);
+        pos += len;
+        return static_cast<std::streamsize>(len);
+    }
+
+    /**
+     * Seek implementation, sets position in uncompressed data
+     *
+     * @param offset offset to seek with
+     * @param whence one of 'b' (begin), 'c' (current) or 'e' (end)
+     * @return new position
+     */
+    std::streampos seek(std::streamsize offset, char whence = 'b') {
+        int64_t base = 0;
+        switch (whence) {
+        case 'b': base = 0; break;
+        case 'c': base = static_cast<int64_t>(pos); break;
+        case 'e': base = static_cast<int64_t>(size()); break;
+        default: throw compress_exception(TRACEMSG(
+                "Invalid seek whence: [" + std::string(1, whence) + "]"));
+        }
+        int64_t target = base + static_cast<int64_t>(offset);
+        if (target < 0) throw compress_exception(TRACEMSG(
+                "Invalid seek offset: [" + sl::support::to_string(offset) + "]"));
+        pos = static_cast<uint64_t>(target);
+        return static_cast<std::streampos>(static_cast<std::streamoff>(pos));
+    }
+
+    /**
+     * Reads data at the specified position in uncompressed data,
+     * current position is moved after the data read
+     *
+     * @param offset position in uncompressed data
+     * @param span output span
+     * @return number of bytes read, less than span size only at the end of data
+     */
+    size_t read_at(uint64_t offset, sl::io::span<char> span) {
+        seek(static_cast<std::streamsize>(offset));
+        return sl::io::read_all(*this, span);
+    }
+
+    /**
+     * Uncompressed size accessor
+     *
+     * @return total size of uncompressed data
+     */
+    uint64_t size() const {
+        return ::lzma_index_uncompressed_size(index);
+    }
+
+    /**
+     * Number of blocks accessor
+     *
+     * @return number of XZ blocks in all streams
+     */
+    uint64_t blocks_count() const {
+        return ::lzma_index_block_count(index);
+    }
+
+    /**
+     * Underlying source accessor
+     *
+     * @return underlying source reference
+     */
+    Source& get_source() {
+        return src;
+    }
+
+private:
+    static lzma_index* read_index(Source& src) {
+        lzma_index* combined = nullptr;
+        auto deferred = sl::support::defer([&combined]() STATICLIB_NOEXCEPT {
+            if (nullptr != combined) {
+                ::lzma_index_end(combined, nullptr);
+            }
+        });
+        uint64_t stream_end = detail::seek_to(src, 0, 'e');
+        // streams are read from the last one
+        while (stream_end > 0) {
+            // stream padding
+            auto footer = std::array<uint8_t, LZMA_STREAM_HEADER_SIZE>();
+            uint64_t padding = 0;
+            for (;;) {
+                if (stream_end < 2 * LZMA_STREAM_HEADER_SIZE) throw compress_exception(TRACEMSG(
+                        "Invalid XZ file: stream footer not found"));
+                read_at(src, stream_end - LZMA_STREAM_HEADER_SIZE, footer.data(), footer.size());
+                if (0 != footer[8] || 0 != footer[9] || 0 != footer[10] || 0 != footer[11]) break;
+                stream_end -= 4;
+                padding += 4;
+            }
+            lzma_stream_flags flags;
+            auto err = ::lzma_stream_footer_decode(std::addressof(flags), footer.data());
+            check_lzma(err, "Invalid XZ stream footer");
+            uint64_t footer_pos = stream_end - LZMA_STREAM_HEADER_SIZE;
+            if (footer_pos < flags.backward_size + LZMA_STREAM_HEADER_SIZE) throw compress_exception(TRACEMSG(
+                    "Invalid XZ index size: [" + sl::support::to_string(flags.backward_size) + "]"));
+
+            // index
+            auto buf = std::vector<uint8_t>();
+            buf.resize(static_cast<size_t>(flags.backward_size));
+            read_at(src, footer_pos - flags.backward_size, buf.data(), buf.size());
+            lzma_index* idx = nullptr;
+            uint64_t memlimit = UINT64_MAX;
+            size_t in_pos = 0;
+            err = ::lzma_index_buffer_decode(std::addressof(idx), std::addressof(memlimit), nullptr,
+                    buf.data(), std::addressof(in_pos), buf.size());
+            check_lzma(err, "Invalid XZ index");
+            err = ::lzma_index_stream_flags(idx, std::addressof(flags));
+            if (LZMA_OK == err) {
+                err = ::lzma_index_stream_padding(idx, padding);
+            }
+            uint64_t stream_size = ::lzma_index_stream_size(idx);
+            if (LZMA_OK == err && stream_size > stream_end) {
+                err = LZMA_DATA_ERROR;
+            }
+            if (LZMA_OK == err && nullptr != combined) {
+                err = ::lzma_index_cat(idx, combined, nullptr);
+                if (LZMA_OK == err) {
+                    // now owned by idx
+                    combined = nullptr;
+                }
+            }
+            if (LZMA_OK != err) {
+                ::lzma_index_end(idx, nullptr);
+            }
+            check_lzma(err, "Invalid XZ stream");
+            combined = idx;
+            stream_end -= stream_size;
+        }
+        if (nullptr == combined) throw compress_exception(TRACEMSG(
+                "Invalid XZ file: no streams found"));
+        lzma_index* res = combined;
+        combined = nullptr;
+        return res;
+    }
+
+    const std::pair<uint64_t, std::string>& find_window(uint64_t offset) {
+        for (auto it = cache.begin(); it != cache.end(); ++it) {
+            if (offset >= it->first && offset < it->first + it->second.length()) {
+                if (cache.begin() != it) {
+                    cache.splice(cache.begin(), cache, it);
+                }
+                return cache.front();
+            }
+        }
+        lzma_index_iter iter;
+        ::lzma_index_iter_init(std::addressof(iter), index);
+        if (::lzma_index_iter_locate(std::addressof(iter), offset)) throw compress_exception(TRACEMSG(
+                "Invalid XZ offset: [" + sl::support::to_string(offset) + "]"));
+        // windows are aligned to block start and do not cross block boundaries
+        uint64_t block_start = iter.block.uncompressed_file_offset;
+        uint64_t block_end = block_start + iter.block.uncompressed_size;
+        uint64_t start = block_start + (offset - block_start) / window_size * window_size;
+        auto data = std::string();
+        if (cache.size() >= cache_size) {
+            // reuse evicted window memory
+            data = std::move(cache.back().second);
+            cache.pop_back();
+        }
+        data.resize(static_cast<size_t>(std::min(static_cast<uint64_t>(window_size), block_end - start)));
+        decode_window(iter, start, data);
+        cache.emplace_front(start, std::move(data));
+        return cache.front();
+    }
+
+    void decode_window(const lzma_index_iter& iter, uint64_t start, std::string& data) {
+        if (nullptr == cursor.get() || iter.block.uncompressed_file_offset != cursor->block_start ||
+                start < cursor->out_pos) {
+            open_block(iter);
+        }
+        uint8_t* out = reinterpret_cast<uint8_t*>(std::addressof(data.front()));
+        try {
+            // data before the window is decoded into the window buffer and discarded
+            while (cursor->out_pos < start) {
+                size_t len = static_cast<size_t>(std::min(static_cast<uint64_t>(data.length()), start - cursor->out_pos));
+                decode_next(out, len);
+            }
+            decode_next(out, data.length());
+            if (cursor->block_end == cursor->out_pos) {
+                finish_block();
+            }
+        } catch (...) {
+            // decoder state is undefined after error
+            cursor.reset();
+            throw;
+        }
+    }
+
+    void open_block(const lzma_index_iter& iter) {
+        // release previous decoder before allocating new one
+        cursor.reset();
+        auto cur = std::unique_ptr<detail::xz_block_cursor>(new detail::xz_block_cursor());
+        uint64_t offset = iter.block.compressed_file_offset;
+        uint8_t* header = cur->buf.data();
+        read_at(src, offset, header, 1);
+        lzma_block& block = cur->block;
+        block.version = 0;
+        block.check = iter.stream.flags->check;
+        block.filters = cur->filters.data();
+        block.header_size = lzma_block_header_size_decode(header[0]);
+        read_at(src, offset + 1, header + 1, block.header_size - 1);
+        auto err = ::lzma_block_header_decode(std::addressof(block), nullptr, header);
+        check_lzma(err, "Invalid XZ block header");
+        err = ::lzma_block_compressed_size(std::addressof(block), iter.block.unpadded_size);
+        check_lzma(err, "Invalid XZ block size");
+        uint64_t memusage = ::lzma_raw_decoder_memusage(cur->filters.data());
+        if (memusage > memory_limit) throw compress_exception(TRACEMSG(
+                "XZ block decoder memory limit exceeded," +
+                " block offset: [" + sl::support::to_string(iter.block.uncompressed_file_offset) + "]," +
+                " required: [" + sl::support::to_string(memusage) + "]," +
+                " limit: [" + sl::support::to_string(memory_limit) + "]"));
+        err = ::lzma_block_decoder(std::addressof(cur->strm), std::addressof(block));
+        check_lzma(err, "Error initializing XZ block decoder");
+        cur->in_offset = offset + block.header_size;
+        cur->in_end = offset + iter.block.total_size;
+        cur->block_start = iter.block.uncompressed_file_offset;
+        cur->block_end = cur->block_start + iter.block.uncompressed_size;
+        cur->out_pos = cur->block_start;
+        cursor = std::move(cur);
+    }
+
+    void decode_next(uint8_t* out, size_t len) {
+        lzma_stream& strm = cursor->strm;
+        strm.next_out = out;
+        strm.avail_out = len;
+        while (strm.avail_out > 0) {
+            fill_input();
+            auto err = ::lzma_code(std::addressof(strm), LZMA_RUN);
+            if (LZMA_STREAM_END == err) break;
+            check_lzma(err, "XZ block decoding error");
+        }
+        size_t produced = len - strm.avail_out;
+        cursor->out_pos += produced;
+        if (produced < len) throw compress_exception(TRACEMSG(
+                "XZ block is shorter than recorded in index," +
+                " block offset: [" + sl::support::to_string(cursor->block_start) + "]"));
+    }
+
+    void finish_block() {
+        // consumes block padding and checks integrity
+        lzma_stream& strm = cursor->strm;
+        uint8_t extra = 0;
+        strm.next_out = std::addressof(extra);
+        strm.avail_out = 1;
+        for (;;) {
+            fill_input();
+            auto err = ::lzma_code(std::addressof(strm), LZMA_RUN);
+            if (LZMA_STREAM_END == err) break;
+            check_lzma(err, "XZ block decoding error");
+            if (0 == strm.avail_out) throw compress_exception(TRACEMSG(
+                    "XZ block is longer than recorded in index," +
+                    " block offset: [" + sl::support::to_string(cursor->block_start) + "]"));
+        }
+        cursor.reset();
+    }
+
+    void fill_input() {
+        detail::xz_block_cursor& cur = *cursor;
+        if (cur.strm.avail_in > 0 || cur.in_offset >= cur.in_end) return;
+        size_t len = static_cast<size_t>(std::min(static_cast<uint64_t>(cur.buf.size()), cur.in_end - cur.in_offset));
+        read_at(src, cur.in_offset, cur.buf.data(), len);
+        cur.in_offset += len;
+        cur.strm.next_in = cur.buf.data();
+        cur.strm.avail_in = len;
+    }
+
+    template <typename Src>
+    static void read_at(Src& src, uint64_t offset, uint8_t* data, size_t len) {
+        detail::seek_to(src, static_cast<int64_t>(offset));
+        sl::io::read_exact(src, {reinterpret_cast<char*>(data), len});
+    }
+
+    static void check_lzma(lzma_ret err, const std::string& msg) {
+        if (LZMA_OK != err) throw compress_exception(TRACEMSG(
+                msg + ", code: [" + sl::support::to_string(err) + "]"));
+    }
+
+};
+
+/**
+ * Factory function for creating seekable lzma sources,
+ * created object will own the specified source
+ *
+ * @param source seekable input source
+ * @param cache_size max number of decoded windows to keep in memory
+ * @param window_size max size of decoded window
+ * @param memory_limit max memory usage of the block decoder
+ * @return seekable lzma source
+ */
+template <typename Source,
+class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+lzma_seekable_source<Source> make_lzma_seekable_source(Source&& source, size_t cache_size = 4,
+        size_t window_size = detail::xz_window_size, uint64_t memory_limit = detail::xz_memory_limit) {
+    return lzma_seekable_source<Source>(std::move(source), cache_size, window_size, memory_limit);
+}
+
+/**
+ * Factory function for creating seekable lzma sources,
+ * created object will NOT own the specified source
+ *
+ * @param source seekable input source
+ * @param cache_size max number of decoded windows to keep in memory
+ * @param window_size max size of decoded window
+ * @param memory_limit max memory usage of the block decoder
+ * @return seekable lzma source
+ */
+template <typename Source>
+lzma_seekable_source<sl::io::reference_source<Source>> make_lzma_seekable_source(Source& source,
+        size_t cache_size = 4, size_t window_size = detail::xz_window_size,
+        uint64_t memory_limit = detail::xz_memory_limit) {
+    return lzma_seekable_source<sl::io::reference_source<Source>> (
+            sl::io::make_reference_source(source), cache_size, window_size, memory_limit);
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_LZMA_SEEKABLE_SOURCE_HPP */
+
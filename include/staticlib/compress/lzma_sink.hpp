@@ -38,6 +38,8 @@
 #include "staticlib/support.hpp"
 
 #include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/lzma_encode_stream.hpp"
+#include "staticlib/compress/lzma_filter_chain.hpp"
 
 namespace staticlib {
 namespace compress {
@@ -69,52 +71,32 @@ public:
      */
     lzma_sink(Sink&& sink) :
     sink(std::move(sink)),
-    strm([] {
-        lzma_stream* stream = static_cast<lzma_stream*> (std::malloc(sizeof(lzma_stream)));
-        if (nullptr == stream) throw compress_exception(TRACEMSG(
-                "Error creating lzma stream: 'malloc' failed"));
-        *stream = LZMA_STREAM_INIT;
-        auto err = ::lzma_easy_encoder(stream, compression_level, LZMA_CHECK_CRC64);
-        if (LZMA_OK != err) throw compress_exception(TRACEMSG(
-                "Error initializing LZMA stream, code: [" + sl::support::to_string(err) + "]"));
-        return stream;
-    }()) { }
+    strm(detail::lzma_encoder_create(compression_level)) { }
+
+    /**
+     * Constructor, compresses data using the specified filter chain,
+     * "compression_level" template parameter is ignored
+     * 
+     * @param sink destination to write compressed data into
+     * @param chain filters and LZMA2 options, is not used after construction
+     */
+    lzma_sink(Sink&& sink, const lzma_filter_chain& chain) :
+    sink(std::move(sink)),
+    strm(detail::lzma_encoder_create(chain)) { }
 
     ~lzma_sink() STATICLIB_NOEXCEPT {
         if (nullptr == strm) return;
         auto deferred = sl::support::defer([this]() STATICLIB_NOEXCEPT {
-            ::lzma_end(this->strm);
-            ::free(this->strm);
+            detail::lzma_encoder_destroy(this->strm);
         });
         // finish encoding
-        strm->next_in = nullptr;
-        strm->avail_in = 0;
-        strm->next_out = reinterpret_cast<uint8_t*>(buf.data());
-        strm->avail_out = buf.size();
-        // call code
-        bool coding = true;
-        while (coding) {
-            auto err = ::lzma_code(strm, LZMA_FINISH);
-            switch (err) {
-            case LZMA_OK:
-                if (strm->avail_out < buf.size()) {
-                    sl::io::write_all(sink, {buf.data(), buf.size() - strm->avail_out});
-                    strm->next_out = reinterpret_cast<uint8_t*>(buf.data());
-                    strm->avail_out = buf.size();
-                }
-                // not finished
-                break;
-            case LZMA_STREAM_END:
-                if (strm->avail_out < buf.size()) {
-                    sl::io::write_all(sink, {buf.data(), buf.size() - strm->avail_out});
-                }
-                // finished
-                coding = false;
-                break;
-            default:
-                // finish
-                coding = false;
-            }
+        try {
+            detail::lzma_encoder_pump(strm, {nullptr, 0}, {buf.data(), buf.size()}, LZMA_FINISH,
+                    [this](sl::io::span<const char> out) {
+                        sl::io::write_all(this->sink, out);
+                    });
+        } catch(...) {
+            // cannot report any error safely - we are in destructor
         }
     }
 
@@ -166,26 +148,10 @@ public:
      * @return number of bytes processed (read from source span)
      */
     std::streamsize write(sl::io::span<const char> span) {
-        // prepare lzma stream
-        strm->next_in = reinterpret_cast<const uint8_t*>(span.data());
-        strm->avail_in = static_cast<size_t> (span.size());
-        strm->next_out = reinterpret_cast<uint8_t*>(buf.data());
-        strm->avail_out = buf.size();
-        // call code
-        while (strm->avail_in > 0) {
-            auto err = ::lzma_code(strm, LZMA_RUN);
-            switch (err) {
-            case LZMA_OK:
-                if (strm->avail_out < buf.size()) {
-                    sl::io::write_all(sink, {buf.data(), buf.size() - strm->avail_out});
-                    strm->next_out = reinterpret_cast<uint8_t*>(buf.data());
-                    strm->avail_out = buf.size();
-                }
-                break;
-            default: throw compress_exception(TRACEMSG(
-                        "LZMA error code: [" + sl::support::to_string(err) + "]"));
-            }
-        }
+        detail::lzma_encoder_pump(strm, span, {buf.data(), buf.size()}, LZMA_RUN,
+                [this](sl::io::span<const char> out) {
+                    sl::io::write_all(this->sink, out);
+                });
         return span.size_signed();
     }
 
@@ -208,6 +174,7 @@ public:
     Sink& get_sink() {
         return sink;
     }
+
 };
 
 /**
@@ -236,6 +203,34 @@ lzma_sink<sl::io::reference_sink<Sink>> make_lzma_sink(Sink& sink) {
             sl::io::make_reference_sink(sink));
 }
 
+/**
+ * Factory function for creating lzma sinks with custom filter chain,
+ * created object will own the specified sink
+ * 
+ * @param sink output sink
+ * @param chain filters and LZMA2 options
+ * @return lzma sink
+ */
+template <typename Sink,
+        class = typename std::enable_if<!std::is_lvalue_reference<Sink>::value>::type>
+lzma_sink<Sink> make_lzma_sink(Sink&& sink, const lzma_filter_chain& chain) {
+    return lzma_sink<Sink>(std::move(sink), chain);
+}
+
+/**
+ * Factory function for creating lzma sinks with custom filter chain,
+ * created object will NOT own the specified sink
+ * 
+ * @param sink output sink
+ * @param chain filters and LZMA2 options
+ * @return lzma sink
+ */
+template <typename Sink>
+lzma_sink<sl::io::reference_sink<Sink>> make_lzma_sink(Sink& sink, const lzma_filter_chain& chain) {
+    return lzma_sink<sl::io::reference_sink<Sink>> (
+            sl::io::make_reference_sink(sink), chain);
+}
+
 } // namespace
 }
 
@@ -0,0 +1,417 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   parallel_inflate_source.hpp
+ * Author: alex
+ *
+ * Created on October 23, 2026, 2:15 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_PARALLEL_INFLATE_SOURCE_HPP
+#define STATICLIB_COMPRESS_PARALLEL_INFLATE_SOURCE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <ios>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/inflate_decoder.hpp"
+#include "staticlib/compress/speculative_inflater.hpp"
+#include "staticlib/compress/worker_pool.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Source wrapper that decompresses a single raw Deflate stream using
+ * multiple threads. Compressed data is read in batches, a batch is split
+ * into chunks, for every chunk except the first one a block boundary is
+ * searched for and chunks are decoded in parallel with unresolved
+ * back-references to the preceding data. Boundaries are then confirmed
+ * in order (previous chunk must end exactly where the next one starts),
+ * back-references are resolved and the output is assembled.
+ * If speculation fails, or the blocks are too big for the batch, the rest
+ * of the stream is decoded sequentially with zlib.
+ * Output is the same as the one of "inflate_source".
+ */
+template <typename Source>
+class parallel_inflate_source {
+    /**
+     * Source of compressed data
+     */
+    Source src;
+    /**
+     * Number of threads to use
+     */
+    size_t threads;
+    /**
+     * Size of compressed data for one thread
+     */
+    size_t chunk_size;
+    /**
+     * Compressed data of the current batch
+     */
+    std::string input;
+    /**
+     * Bit position of the next block in input
+     */
+    uint64_t input_bit = 0;
+    /**
+     * Source EOF flag
+     */
+    bool exhausted = false;
+    /**
+     * Last 32KB of decompressed data
+     */
+    std::string window;
+    /**
+     * Decompressed data of the current batch
+     */
+    std::string output;
+    /**
+     * Read position in output
+     */
+    size_t output_pos = 0;
+    /**
+     * End of stream flag
+     */
+    bool finished = false;
+    /**
+     * Sequential decoder, created when speculation fails
+     */
+    std::unique_ptr<inflate_decoder> fallback;
+    /**
+     * Read position in input for sequential decoder
+     */
+    size_t fallback_pos = 0;
+
+public:
+    /**
+     * Constructor, created object will own the specified source
+     *
+     * @param src source to read compressed data from
+     * @param threads number of threads, hardware concurrency is used if zero
+     * @param chunk_size size of compressed data decoded by one thread at once
+     */
+    parallel_inflate_source(Source&& src, size_t threads = 0, size_t chunk_size = 1 << 22) :
+    src(std::move(src)),
+    threads(detail::workers_count(threads, static_cast<size_t>(-1))),
+    chunk_size(std::max(chunk_size, static_cast<size_t>(1) << 16)) { }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    parallel_inflate_source(const parallel_inflate_source&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    parallel_inflate_source& operator=(const parallel_inflate_source&) = delete;
+
+    /**
+     * Move constructor
+     *
+     * @param other other instance
+     */
+    parallel_inflate_source(parallel_inflate_source&& other) :
+    src(std::move(other.src)),
+    threads(other.threads),
+    chunk_size(other.chunk_size),
+    input(std::move(other.input)),
+    input_bit(other.input_bit),
+    exhausted(other.exhausted),
+    window(std::move(other.window)),
+    output(std::move(other.output)),
+    output_pos(other.output_pos),
+    finished(other.finished),
+    fallback(std::move(other.fallback)),
+    fallback_pos(other.fallback_pos) { }
+
+    /**
+     * Move assignment operator
+     *
+     * @param other other instance
+     * @return this instance
+     */
+    parallel_inflate_source& operator=(parallel_inflate_source&& other) {
+        src = std::move(other.src);
+        threads = other.threads;
+        chunk_size = other.chunk_size;
+        input = std::move(other.input);
+        input_bit = other.input_bit;
+        exhausted = other.exhausted;
+        window = std::move(other.window);
+        output = std::move(other.output);
+        output_pos = other.output_pos;
+        finished = other.finished;
+        fallback = std::move(other.fallback);
+        fallback_pos = other.fallback_pos;
+        return *this;
+    }
+
+    /**
+     * Read implementation
+     *
+     * @param span output span
+     * @return number of bytes written into specified span
+     * @throws compress_exception on invalid data
+     */
+    std::streamsize read(sl::io::span<char> span) {
+        while (output_pos == output.length()) {
+            if (finished) {
+                return std::char_traits<char>::eof();
+            }
+            if (nullptr != fallback.get()) {
+                return read_sequential(span);
+            }
+            decode_batch();
+        }
+        size_t len = std::min(span.size(), output.length() - output_pos);
+        std::memcpy(span.data(), output.data() + output_pos, len);
+        output_pos += len;
+        return static_cast<std::streamsize>(len);
+    }
+
+    /**
+     * Checks whether the rest of the stream is decoded sequentially,
+     * that happens after the failed speculation and for the tail
+     * of the stream, that is smaller than two chunks
+     *
+     * @return true if sequential decoding is used
+     */
+    bool is_sequential() const {
+        return nullptr != fallback.get();
+    }
+
+    /**
+     * Underlying source accessor
+     *
+     * @return underlying source reference
+     */
+    Source& get_source() {
+        return src;
+    }
+
+private:
+    void fill_input(size_t len) {
+        size_t skip = static_cast<size_t>(input_bit / 8);
+        input.erase(0, skip);
+        input_bit -= static_cast<uint64_t>(skip) * 8;
+        if (!exhausted && input.length() < len) {
+            size_t filled = input.length();
+            input.resize(len);
+            size_t read = sl::io::read_all(src, {&input.front() + filled, len - filled});
+            input.resize(filled + read);
+            exhausted = filled + read < len;
+        }
+    }
+
+    void decode_batch() {
+        output.clear();
+        output_pos = 0;
+        fill_input(threads * chunk_size + chunk_size);
+        size_t count = std::min(threads, input.length() / chunk_size);
+        if (count < 2) {
+            start_sequential();
+            return;
+        }
+
+        // find boundaries
+        auto starts = std::vector<uint64_t>(count, 0);
+        auto found = std::vector<char>(count, 0);
+        starts[0] = input_bit;
+        found[0] = 1;
+        std::atomic<size_t> next(1);
+        detail::run_workers(count - 1, [&](const std::atomic<bool>& failed) {
+            detail::speculative_inflater dec({input.data(), input.length()});
+            for (;;) {
+                size_t idx = next.fetch_add(1);
+                if (idx >= count || failed.load()) break;
+                uint64_t from = static_cast<uint64_t>(idx) * chunk_size * 8;
+                found[idx] = dec.find_block(from, from + chunk_size * 8, starts[idx]) ? 1 : 0;
+            }
+        });
+        auto begins = std::vector<uint64_t>();
+        for (size_t i = 0; i < count; i++) {
+            if (0 != found[i]) {
+                begins.push_back(starts[i]);
+            }
+        }
+
+        // decode chunks
+        auto chunks = std::vector<detail::inflate_chunk>(begins.size());
+        uint64_t batch_end = exhausted ? static_cast<uint64_t>(-1) : static_cast<uint64_t>(count) * chunk_size * 8;
+        next.store(0);
+        detail::run_workers(begins.size(), [&](const std::atomic<bool>& failed) {
+            detail::speculative_inflater dec({input.data(), input.length()});
+            for (;;) {
+                size_t idx = next.fetch_add(1);
+                if (idx >= begins.size() || failed.load()) break;
+                uint64_t stop = idx + 1 < begins.size() ? begins[idx + 1] : batch_end;
+                chunks[idx] = dec.decode_chunk(begins[idx], stop);
+            }
+        });
+
+        // confirm boundaries
+        if (chunks[0].invalid) throw compress_exception(TRACEMSG(
+                "Inflate error: [invalid deflate data]," +
+                " bit position: [" + sl::support::to_string(chunks[0].end_bit) + "]"));
+        if (chunks[0].end_bit == chunks[0].start_bit && !chunks[0].final) {
+            // block does not fit into batch
+            start_sequential();
+            return;
+        }
+        size_t valid = 1;
+        while (valid < chunks.size()) {
+            const detail::inflate_chunk& prev = chunks[valid - 1];
+            if (prev.final || prev.truncated || prev.invalid || prev.end_bit != begins[valid]) {
+                break;
+            }
+            valid += 1;
+        }
+        chunks.resize(valid);
+
+        // resolve windows in order, then all the data in parallel
+        auto windows = std::vector<std::string>();
+        auto offsets = std::vector<size_t>();
+        size_t total = 0;
+        for (detail::inflate_chunk& ch : chunks) {
+            windows.push_back(window);
+            offsets.push_back(total);
+            total += ch.symbols.size();
+            size_t tail = std::min(ch.symbols.size(), detail::inflate_window_size);
+            auto resolved = std::string();
+            resolved.resize(tail);
+            detail::resolve_symbols(ch.symbols.data() + ch.symbols.size() - tail, tail, window,
+                    &resolved.front());
+            if (tail < detail::inflate_window_size) {
+                window.append(resolved);
+                if (window.length() > detail::inflate_window_size) {
+                    window.erase(0, window.length() - detail::inflate_window_size);
+                }
+            } else {
+                window = std::move(resolved);
+            }
+        }
+        output.resize(total);
+        next.store(0);
+        detail::run_workers(detail::workers_count(threads, chunks.size()), [&](const std::atomic<bool>& failed) {
+            for (;;) {
+                size_t idx = next.fetch_add(1);
+                if (idx >= chunks.size() || failed.load()) break;
+                const detail::inflate_chunk& ch = chunks[idx];
+                if (ch.symbols.size() > 0) {
+                    detail::resolve_symbols(ch.symbols.data(), ch.symbols.size(), windows[idx],
+                            &output.front() + offsets[idx]);
+                }
+            }
+        });
+        input_bit = chunks.back().end_bit;
+        finished = chunks.back().final;
+        if (!finished && 1 == valid) {
+            // speculation failed or there are no boundaries to split on
+            start_sequential();
+        }
+    }
+
+    void start_sequential() {
+        fallback.reset(new inflate_decoder());
+        size_t byte = static_cast<size_t>(input_bit / 8);
+        int bits = static_cast<int>(input_bit % 8);
+        if (bits > 0 && byte < input.length()) {
+            int value = static_cast<unsigned char>(input[byte]) >> bits;
+            fallback->resume({window.data(), window.length()}, 8 - bits, value);
+            byte += 1;
+        } else {
+            fallback->resume({window.data(), window.length()}, 0, 0);
+        }
+        fallback_pos = byte;
+    }
+
+    std::streamsize read_sequential(sl::io::span<char> span) {
+        for (;;) {
+            if (fallback_pos == input.length()) {
+                input.clear();
+                input_bit = 0;
+                fallback_pos = 0;
+                fill_input(chunk_size);
+            }
+            auto res = fallback->decode({input.data() + fallback_pos, input.length() - fallback_pos}, span);
+            fallback_pos += res.get_consumed();
+            if (res.get_produced() > 0 || 0 == span.size()) {
+                return static_cast<std::streamsize>(res.get_produced());
+            }
+            if (res.is_done()) {
+                finished = true;
+                return std::char_traits<char>::eof();
+            }
+            if (input.empty()) throw compress_exception(TRACEMSG(
+                    "Inflate error: [unexpected end of deflate stream]"));
+        }
+    }
+
+};
+
+/**
+ * Factory function for creating parallel inflate sources,
+ * created object will own the specified source
+ *
+ * @param source input source
+ * @param threads number of threads, hardware concurrency is used if zero
+ * @return parallel inflate source
+ */
+template <typename Source,
+        class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+parallel_inflate_source<Source> make_parallel_inflate_source(Source&& source, size_t threads = 0) {
+    return parallel_inflate_source<Source>(std::move(source), threads);
+}
+
+/**
+ * Factory function for creating parallel inflate sources,
+ * created object will NOT own the specified source
+ *
+ * @param source input source
+ * @param threads number of threads, hardware concurrency is used if zero
+ * @return parallel inflate source
+ */
+template <typename Source>
+parallel_inflate_source<sl::io::reference_source<Source>> make_parallel_inflate_source(
+        Source& source, size_t threads = 0) {
+    return parallel_inflate_source<sl::io::reference_source<Source>> (
+            sl::io::make_reference_source(source), threads);
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_PARALLEL_INFLATE_SOURCE_HPP */
+
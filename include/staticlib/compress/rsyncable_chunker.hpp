@@ -0,0 +1,149 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   rsyncable_chunker.hpp
+ * Author: alex
+ *
+ * Created on October 26, 2026, 10:30 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_RSYNCABLE_CHUNKER_HPP
+#define STATICLIB_COMPRESS_RSYNCABLE_CHUNKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Finds content-defined chunk boundaries in a stream of data.
+ * Rolling "gear" hash depends only on the last 32 input bytes, so after
+ * any edit boundaries appear at the same content positions as before
+ * once the edited region is passed. Compressor flushes its output on every
+ * boundary, so after the edit compressed output resynchronizes with the previous
+ * version and deduplicating or delta-syncing storage sees the same compressed bytes.
+ *
+ * By default boundaries are flushed with Z_SYNC_FLUSH, that keeps the 32KB
+ * window, output resynchronizes on the first boundary that is at least 32KB
+ * after the edit, ratio cost is about 1% on text with default 8KB chunks.
+ * With "full_flush" Z_FULL_FLUSH also resets the window, output resynchronizes
+ * on the next boundary, but every chunk is compressed from scratch, that
+ * costs 15-25% on text and about 4% on binary data with 8KB chunks.
+ */
+class rsyncable_chunker {
+    std::array<uint32_t, 256> gear;
+    int bits;
+    uint32_t mask;
+    size_t min_size;
+    bool full_flush;
+    uint32_t hash = 0;
+    size_t chunk_len = 0;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param bits base two logarithm of the average chunk size, 8-20
+     * @param min_size chunk boundaries are not reported before
+     *        this number of bytes since the previous boundary
+     * @param full_flush whether compressor window is reset on boundaries
+     */
+    rsyncable_chunker(int bits = 13, size_t min_size = 1024, bool full_flush = false) :
+    bits(bits),
+    mask(0),
+    min_size(min_size),
+    full_flush(full_flush) {
+        if (bits < 8 || bits > 20) throw compress_exception(TRACEMSG(
+                "Invalid chunk size bits: [" + sl::support::to_string(bits) + "]"));
+        // shift is valid only after the check
+        this->mask = ((1u << bits) - 1) << (32 - bits);
+        // fixed pseudo-random table, boundaries must not
+        // differ between runs or between platforms
+        uint64_t state = 0x9e3779b97f4a7c15ULL;
+        for (size_t i = 0; i < gear.size(); i++) {
+            state += 0x9e3779b97f4a7c15ULL;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            gear[i] = static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
+        }
+    }
+
+    /**
+     * Scans input data for the next chunk boundary, scanned data
+     * is accounted in the current chunk
+     *
+     * @param span input data
+     * @return number of bytes up to and including the chunk boundary,
+     *         zero if there is no boundary in the specified data
+     */
+    size_t next_boundary(sl::io::span<const char> span) {
+        const unsigned char* data = reinterpret_cast<const unsigned char*> (span.data());
+        for (size_t i = 0; i < span.size(); i++) {
+            // high bits of the hash depend on more input bytes, they are checked
+            hash = (hash << 1) + gear[data[i]];
+            chunk_len += 1;
+            if (0 == (hash & mask) && chunk_len >= min_size) {
+                chunk_len = 0;
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Resets the rolling state to start a new stream
+     */
+    void reset() {
+        hash = 0;
+        chunk_len = 0;
+    }
+
+    /**
+     * Full flush flag accessor
+     *
+     * @return whether compressor window is reset on boundaries
+     */
+    bool is_full_flush() const {
+        return full_flush;
+    }
+
+    /**
+     * Average chunk size accessor
+     *
+     * @return expected distance between boundaries on random data,
+     *         including the minimal chunk size
+     */
+    size_t get_average_size() const {
+        return (static_cast<size_t>(1) << bits) + min_size;
+    }
+
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_RSYNCABLE_CHUNKER_HPP */
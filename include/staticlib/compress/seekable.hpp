@@ -0,0 +1,72 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   seekable.hpp
+ * Author: alex
+ *
+ * Created on October 20, 2026, 10:15 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_SEEKABLE_HPP
+#define STATICLIB_COMPRESS_SEEKABLE_HPP
+
+#include <cstdint>
+#include <ios>
+#include <string>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+/**
+ * Seeks the specified source (or sink) and returns the new position,
+ * seekable stream must provide "seek(offset, whence)" method,
+ * where "whence" is one of 'b' (begin), 'c' (current) or 'e' (end)
+ */
+template <typename Seekable>
+uint64_t seek_to(Seekable& stream, int64_t offset, char whence = 'b') {
+    std::streamoff pos = stream.seek(static_cast<std::streamsize>(offset), whence);
+    if (pos < 0) throw compress_exception(TRACEMSG(
+            "Seek error, offset: [" + sl::support::to_string(offset) + "]," +
+            " whence: [" + std::string(1, whence) + "]"));
+    return static_cast<uint64_t>(pos);
+}
+
+template <typename Source>
+uint64_t seek_to(sl::io::reference_source<Source>& ref, int64_t offset, char whence = 'b') {
+    return seek_to(ref.get_source(), offset, whence);
+}
+
+template <typename Sink>
+uint64_t seek_to(sl::io::reference_sink<Sink>& ref, int64_t offset, char whence = 'b') {
+    return seek_to(ref.get_sink(), offset, whence);
+}
+
+} // namespace
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_SEEKABLE_HPP */
+
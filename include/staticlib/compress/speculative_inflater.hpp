@@ -0,0 +1,532 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   speculative_inflater.hpp
+ * Author: alex
+ *
+ * Created on October 23, 2026, 10:40 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_SPECULATIVE_INFLATER_HPP
+#define STATICLIB_COMPRESS_SPECULATIVE_INFLATER_HPP
+
+#include <cstdint>
+#include <array>
+#include <string>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+/**
+ * Size of the Deflate window
+ */
+const size_t inflate_window_size = 1 << 15;
+
+/**
+ * Output symbols of speculative decoding: values below 256 are bytes,
+ * other values are unresolved back-references, "value - 256" is an index
+ * in the 32KB window that precedes the start of decoding
+ */
+const uint16_t inflate_marker_base = 256;
+
+/**
+ * Result of decoding a range of Deflate blocks
+ */
+class inflate_chunk {
+public:
+    /**
+     * Output symbols
+     */
+    std::vector<uint16_t> symbols;
+    /**
+     * Bit position of the first block
+     */
+    uint64_t start_bit = 0;
+    /**
+     * Bit position right after the last decoded block
+     */
+    uint64_t end_bit = 0;
+    /**
+     * Whether the final block of the stream was decoded
+     */
+    bool final = false;
+    /**
+     * Whether decoding stopped because input ended in the middle of a block
+     */
+    bool truncated = false;
+    /**
+     * Whether decoding failed on invalid data
+     */
+    bool invalid = false;
+};
+
+/**
+ * Canonical Huffman code, codes up to 10 bits long are decoded
+ * with a single table lookup, longer ones - bit by bit
+ */
+class inflate_huffman {
+    std::array<uint16_t, 1 << 10> fast;
+    std::array<uint16_t, 16> count;
+    std::array<uint16_t, 288> symbol;
+
+public:
+    /**
+     * Builds the code from code lengths, incomplete codes are accepted
+     * only with a single code of length 1 (the same as in zlib)
+     *
+     * @param lengths code lengths
+     * @param num number of symbols
+     * @return false if code lengths are invalid
+     */
+    bool build(const uint8_t* lengths, size_t num) {
+        count.fill(0);
+        for (size_t i = 0; i < num; i++) {
+            count[lengths[i]] += 1;
+        }
+        count[0] = 0;
+        int max = 0;
+        int left = 1;
+        for (int len = 1; len < 16; len++) {
+            left <<= 1;
+            left -= count[len];
+            if (left < 0) return false;
+            if (count[len] > 0) max = len;
+        }
+        if (left > 0 && max > 1) return false;
+        std::array<uint16_t, 16> offs;
+        offs[1] = 0;
+        for (int len = 1; len < 15; len++) {
+            offs[len + 1] = offs[len] + count[len];
+        }
+        for (size_t i = 0; i < num; i++) {
+            if (0 != lengths[i]) {
+                symbol[offs[lengths[i]]++] = static_cast<uint16_t>(i);
+            }
+        }
+        fast.fill(0);
+        uint32_t code = 0;
+        size_t idx = 0;
+        for (uint32_t len = 1; len <= 10; len++) {
+            for (size_t j = 0; j < count[len]; j++) {
+                uint32_t rev = 0;
+                for (uint32_t b = 0; b < len; b++) {
+                    rev |= ((code >> b) & 1) << (len - 1 - b);
+                }
+                uint16_t entry = static_cast<uint16_t>((symbol[idx] << 4) | len);
+                for (uint32_t k = rev; k < fast.size(); k += (1u << len)) {
+                    fast[k] = entry;
+                }
+                idx += 1;
+                code += 1;
+            }
+            code <<= 1;
+        }
+        return true;
+    }
+
+    /**
+     * Decodes a symbol
+     *
+     * @param bits next 15 or more input bits, first bit in the lowest position
+     * @param used number of bits used by the decoded symbol
+     * @return symbol, -1 if input is not a valid code
+     */
+    int decode(uint64_t bits, uint32_t& used) const {
+        uint16_t entry = fast[bits & (fast.size() - 1)];
+        if (0 != entry) {
+            used = entry & 15;
+            return entry >> 4;
+        }
+        int code = 0;
+        int first = 0;
+        int index = 0;
+        for (uint32_t len = 1; len < 16; len++) {
+            code |= static_cast<int>(bits & 1);
+            bits >>= 1;
+            int cnt = count[len];
+            if (code - cnt < first) {
+                used = len;
+                return symbol[index + (code - first)];
+            }
+            index += cnt;
+            first += cnt;
+            first <<= 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+
+};
+
+/**
+ * Deflate decoder that can start decoding at any block boundary
+ * without knowing the preceding data: back-references before the start
+ * are emitted as markers that are resolved later, when the window
+ * becomes known. It is used for decoding of separate parts
+ * of a stream in parallel and for searching block boundaries.
+ */
+class speculative_inflater {
+    /**
+     * Status of decoding one block
+     */
+    enum class block_status {
+        ok, invalid, no_input
+    };
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    // bit reader, bytes past the end of data are read as zeros
+    size_t next = 0;
+    uint64_t bitbuf = 0;
+    uint32_t bitcnt = 0;
+
+    inflate_huffman fixed_lit;
+    inflate_huffman fixed_dist;
+    inflate_huffman codelen;
+    inflate_huffman lit;
+    inflate_huffman dist;
+    std::vector<uint16_t> scratch;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param input compressed data, must remain valid while decoder is used
+     */
+    explicit speculative_inflater(sl::io::span<const char> input) :
+    data(reinterpret_cast<const uint8_t*> (input.data())),
+    size(input.size()) {
+        std::array<uint8_t, 288> lens;
+        for (size_t i = 0; i < 144; i++) lens[i] = 8;
+        for (size_t i = 144; i < 256; i++) lens[i] = 9;
+        for (size_t i = 256; i < 280; i++) lens[i] = 7;
+        for (size_t i = 280; i < 288; i++) lens[i] = 8;
+        fixed_lit.build(lens.data(), 288);
+        lens.fill(5);
+        // symbols 30 and 31 are rejected when decoding
+        fixed_dist.build(lens.data(), 32);
+    }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    speculative_inflater(const speculative_inflater&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    speculative_inflater& operator=(const speculative_inflater&) = delete;
+
+    /**
+     * Decodes the blocks starting from the specified position until
+     * the first block boundary at or after the specified stop position,
+     * the end of the stream or the end of input
+     *
+     * @param start_bit bit position of the first block
+     * @param stop_bit bit position to stop at
+     * @return decoded chunk
+     */
+    inflate_chunk decode_chunk(uint64_t start_bit, uint64_t stop_bit) {
+        auto res = inflate_chunk();
+        res.start_bit = start_bit;
+        res.end_bit = start_bit;
+        seek(start_bit);
+        for (;;) {
+            uint64_t block_start = position();
+            size_t out_before = res.symbols.size();
+            if (block_start >= stop_bit) {
+                break;
+            }
+            bool final = false;
+            auto st = decode_block(res.symbols, final);
+            if (block_status::invalid == st) {
+                res.invalid = true;
+                break;
+            }
+            if (block_status::no_input == st) {
+                res.symbols.resize(out_before);
+                res.truncated = true;
+                break;
+            }
+            res.end_bit = position();
+            if (final) {
+                res.final = true;
+                break;
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Searches for a position, where a non-final dynamic Huffman block
+     * starts, such block and the header of the next block must be valid
+     *
+     * @param from_bit first position to check
+     * @param to_bit position to stop search at
+     * @param found found position
+     * @return true if position was found
+     */
+    bool find_block(uint64_t from_bit, uint64_t to_bit, uint64_t& found) {
+        for (uint64_t pos = from_bit; pos < to_bit && pos / 8 < size; pos++) {
+            // BFINAL = 0, BTYPE = 2
+            uint32_t head = data[pos / 8];
+            if (pos / 8 + 1 < size) {
+                head |= static_cast<uint32_t>(data[pos / 8 + 1]) << 8;
+            }
+            if (4 != ((head >> (pos % 8)) & 7)) {
+                continue;
+            }
+            seek(pos + 3);
+            if (!read_dynamic_header()) {
+                continue;
+            }
+            seek(pos);
+            scratch.clear();
+            bool final = false;
+            if (block_status::ok != decode_block(scratch, final)) {
+                continue;
+            }
+            // next block header
+            refill();
+            if (3 == ((bitbuf >> 1) & 3)) {
+                continue;
+            }
+            found = pos;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    uint64_t position() const {
+        return static_cast<uint64_t>(next) * 8 - bitcnt;
+    }
+
+    void seek(uint64_t bit) {
+        next = static_cast<size_t>(bit / 8);
+        bitbuf = 0;
+        bitcnt = 0;
+        refill();
+        drop(static_cast<uint32_t>(bit % 8));
+    }
+
+    void refill() {
+        while (bitcnt <= 56) {
+            uint64_t byte = next < size ? data[next] : 0;
+            bitbuf |= byte << bitcnt;
+            next += 1;
+            bitcnt += 8;
+        }
+    }
+
+    void drop(uint32_t n) {
+        bitbuf >>= n;
+        bitcnt -= n;
+    }
+
+    uint32_t bits(uint32_t n) {
+        if (bitcnt < n) {
+            refill();
+        }
+        uint32_t res = static_cast<uint32_t>(bitbuf & ((uint64_t(1) << n) - 1));
+        drop(n);
+        return res;
+    }
+
+    bool overrun() const {
+        return position() > static_cast<uint64_t>(size) * 8;
+    }
+
+    bool read_dynamic_header() {
+        static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        uint32_t nlen = bits(5) + 257;
+        uint32_t ndist = bits(5) + 1;
+        uint32_t ncode = bits(4) + 4;
+        if (nlen > 286 || ndist > 30) return false;
+        std::array<uint8_t, 320> lengths;
+        lengths.fill(0);
+        for (uint32_t i = 0; i < ncode; i++) {
+            lengths[order[i]] = static_cast<uint8_t>(bits(3));
+        }
+        if (!codelen.build(lengths.data(), 19)) return false;
+        // unlike other codes, code lengths code must be complete
+        int left = 1;
+        std::array<int, 8> cnt;
+        cnt.fill(0);
+        for (size_t i = 0; i < 19; i++) {
+            cnt[lengths[i]] += 1;
+        }
+        for (int len = 1; len < 8; len++) {
+            left = (left << 1) - cnt[len];
+        }
+        if (0 != left) return false;
+        std::array<uint8_t, 320> lens;
+        lens.fill(0);
+        uint32_t idx = 0;
+        while (idx < nlen + ndist) {
+            refill();
+            uint32_t used = 0;
+            int sym = codelen.decode(bitbuf, used);
+            if (sym < 0) return false;
+            drop(used);
+            if (sym < 16) {
+                lens[idx++] = static_cast<uint8_t>(sym);
+            } else {
+                uint8_t val = 0;
+                uint32_t rep = 0;
+                if (16 == sym) {
+                    if (0 == idx) return false;
+                    val = lens[idx - 1];
+                    rep = 3 + bits(2);
+                } else if (17 == sym) {
+                    rep = 3 + bits(3);
+                } else {
+                    rep = 11 + bits(7);
+                }
+                if (idx + rep > nlen + ndist) return false;
+                for (uint32_t i = 0; i < rep; i++) {
+                    lens[idx++] = val;
+                }
+            }
+        }
+        if (overrun()) return false;
+        // end-of-block code must be present
+        if (0 == lens[256]) return false;
+        if (!lit.build(lens.data(), nlen)) return false;
+        if (!dist.build(lens.data() + nlen, ndist)) return false;
+        return true;
+    }
+
+    block_status decode_block(std::vector<uint16_t>& out, bool& final) {
+        final = 1 == bits(1);
+        uint32_t type = bits(2);
+        if (0 == type) {
+            return copy_stored(out);
+        }
+        if (3 == type) {
+            return block_status::invalid;
+        }
+        if (2 == type) {
+            if (!read_dynamic_header()) {
+                return overrun() ? block_status::no_input : block_status::invalid;
+            }
+            return decode_codes(out, lit, dist);
+        }
+        return decode_codes(out, fixed_lit, fixed_dist);
+    }
+
+    block_status copy_stored(std::vector<uint16_t>& out) {
+        drop(bitcnt % 8);
+        uint32_t len = bits(16);
+        uint32_t nlen = bits(16);
+        if (overrun()) return block_status::no_input;
+        if (len != (~nlen & 0xffff)) return block_status::invalid;
+        size_t pos = static_cast<size_t>(position() / 8);
+        if (pos + len > size) return block_status::no_input;
+        for (size_t i = 0; i < len; i++) {
+            out.push_back(data[pos + i]);
+        }
+        seek((static_cast<uint64_t>(pos) + len) * 8);
+        return block_status::ok;
+    }
+
+    block_status decode_codes(std::vector<uint16_t>& out, const inflate_huffman& lcode, const inflate_huffman& dcode) {
+        static const uint16_t len_base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const uint8_t len_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static const uint16_t dist_base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        static const uint8_t dist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+        for (;;) {
+            // 57+ bits are enough for a length/distance pair with extra bits
+            refill();
+            if (overrun()) return block_status::no_input;
+            uint32_t used = 0;
+            int sym = lcode.decode(bitbuf, used);
+            if (sym < 0) return block_status::invalid;
+            drop(used);
+            if (sym < 256) {
+                out.push_back(static_cast<uint16_t>(sym));
+            } else if (256 == sym) {
+                return overrun() ? block_status::no_input : block_status::ok;
+            } else {
+                sym -= 257;
+                if (sym >= 29) return block_status::invalid;
+                uint32_t len = len_base[sym] + bits(len_extra[sym]);
+                int dsym = dcode.decode(bitbuf, used);
+                if (dsym < 0 || dsym >= 30) return block_status::invalid;
+                drop(used);
+                uint32_t distance = dist_base[dsym] + bits(dist_extra[dsym]);
+                int64_t from = static_cast<int64_t>(out.size()) - distance;
+                if (from < -static_cast<int64_t>(inflate_window_size)) return block_status::invalid;
+                for (uint32_t i = 0; i < len; i++) {
+                    int64_t src = from + i;
+                    uint16_t val = src >= 0 ? out[static_cast<size_t>(src)] :
+                            static_cast<uint16_t>(inflate_marker_base + inflate_window_size + src);
+                    out.push_back(val);
+                }
+            }
+        }
+    }
+
+};
+
+/**
+ * Converts decoded symbols into bytes
+ *
+ * @param symbols symbols to resolve
+ * @param count number of symbols
+ * @param window data that precedes the start of decoding, up to 32KB
+ * @param dest destination buffer, must have space for all symbols
+ * @throws compress_exception if a marker points before the start of data
+ */
+inline void resolve_symbols(const uint16_t* symbols, size_t count, const std::string& window, char* dest) {
+    for (size_t i = 0; i < count; i++) {
+        uint16_t val = symbols[i];
+        if (val < inflate_marker_base) {
+            dest[i] = static_cast<char>(val);
+        } else {
+            size_t idx = val - inflate_marker_base;
+            if (idx + window.length() < inflate_window_size) throw compress_exception(TRACEMSG(
+                    "Inflate error: [invalid distance too far back]"));
+            dest[i] = window[idx + window.length() - inflate_window_size];
+        }
+    }
+}
+
+} // namespace
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_SPECULATIVE_INFLATER_HPP */
+
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   thread_local_contexts.hpp
+ * Author: alex
+ *
+ * Created on October 29, 2026, 10:10 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS_HPP
+#define STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS_HPP
+
+// Codec states used by one-shot buffer functions are kept per-thread.
+// When compiler supports "thread_local" they are destroyed on thread exit,
+// otherwise (vs2013) a "__declspec(thread)" pointer is used and one context
+// per thread is allocated on first call and leaked on thread exit.
+// Can be defined explicitly to force "thread_local" contexts.
+
+// vs2013 does not support thread_local
+#if !defined(STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS) && (!defined(_MSC_VER) || _MSC_VER >= 1900)
+#define STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS
+#endif // vs2013
+
+#endif /* STATICLIB_COMPRESS_THREAD_LOCAL_CONTEXTS_HPP */
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   timed_sink.hpp
+ * Author: alex
+ *
+ * Created on October 25, 2026, 11:40 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_TIMED_SINK_HPP
+#define STATICLIB_COMPRESS_TIMED_SINK_HPP
+
+#include <chrono>
+#include <ios>
+#include <memory>
+#include <type_traits>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/latency_histogram.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Sink wrapper that records latencies of "write", "flush" and
+ * of the destruction (when compressors finalize their output) of
+ * the wrapped sink into the specified "latency_recorder". Codec and I/O
+ * time are separated by wrapping both the codec and its underlying sink:
+ *
+ * make_timed_sink(make_deflate_sink(make_timed_sink(file, rec, latency_role::io)), rec, latency_role::codec)
+ */
+template <typename Sink>
+class timed_sink {
+    /**
+     * Wrapped sink, is destroyed explicitly to measure finalization
+     */
+    std::unique_ptr<Sink> sink;
+    /**
+     * Destination for the measurements
+     */
+    latency_recorder* recorder;
+    /**
+     * Role of this wrapper
+     */
+    latency_role role;
+
+public:
+    /**
+     * Constructor
+     * 
+     * @param sink sink to wrap
+     * @param recorder destination for the measurements
+     * @param role role of this wrapper in the streams chain
+     */
+    timed_sink(Sink&& sink, latency_recorder& recorder, latency_role role) :
+    sink(new Sink(std::move(sink))),
+    recorder(std::addressof(recorder)),
+    role(role) { }
+
+    ~timed_sink() STATICLIB_NOEXCEPT {
+        if (nullptr == sink.get()) return;
+        auto start = begin();
+        sink.reset();
+        end(latency_op::finalize, start);
+    }
+
+    /**
+     * Deleted copy constructor
+     * 
+     * @param other instance
+     */
+    timed_sink(const timed_sink&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     * 
+     * @param other instance
+     * @return this instance 
+     */
+    timed_sink& operator=(const timed_sink&) = delete;
+
+    /**
+     * Move constructor
+     * 
+     * @param other other instance
+     */
+    timed_sink(timed_sink&& other) :
+    sink(std::move(other.sink)),
+    recorder(other.recorder),
+    role(other.role) { }
+
+    /**
+     * Move assignment operator
+     * 
+     * @param other other instance
+     * @return this instance
+     */
+    timed_sink& operator=(timed_sink&& other) {
+        sink = std::move(other.sink);
+        recorder = other.recorder;
+        role = other.role;
+        return *this;
+    }
+
+    /**
+     * Write implementation
+     * 
+     * @param span source span
+     * @return number of bytes processed (read from source span)
+     */
+    std::streamsize write(sl::io::span<const char> span) {
+        auto start = begin();
+        auto res = sink->write(span);
+        end(latency_op::write, start);
+        return res;
+    }
+
+    /**
+     * Calls flush on wrapped sink
+     * 
+     * @return value returned by wrapped sink
+     */
+    std::streamsize flush() {
+        auto start = begin();
+        auto res = sink->flush();
+        end(latency_op::flush, start);
+        return res;
+    }
+
+    /**
+     * Underlying sink accessor
+     * 
+     * @return underlying sink reference
+     */
+    Sink& get_sink() {
+        return *sink;
+    }
+
+private:
+    std::chrono::steady_clock::time_point begin() {
+        if (latency_role::codec == role) {
+            recorder->begin_call();
+        }
+        return std::chrono::steady_clock::now();
+    }
+
+    void end(latency_op op, std::chrono::steady_clock::time_point start) {
+        uint64_t nanos = detail::elapsed_nanos(start);
+        if (latency_role::codec == role) {
+            recorder->end_call(op, nanos);
+        } else {
+            recorder->add_io(nanos);
+        }
+    }
+
+};
+
+/**
+ * Factory function for creating timed sinks,
+ * created object will own the specified sink
+ * 
+ * @param sink sink to wrap
+ * @param recorder destination for the measurements
+ * @param role role of the wrapper in the streams chain
+ * @return timed sink
+ */
+template <typename Sink,
+        class = typename std::enable_if<!std::is_lvalue_reference<Sink>::value>::type>
+timed_sink<Sink> make_timed_sink(Sink&& sink, latency_recorder& recorder, latency_role role) {
+    return timed_sink<Sink>(std::move(sink), recorder, role);
+}
+
+/**
+ * Factory function for creating timed sinks,
+ * created object will NOT own the specified sink
+ * 
+ * @param sink sink to wrap
+ * @param recorder destination for the measurements
+ * @param role role of the wrapper in the streams chain
+ * @return timed sink
+ */
+template <typename Sink>
+timed_sink<sl::io::reference_sink<Sink>> make_timed_sink(Sink& sink, latency_recorder& recorder, latency_role role) {
+    return timed_sink<sl::io::reference_sink<Sink>>(
+            sl::io::make_reference_sink(sink), recorder, role);
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_TIMED_SINK_HPP */
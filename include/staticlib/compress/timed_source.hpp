@@ -0,0 +1,194 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   timed_source.hpp
+ * Author: alex
+ *
+ * Created on October 25, 2026, 12:20 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_TIMED_SOURCE_HPP
+#define STATICLIB_COMPRESS_TIMED_SOURCE_HPP
+
+#include <chrono>
+#include <ios>
+#include <memory>
+#include <type_traits>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/latency_histogram.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Source wrapper that records latencies of "read" and of the destruction
+ * of the wrapped source into the specified "latency_recorder". Codec and I/O
+ * time are separated by wrapping both the codec and its underlying source:
+ *
+ * make_timed_source(make_inflate_source(make_timed_source(file, rec, latency_role::io)), rec, latency_role::codec)
+ */
+template <typename Source>
+class timed_source {
+    /**
+     * Wrapped source, is destroyed explicitly to measure its cleanup
+     */
+    std::unique_ptr<Source> src;
+    /**
+     * Destination for the measurements
+     */
+    latency_recorder* recorder;
+    /**
+     * Role of this wrapper
+     */
+    latency_role role;
+
+public:
+    /**
+     * Constructor
+     * 
+     * @param src source to wrap
+     * @param recorder destination for the measurements
+     * @param role role of this wrapper in the streams chain
+     */
+    timed_source(Source&& src, latency_recorder& recorder, latency_role role) :
+    src(new Source(std::move(src))),
+    recorder(std::addressof(recorder)),
+    role(role) { }
+
+    ~timed_source() STATICLIB_NOEXCEPT {
+        if (nullptr == src.get()) return;
+        auto start = begin();
+        src.reset();
+        end(latency_op::finalize, start);
+    }
+
+    /**
+     * Deleted copy constructor
+     * 
+     * @param other instance
+     */
+    timed_source(const timed_source&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     * 
+     * @param other instance
+     * @return this instance 
+     */
+    timed_source& operator=(const timed_source&) = delete;
+
+    /**
+     * Move constructor
+     * 
+     * @param other other instance
+     */
+    timed_source(timed_source&& other) :
+    src(std::move(other.src)),
+    recorder(other.recorder),
+    role(other.role) { }
+
+    /**
+     * Move assignment operator
+     * 
+     * @param other other instance
+     * @return this instance
+     */
+    timed_source& operator=(timed_source&& other) {
+        src = std::move(other.src);
+        recorder = other.recorder;
+        role = other.role;
+        return *this;
+    }
+
+    /**
+     * Read implementation
+     * 
+     * @param span output span
+     * @return number of bytes written into specified span
+     */
+    std::streamsize read(sl::io::span<char> span) {
+        auto start = begin();
+        auto res = src->read(span);
+        end(latency_op::read, start);
+        return res;
+    }
+
+    /**
+     * Underlying source accessor
+     * 
+     * @return underlying source reference
+     */
+    Source& get_source() {
+        return *src;
+    }
+
+private:
+    std::chrono::steady_clock::time_point begin() {
+        if (latency_role::codec == role) {
+            recorder->begin_call();
+        }
+        return std::chrono::steady_clock::now();
+    }
+
+    void end(latency_op op, std::chrono::steady_clock::time_point start) {
+        uint64_t nanos = detail::elapsed_nanos(start);
+        if (latency_role::codec == role) {
+            recorder->end_call(op, nanos);
+        } else {
+            recorder->add_io(nanos);
+        }
+    }
+
+};
+
+/**
+ * Factory function for creating timed sources,
+ * created object will own the specified source
+ * 
+ * @param source source to wrap
+ * @param recorder destination for the measurements
+ * @param role role of the wrapper in the streams chain
+ * @return timed source
+ */
+template <typename Source,
+        class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+timed_source<Source> make_timed_source(Source&& source, latency_recorder& recorder, latency_role role) {
+    return timed_source<Source>(std::move(source), recorder, role);
+}
+
+/**
+ * Factory function for creating timed sources,
+ * created object will NOT own the specified source
+ * 
+ * @param source source to wrap
+ * @param recorder destination for the measurements
+ * @param role role of the wrapper in the streams chain
+ * @return timed source
+ */
+template <typename Source>
+timed_source<sl::io::reference_source<Source>> make_timed_source(Source& source, latency_recorder& recorder, latency_role role) {
+    return timed_source<sl::io::reference_source<Source>>(
+            sl::io::make_reference_source(source), recorder, role);
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_TIMED_SOURCE_HPP */
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   worker_pool.hpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 2:30 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_WORKER_POOL_HPP
+#define STATICLIB_COMPRESS_WORKER_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+/**
+ * Returns the number of worker threads to use
+ *
+ * @param threads requested number of threads, zero for hardware concurrency
+ * @param tasks_count number of tasks to process
+ * @return number of threads, not greater than number of tasks
+ */
+inline size_t workers_count(size_t threads, size_t tasks_count) {
+    if (0 == threads) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    return std::min(threads, tasks_count);
+}
+
+/**
+ * Runs specified worker function in the specified number of threads,
+ * calling thread is used as one of the workers. Worker receives
+ * a "failed" flag, that is set when any of the workers throws,
+ * first thrown exception is rethrown after all workers are finished.
+ *
+ * @param threads number of threads
+ * @param worker callable that takes "const std::atomic<bool>&"
+ */
+template <typename Worker>
+void run_workers(size_t threads, Worker worker) {
+    std::atomic<bool> failed(false);
+    std::mutex mutex;
+    std::exception_ptr error;
+    auto guarded = [&]() {
+        try {
+            worker(failed);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            failed.store(true);
+        }
+    };
+    auto pool = std::vector<std::thread>();
+    for (size_t i = 1; i < threads; i++) {
+        pool.emplace_back(guarded);
+    }
+    if (threads > 0) {
+        guarded();
+    }
+    for (std::thread& th : pool) {
+        th.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_WORKER_POOL_HPP */
+
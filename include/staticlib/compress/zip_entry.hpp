@@ -0,0 +1,149 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zip_entry.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:12 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_ZIP_ENTRY_HPP
+#define STATICLIB_COMPRESS_ZIP_ENTRY_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "staticlib/compress/zip_compression_method.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Description of a single ZIP entry as it is recorded
+ * in the Central Directory of the archive
+ */
+class zip_entry {
+    std::string name;
+    zip_compression_method method;
+    uint16_t flags;
+    uint32_t crc;
+    uint64_t compressed_size;
+    uint64_t uncompressed_size;
+    uint64_t offset;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param name entry name
+     * @param method compression method
+     * @param flags general purpose bit flag
+     * @param crc CRC-32 of the uncompressed data
+     * @param compressed_size size of the entry data in archive
+     * @param uncompressed_size size of the entry data after decompression
+     * @param offset offset of the local file header from the start of archive
+     */
+    zip_entry(std::string name, zip_compression_method method, uint16_t flags, uint32_t crc,
+            uint64_t compressed_size, uint64_t uncompressed_size, uint64_t offset) :
+    name(std::move(name)),
+    method(method),
+    flags(flags),
+    crc(crc),
+    compressed_size(compressed_size),
+    uncompressed_size(uncompressed_size),
+    offset(offset) { }
+
+    /**
+     * Entry name accessor
+     *
+     * @return entry name
+     */
+    const std::string& get_name() const {
+        return name;
+    }
+
+    /**
+     * Compression method accessor
+     *
+     * @return compression method
+     */
+    zip_compression_method get_method() const {
+        return method;
+    }
+
+    /**
+     * General purpose bit flag accessor
+     *
+     * @return general purpose bit flag
+     */
+    uint16_t get_flags() const {
+        return flags;
+    }
+
+    /**
+     * CRC-32 accessor
+     *
+     * @return CRC-32 of the uncompressed data
+     */
+    uint32_t get_crc() const {
+        return crc;
+    }
+
+    /**
+     * Compressed size accessor
+     *
+     * @return size of the entry data in archive
+     */
+    uint64_t get_compressed_size() const {
+        return compressed_size;
+    }
+
+    /**
+     * Uncompressed size accessor, may be used by callers
+     * to preallocate the destination before extraction
+     *
+     * @return size of the entry data after decompression
+     */
+    uint64_t get_uncompressed_size() const {
+        return uncompressed_size;
+    }
+
+    /**
+     * Local file header offset accessor
+     *
+     * @return offset of the local file header from the start of archive
+     */
+    uint64_t get_offset() const {
+        return offset;
+    }
+
+    /**
+     * Checks whether this entry denotes a directory
+     *
+     * @return true if entry name ends with slash
+     */
+    bool is_directory() const {
+        return !name.empty() && '/' == name[name.length() - 1];
+    }
+
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_ZIP_ENTRY_HPP */
+
@@ -0,0 +1,360 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   zip_entry_cache.hpp
+ * Author: alex
+ *
+ * Created on October 28, 2026, 10:05 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_ZIP_ENTRY_CACHE_HPP
+#define STATICLIB_COMPRESS_ZIP_ENTRY_CACHE_HPP
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/zip_entry.hpp"
+#include "staticlib/compress/zip_reader.hpp"
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+/**
+ * Cache key: archive identity and offset of the entry
+ * local header, recorded in Central Directory
+ */
+class entry_cache_key {
+public:
+    std::string archive_id;
+    uint64_t offset;
+
+    entry_cache_key(const std::string& archive_id, uint64_t offset) :
+    archive_id(archive_id),
+    offset(offset) { }
+
+    bool operator==(const entry_cache_key& other) const {
+        return offset == other.offset && archive_id == other.archive_id;
+    }
+};
+
+class entry_cache_key_hash {
+public:
+    size_t operator()(const entry_cache_key& key) const {
+        size_t hash = std::hash<std::string>()(key.archive_id);
+        return hash ^ (static_cast<size_t>(key.offset) * static_cast<size_t>(0x9e3779b97f4a7c15ULL));
+    }
+};
+
+/**
+ * Single LRU list with its own lock, most recently used entries are at front
+ */
+class entry_cache_shard {
+public:
+    using value_type = std::pair<entry_cache_key, std::shared_ptr<const std::string>>;
+    using list_type = std::list<value_type>;
+
+    std::mutex mutex;
+    list_type lru;
+    std::unordered_map<entry_cache_key, list_type::iterator, entry_cache_key_hash> index;
+    size_t bytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+// approximate memory used by the list node, index node and string header
+inline size_t entry_cache_cost(const entry_cache_key& key, const std::string& data) {
+    return data.length() + key.archive_id.length() + 128;
+}
+
+} // namespace
+
+/**
+ * Thread-safe size-bounded cache of decompressed ZIP entries, allows to serve
+ * frequently requested entries without inflating them on every request.
+ * Entries are keyed by archive identity (e.g. file path, must change when archive
+ * is rewritten) and local header offset of the entry. Cache is split into
+ * independently locked LRU shards, so concurrent lookups of different
+ * entries rarely contend; locks are held only to update LRU lists, never
+ * during decompression. Cached data is returned as shared pointers, evicted
+ * entries stay valid while they are used by callers.
+ */
+class zip_entry_cache {
+    size_t max_bytes;
+    size_t shard_max_bytes;
+    std::vector<std::unique_ptr<detail::entry_cache_shard>> shards;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param max_bytes cache size limit, is divided evenly between shards,
+     *        entries larger than the shard limit are not cached
+     * @param shards_count number of independently locked shards
+     */
+    zip_entry_cache(size_t max_bytes, size_t shards_count = 16) :
+    max_bytes(max_bytes),
+    shard_max_bytes(0 != shards_count ? max_bytes / shards_count : 0) {
+        if (0 == shards_count) throw compress_exception(TRACEMSG(
+                "Invalid zero shards count"));
+        for (size_t i = 0; i < shards_count; i++) {
+            shards.emplace_back(new detail::entry_cache_shard());
+        }
+    }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    zip_entry_cache(const zip_entry_cache&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    zip_entry_cache& operator=(const zip_entry_cache&) = delete;
+
+    /**
+     * Move constructor, must not be used concurrently with other calls
+     *
+     * @param other other instance
+     */
+    zip_entry_cache(zip_entry_cache&& other) :
+    max_bytes(other.max_bytes),
+    shard_max_bytes(other.shard_max_bytes),
+    shards(std::move(other.shards)) { }
+
+    /**
+     * Move assignment operator, must not be used concurrently with other calls
+     *
+     * @param other other instance
+     * @return this instance
+     */
+    zip_entry_cache& operator=(zip_entry_cache&& other) {
+        max_bytes = other.max_bytes;
+        shard_max_bytes = other.shard_max_bytes;
+        shards = std::move(other.shards);
+        return *this;
+    }
+
+    /**
+     * Finds decompressed entry data in cache
+     *
+     * @param archive_id archive identity
+     * @param entry ZIP entry
+     * @return entry data, null pointer if entry is not cached
+     */
+    std::shared_ptr<const std::string> get(const std::string& archive_id, const zip_entry& entry) {
+        auto key = detail::entry_cache_key(archive_id, entry.get_offset());
+        auto& sh = shard_for(key);
+        std::lock_guard<std::mutex> guard{sh.mutex};
+        auto it = sh.index.find(key);
+        if (sh.index.end() == it) {
+            sh.misses += 1;
+            return std::shared_ptr<const std::string>();
+        }
+        sh.hits += 1;
+        sh.lru.splice(sh.lru.begin(), sh.lru, it->second);
+        return it->second->second;
+    }
+
+    /**
+     * Adds decompressed entry data to cache, least recently used entries
+     * of the same shard are evicted to fit the size limit
+     *
+     * @param archive_id archive identity
+     * @param entry ZIP entry
+     * @param data decompressed entry data
+     * @return true if data was cached, false if it is too large for cache
+     */
+    bool put(const std::string& archive_id, const zip_entry& entry, std::shared_ptr<const std::string> data) {
+        if (nullptr == data.get()) throw compress_exception(TRACEMSG(
+                "Invalid null data, entry: [" + entry.get_name() + "]"));
+        auto key = detail::entry_cache_key(archive_id, entry.get_offset());
+        size_t cost = detail::entry_cache_cost(key, *data);
+        if (cost > shard_max_bytes) return false;
+        auto& sh = shard_for(key);
+        std::lock_guard<std::mutex> guard{sh.mutex};
+        auto it = sh.index.find(key);
+        if (sh.index.end() != it) {
+            sh.bytes -= detail::entry_cache_cost(key, *it->second->second);
+            sh.lru.erase(it->second);
+            sh.index.erase(it);
+        }
+        while (sh.bytes + cost > shard_max_bytes) {
+            auto& last = sh.lru.back();
+            sh.bytes -= detail::entry_cache_cost(last.first, *last.second);
+            sh.index.erase(last.first);
+            sh.lru.pop_back();
+        }
+        sh.lru.emplace_front(key, std::move(data));
+        sh.index.emplace(std::move(key), sh.lru.begin());
+        sh.bytes += cost;
+        return true;
+    }
+
+    /**
+     * Returns decompressed data of the specified entry, reads it from
+     * the archive and adds it to cache on a miss. When the same entry is
+     * missed concurrently, it may be decompressed by multiple threads.
+     *
+     * @param src seekable source of the ZIP archive, must not be shared between threads
+     * @param archive_id archive identity
+     * @param entry ZIP entry
+     * @return entry data
+     */
+    template <typename Source>
+    std::shared_ptr<const std::string> read_entry(Source& src, const std::string& archive_id,
+            const zip_entry& entry) {
+        auto cached = get(archive_id, entry);
+        if (nullptr != cached.get()) {
+            return cached;
+        }
+        if (entry.get_uncompressed_size() > static_cast<uint64_t>(SIZE_MAX)) throw compress_exception(TRACEMSG(
+                "ZIP entry is too large to be cached, entry: [" + entry.get_name() + "]," +
+                " size: [" + sl::support::to_string(entry.get_uncompressed_size()) + "]"));
+        auto data = std::make_shared<std::string>();
+        data->resize(static_cast<size_t>(entry.get_uncompressed_size()));
+        auto entry_src = make_zip_entry_source(src, entry);
+        size_t pos = 0;
+        for (;;) {
+            if (pos == data->length()) {
+                // check that entry ends here, validates CRC-32 and size
+                char extra = '\0';
+                auto res = entry_src.read({std::addressof(extra), 1});
+                if (std::char_traits<char>::eof() == res) break;
+                throw compress_exception(TRACEMSG("ZIP entry is longer than expected," +
+                        " entry: [" + entry.get_name() + "]," +
+                        " expected size: [" + sl::support::to_string(data->length()) + "]"));
+            }
+            auto res = entry_src.read({&data->front() + pos, data->length() - pos});
+            if (std::char_traits<char>::eof() == res) break;
+            pos += static_cast<size_t>(res);
+        }
+        auto ptr = std::shared_ptr<const std::string>(std::move(data));
+        put(archive_id, entry, ptr);
+        return ptr;
+    }
+
+    /**
+     * Removes all cached entries, counters are not reset
+     */
+    void clear() {
+        for (auto& sh : shards) {
+            std::lock_guard<std::mutex> guard{sh->mutex};
+            sh->lru.clear();
+            sh->index.clear();
+            sh->bytes = 0;
+        }
+    }
+
+    /**
+     * Hits counter accessor
+     *
+     * @return number of lookups that found cached entry
+     */
+    uint64_t get_hits() const {
+        uint64_t res = 0;
+        for (auto& sh : shards) {
+            std::lock_guard<std::mutex> guard{sh->mutex};
+            res += sh->hits;
+        }
+        return res;
+    }
+
+    /**
+     * Misses counter accessor
+     *
+     * @return number of lookups that did not find cached entry
+     */
+    uint64_t get_misses() const {
+        uint64_t res = 0;
+        for (auto& sh : shards) {
+            std::lock_guard<std::mutex> guard{sh->mutex};
+            res += sh->misses;
+        }
+        return res;
+    }
+
+    /**
+     * Number of cached entries
+     *
+     * @return number of cached entries
+     */
+    size_t get_count() const {
+        size_t res = 0;
+        for (auto& sh : shards) {
+            std::lock_guard<std::mutex> guard{sh->mutex};
+            res += sh->index.size();
+        }
+        return res;
+    }
+
+    /**
+     * Approximate memory used by cached entries
+     *
+     * @return number of bytes, not more than the cache size limit
+     */
+    size_t get_size_bytes() const {
+        size_t res = 0;
+        for (auto& sh : shards) {
+            std::lock_guard<std::mutex> guard{sh->mutex};
+            res += sh->bytes;
+        }
+        return res;
+    }
+
+    /**
+     * Cache size limit accessor
+     *
+     * @return cache size limit in bytes
+     */
+    size_t get_max_bytes() const {
+        return max_bytes;
+    }
+
+private:
+    detail::entry_cache_shard& shard_for(const detail::entry_cache_key& key) {
+        size_t hash = detail::entry_cache_key_hash()(key);
+        // mix high bits, low bits of the offset-based part are often aligned
+        hash ^= (hash >> 17);
+        return *shards[hash % shards.size()];
+    }
+
+};
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_ZIP_ENTRY_CACHE_HPP */
@@ -0,0 +1,402 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zip_extract.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 12:05 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_ZIP_EXTRACT_HPP
+#define STATICLIB_COMPRESS_ZIP_EXTRACT_HPP
+
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <unordered_map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <windows.h>
+#else // !_WIN32
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/worker_pool.hpp"
+#include "staticlib/compress/zip_entry.hpp"
+#include "staticlib/compress/zip_reader.hpp"
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+#ifdef _WIN32
+inline std::wstring extract_widen(const std::string& path) {
+    if (path.empty()) return std::wstring();
+    int len = ::MultiByteToWideChar(CP_UTF8, 0, path.data(), static_cast<int>(path.length()), nullptr, 0);
+    if (len <= 0) throw compress_exception(TRACEMSG(
+            "Invalid UTF-8 path: [" + path + "]"));
+    auto res = std::wstring();
+    res.resize(static_cast<size_t>(len));
+    ::MultiByteToWideChar(CP_UTF8, 0, path.data(), static_cast<int>(path.length()), &res.front(), len);
+    return res;
+}
+#endif // _WIN32
+
+/**
+ * Converts ZIP entry name into a path relative to the destination directory,
+ * rejects names that can point outside of it ("zip slip")
+ */
+inline std::string extract_relative_path(const std::string& name) {
+    if (name.empty()) throw compress_exception(TRACEMSG(
+            "Invalid empty ZIP entry name"));
+    if ('/' == name[0] || '\\' == name[0]) throw compress_exception(TRACEMSG(
+            "Invalid absolute ZIP entry name: [" + name + "]"));
+    if (name.length() >= 2 && ':' == name[1]) throw compress_exception(TRACEMSG(
+            "Invalid ZIP entry name with drive letter: [" + name + "]"));
+    auto res = std::string();
+    size_t start = 0;
+    while (start < name.length()) {
+        size_t end = name.find_first_of("/\\", start);
+        if (std::string::npos == end) {
+            end = name.length();
+        }
+        auto part = name.substr(start, end - start);
+        if (".." == part) throw compress_exception(TRACEMSG(
+                "Invalid ZIP entry name pointing outside of destination directory: [" + name + "]"));
+        if (std::string::npos != part.find('\0') || std::string::npos != part.find(':')) throw compress_exception(TRACEMSG(
+                "Invalid character in ZIP entry name: [" + name + "]"));
+        if (!part.empty() && "." != part) {
+            if (!res.empty()) {
+                res.push_back('/');
+            }
+            res.append(part);
+        }
+        start = end + 1;
+    }
+    if (res.empty()) throw compress_exception(TRACEMSG(
+            "Invalid ZIP entry name: [" + name + "]"));
+    return res;
+}
+
+/**
+ * Creates a single directory, existing directory is not an error
+ */
+inline void extract_create_directory(const std::string& path) {
+#ifdef _WIN32
+    auto wpath = extract_widen(path);
+    if (0 == ::CreateDirectoryW(wpath.c_str(), nullptr)) {
+        auto code = ::GetLastError();
+        if (ERROR_ALREADY_EXISTS != code) throw compress_exception(TRACEMSG(
+                "Error creating directory: [" + path + "]," +
+                " code: [" + sl::support::to_string(code) + "]"));
+    }
+#else // !_WIN32
+    if (0 != ::mkdir(path.c_str(), 0755)) {
+        int code = errno;
+        struct stat st;
+        if (EEXIST != code || 0 != ::stat(path.c_str(), std::addressof(st)) || !S_ISDIR(st.st_mode)) {
+            throw compress_exception(TRACEMSG(
+                    "Error creating directory: [" + path + "]," +
+                    " error: [" + ::strerror(code) + "]"));
+        }
+    }
+#endif // _WIN32
+}
+
+/**
+ * Write-only file sink for extracted entries, file space
+ * is preallocated upfront where supported by platform
+ */
+class extract_file_sink {
+    std::string path;
+#ifdef _WIN32
+    HANDLE handle = INVALID_HANDLE_VALUE;
+#else // !_WIN32
+    int fd = -1;
+#endif // _WIN32
+
+public:
+    extract_file_sink(const std::string& path, uint64_t size) :
+    path(path) {
+#ifdef _WIN32
+        auto wpath = extract_widen(path);
+        handle = ::CreateFileW(wpath.c_str(), GENERIC_WRITE, 0, nullptr,
+                CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (INVALID_HANDLE_VALUE == handle) throw compress_exception(TRACEMSG(
+                "Error opening file: [" + path + "]," +
+                " code: [" + sl::support::to_string(::GetLastError()) + "]"));
+        if (size > 0) {
+            // failure is not fatal, file is written anyway
+            FILE_ALLOCATION_INFO info;
+            info.AllocationSize.QuadPart = static_cast<LONGLONG>(size);
+            ::SetFileInformationByHandle(handle, FileAllocationInfo, std::addressof(info), sizeof(info));
+        }
+#else // !_WIN32
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (-1 == fd) throw compress_exception(TRACEMSG(
+                "Error opening file: [" + path + "]," +
+                " error: [" + ::strerror(errno) + "]"));
+#ifdef __linux__
+        if (size > 0) {
+            // failure is not fatal (e.g. filesystem without fallocate support),
+            // file is written anyway
+            ::posix_fallocate(fd, 0, static_cast<off_t>(size));
+        }
+#else // !__linux__
+        (void) size;
+#endif // __linux__
+#endif // _WIN32
+    }
+
+    ~extract_file_sink() STATICLIB_NOEXCEPT {
+        close();
+    }
+
+    extract_file_sink(const extract_file_sink&) = delete;
+
+    extract_file_sink& operator=(const extract_file_sink&) = delete;
+
+    extract_file_sink(extract_file_sink&& other) :
+    path(std::move(other.path)) {
+#ifdef _WIN32
+        handle = other.handle;
+        other.handle = INVALID_HANDLE_VALUE;
+#else // !_WIN32
+        fd = other.fd;
+        other.fd = -1;
+#endif // _WIN32
+    }
+
+    extract_file_sink& operator=(extract_file_sink&& other) {
+        close();
+        path = std::move(other.path);
+#ifdef _WIN32
+        handle = other.handle;
+        other.handle = INVALID_HANDLE_VALUE;
+#else // !_WIN32
+        fd = other.fd;
+        other.fd = -1;
+#endif // _WIN32
+        return *this;
+    }
+
+    std::streamsize write(sl::io::span<const char> span) {
+#ifdef _WIN32
+        DWORD written = 0;
+        auto len = static_cast<DWORD>(std::min(span.size(), static_cast<size_t>(1 << 30)));
+        if (0 == ::WriteFile(handle, span.data(), len, std::addressof(written), nullptr)) {
+            throw compress_exception(TRACEMSG(
+                    "Error writing file: [" + path + "]," +
+                    " code: [" + sl::support::to_string(::GetLastError()) + "]"));
+        }
+        return static_cast<std::streamsize>(written);
+#else // !_WIN32
+        for (;;) {
+            auto res = ::write(fd, span.data(), span.size());
+            if (res >= 0) {
+                return static_cast<std::streamsize>(res);
+            }
+            if (EINTR != errno) throw compress_exception(TRACEMSG(
+                    "Error writing file: [" + path + "]," +
+                    " error: [" + ::strerror(errno) + "]"));
+        }
+#endif // _WIN32
+    }
+
+    std::streamsize flush() {
+        return 0;
+    }
+
+private:
+    void close() STATICLIB_NOEXCEPT {
+#ifdef _WIN32
+        if (INVALID_HANDLE_VALUE != handle) {
+            ::CloseHandle(handle);
+            handle = INVALID_HANDLE_VALUE;
+        }
+#else // !_WIN32
+        if (-1 != fd) {
+            ::close(fd);
+            fd = -1;
+        }
+#endif // _WIN32
+    }
+};
+
+} // namespace
+
+/**
+ * Extracts specified ZIP entries using a pool of worker threads.
+ * Entries are handed out to workers starting from the largest compressed
+ * ones, so the workers finish at roughly the same time. Each worker
+ * opens its own archive source and inflates independently, CRC-32 of
+ * every entry is checked. Directory entries are skipped - sink factory
+ * is expected to create parent directories when necessary.
+ *
+ * @param entries entries to extract, usually obtained with "read_zip_central_directory"
+ * @param source_factory thread-safe callable that opens a new seekable source of the archive
+ * @param sink_factory thread-safe callable that takes "const zip_entry&" and returns
+ *        the destination sink for this entry, "zip_entry::get_uncompressed_size()"
+ *        may be used by it to preallocate the destination file
+ * @param threads number of worker threads, hardware concurrency is used if zero
+ * @throws compress_exception on first error in any of the workers
+ */
+template <typename SourceFactory, typename SinkFactory,
+        class = typename std::enable_if<!std::is_convertible<SinkFactory, std::string>::value>::type>
+void extract_all(const std::vector<zip_entry>& entries, SourceFactory source_factory,
+        SinkFactory sink_factory, size_t threads = 0) {
+    auto order = std::vector<size_t>();
+    order.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (!entries[i].is_directory()) {
+            order.push_back(i);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&entries](size_t a, size_t b) {
+        return entries[a].get_compressed_size() > entries[b].get_compressed_size();
+    });
+    std::atomic<size_t> next(0);
+    detail::run_workers(detail::workers_count(threads, order.size()), [&](const std::atomic<bool>& failed) {
+        auto src = source_factory();
+        for (;;) {
+            size_t idx = next.fetch_add(1);
+            if (idx >= order.size() || failed.load()) break;
+            const zip_entry& en = entries[order[idx]];
+            auto entry_src = make_zip_entry_source(src, en);
+            auto sink = sink_factory(en);
+            sl::io::copy_all(entry_src, sink);
+        }
+    });
+}
+
+/**
+ * Extracts all entries of the ZIP archive using a pool of worker threads,
+ * see the overload above for details
+ *
+ * @param source_factory thread-safe callable that opens a new seekable source of the archive
+ * @param sink_factory thread-safe callable that takes "const zip_entry&" and returns
+ *        the destination sink for this entry
+ * @param threads number of worker threads, hardware concurrency is used if zero
+ * @return number of entries in archive
+ */
+template <typename SourceFactory, typename SinkFactory,
+        class = typename std::enable_if<!std::is_convertible<SinkFactory, std::string>::value>::type>
+size_t extract_all(SourceFactory source_factory, SinkFactory sink_factory, size_t threads = 0) {
+    auto entries = [&source_factory] {
+        auto src = source_factory();
+        return read_zip_central_directory(src);
+    }();
+    extract_all(entries, source_factory, sink_factory, threads);
+    return entries.size();
+}
+
+/**
+ * Extracts specified ZIP entries into the destination directory using
+ * a pool of worker threads, see the overload above for details.
+ * All entry names are checked before extraction starts, names that are
+ * absolute, contain drive letters or ".." components are rejected, so
+ * files are never written outside of the destination directory.
+ * Directory entries and parent directories of file entries are created
+ * upfront, existing files are overwritten. Space for each file is
+ * preallocated using uncompressed size from the Central Directory.
+ *
+ * @param entries entries to extract, usually obtained with "read_zip_central_directory"
+ * @param source_factory thread-safe callable that opens a new seekable source of the archive
+ * @param dest_dir destination directory, is created if it does not exist,
+ *        its parent directory must exist
+ * @param threads number of worker threads, hardware concurrency is used if zero
+ * @throws compress_exception on invalid entry name or on first error in any of the workers
+ */
+template <typename SourceFactory>
+void extract_all(const std::vector<zip_entry>& entries, SourceFactory source_factory,
+        const std::string& dest_dir, size_t threads = 0) {
+    if (dest_dir.empty()) throw compress_exception(TRACEMSG(
+            "Invalid empty destination directory"));
+    auto paths = std::vector<std::string>();
+    paths.reserve(entries.size());
+    auto dirs = std::set<std::string>();
+    for (auto& en : entries) {
+        auto rel = detail::extract_relative_path(en.get_name());
+        size_t pos = en.is_directory() ? rel.length() : rel.rfind('/');
+        while (std::string::npos != pos && 0 != pos) {
+            dirs.insert(rel.substr(0, pos));
+            pos = rel.rfind('/', pos - 1);
+        }
+        paths.emplace_back(std::move(rel));
+    }
+    auto prefix = dest_dir;
+    if ('/' != prefix.back() && '\\' != prefix.back()) {
+        prefix.push_back('/');
+    }
+    detail::extract_create_directory(dest_dir);
+    // set is ordered, parents are created before children
+    for (auto& dir : dirs) {
+        detail::extract_create_directory(prefix + dir);
+    }
+    auto index = std::unordered_map<const zip_entry*, size_t>();
+    for (size_t i = 0; i < entries.size(); i++) {
+        index.emplace(std::addressof(entries[i]), i);
+    }
+    extract_all(entries, source_factory, [&](const zip_entry& en) {
+        return detail::extract_file_sink(prefix + paths[index.at(std::addressof(en))],
+                en.get_uncompressed_size());
+    }, threads);
+}
+
+/**
+ * Extracts all entries of the ZIP archive into the destination directory
+ * using a pool of worker threads, see the overload above for details
+ *
+ * @param source_factory thread-safe callable that opens a new seekable source of the archive
+ * @param dest_dir destination directory, is created if it does not exist,
+ *        its parent directory must exist
+ * @param threads number of worker threads, hardware concurrency is used if zero
+ * @return number of entries in archive
+ */
+template <typename SourceFactory>
+size_t extract_all(SourceFactory source_factory, const std::string& dest_dir, size_t threads = 0) {
+    auto entries = [&source_factory] {
+        auto src = source_factory();
+        return read_zip_central_directory(src);
+    }();
+    extract_all(entries, source_factory, dest_dir, threads);
+    return entries.size();
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_ZIP_EXTRACT_HPP */
+
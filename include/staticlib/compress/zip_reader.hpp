@@ -0,0 +1,439 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zip_reader.hpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 10:40 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_ZIP_READER_HPP
+#define STATICLIB_COMPRESS_ZIP_READER_HPP
+
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <ios>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/inflate_source.hpp"
+#include "staticlib/compress/seekable.hpp"
+#include "staticlib/compress/zip_compression_method.hpp"
+#include "staticlib/compress/zip_entry.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+inline uint16_t decode_16_le(const char* data) {
+    auto ptr = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint16_t>(ptr[0] | (ptr[1] << 8));
+}
+
+inline uint32_t decode_32_le(const char* data) {
+    auto ptr = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint32_t>(ptr[0]) |
+            (static_cast<uint32_t>(ptr[1]) << 8) |
+            (static_cast<uint32_t>(ptr[2]) << 16) |
+            (static_cast<uint32_t>(ptr[3]) << 24);
+}
+
+inline uint64_t decode_64_le(const char* data) {
+    return static_cast<uint64_t>(decode_32_le(data)) |
+            (static_cast<uint64_t>(decode_32_le(data + 4)) << 32);
+}
+
+/**
+ * Reads values from ZIP64 extended information extra field (0x0001),
+ * field contains only the values that are set to 0xFFFFFFFF in the
+ * fixed part of the record, in the order: uncompressed size,
+ * compressed size, local header offset
+ *
+ * @return true if ZIP64 extra field is present
+ */
+inline bool read_zip64_extra(const std::string& name, const char* extra, size_t extra_len,
+        uint64_t& uncompressed_size, uint64_t& compressed_size, uint64_t& offset) {
+    size_t pos = 0;
+    while (pos + 4 <= extra_len) {
+        uint16_t id = decode_16_le(extra + pos);
+        uint16_t len = decode_16_le(extra + pos + 2);
+        pos += 4;
+        if (pos + len > extra_len) break;
+        if (0x0001 == id) {
+            const char* field = extra + pos;
+            const char* end = field + len;
+            for (uint64_t* val : {&uncompressed_size, &compressed_size, &offset}) {
+                if (UINT32_MAX != *val) continue;
+                if (field + 8 > end) throw compress_exception(TRACEMSG(
+                        "Invalid ZIP64 extra field, entry: [" + name + "]"));
+                *val = decode_64_le(field);
+                field += 8;
+            }
+            return true;
+        }
+        pos += len;
+    }
+    if (UINT32_MAX == uncompressed_size || UINT32_MAX == compressed_size || UINT32_MAX == offset) {
+        throw compress_exception(TRACEMSG(
+                "ZIP64 extra field not found, entry: [" + name + "]"));
+    }
+    return false;
+}
+
+/**
+ * Source wrapper that reads not more than the specified number of bytes
+ */
+template <typename Source>
+class limited_source {
+    Source src;
+    uint64_t remaining;
+
+public:
+    limited_source(Source&& src, uint64_t limit) :
+    src(std::move(src)),
+    remaining(limit) { }
+
+    limited_source(const limited_source&) = delete;
+
+    limited_source& operator=(const limited_source&) = delete;
+
+    limited_source(limited_source&& other) :
+    src(std::move(other.src)),
+    remaining(other.remaining) { }
+
+    limited_source& operator=(limited_source&& other) {
+        src = std::move(other.src);
+        remaining = other.remaining;
+        return *this;
+    }
+
+    std::streamsize read(sl::io::span<char> span) {
+        if (0 == remaining) return std::char_traits<char>::eof();
+        size_t len = static_cast<size_t>(std::min(static_cast<uint64_t>(span.size()), remaining));
+        auto res = src.read({span.data(), len});
+        if (std::char_traits<char>::eof() == res) throw compress_exception(TRACEMSG(
+                "Unexpected end of ZIP entry data, bytes remaining: [" + sl::support::to_string(remaining) + "]"));
+        remaining -= static_cast<uint64_t>(res);
+        return res;
+    }
+
+    Source& get_source() {
+        return src;
+    }
+
+};
+
+/**
+ * Central Directory of the archive as it is stored on disk
+ */
+class central_directory {
+public:
+    uint64_t count = 0;
+    uint64_t offset = 0;
+    std::string records;
+    std::string comment;
+};
+
+/**
+ * Finds EOCD in the specified seekable source and reads
+ * all the Central Directory records with a single call,
+ * ZIP64 EOCD record is used when EOCD fields are saturated
+ */
+template <typename Source>
+central_directory read_central_directory(Source& src) {
+    // find EOCD, it is followed only by the archive comment
+    const size_t eocd_len = 22;
+    uint64_t archive_len = seek_to(src, 0, 'e');
+    if (archive_len < eocd_len) throw compress_exception(TRACEMSG(
+            "Invalid ZIP archive, length: [" + sl::support::to_string(archive_len) + "]"));
+    uint64_t tail_len = std::min(archive_len, static_cast<uint64_t>(eocd_len + UINT16_MAX));
+    seek_to(src, static_cast<int64_t>(archive_len - tail_len));
+    auto tail = std::vector<char>();
+    tail.resize(static_cast<size_t>(tail_len));
+    sl::io::read_exact(src, {tail.data(), tail.size()});
+    size_t eocd_pos = tail.size() - eocd_len;
+    for (;;) {
+        if (0x06054b50 == decode_32_le(tail.data() + eocd_pos)) break;
+        if (0 == eocd_pos) throw compress_exception(TRACEMSG(
+                "Invalid ZIP archive: End Of Central Directory record not found"));
+        eocd_pos -= 1;
+    }
+    const char* eocd = tail.data() + eocd_pos;
+    auto res = central_directory();
+    res.count = decode_16_le(eocd + 10);
+    uint64_t cd_len = decode_32_le(eocd + 12);
+    res.offset = decode_32_le(eocd + 16);
+    size_t comment_len = std::min(static_cast<size_t>(decode_16_le(eocd + 20)),
+            tail.size() - eocd_pos - eocd_len);
+    res.comment = std::string(eocd + eocd_len, comment_len);
+    if (UINT16_MAX == res.count || UINT32_MAX == cd_len || UINT32_MAX == res.offset) {
+        // ZIP64 EOCD locator precedes EOCD
+        const size_t locator_len = 20;
+        const size_t eocd64_len = 56;
+        uint64_t eocd_offset = archive_len - tail_len + eocd_pos;
+        if (eocd_offset < locator_len + eocd64_len) throw compress_exception(TRACEMSG(
+                "Invalid ZIP64 archive: End Of Central Directory locator not found"));
+        auto locator = std::array<char, locator_len>();
+        seek_to(src, static_cast<int64_t>(eocd_offset - locator_len));
+        sl::io::read_exact(src, {locator.data(), locator.size()});
+        if (0x07064b50 != decode_32_le(locator.data())) throw compress_exception(TRACEMSG(
+                "Invalid ZIP64 archive: End Of Central Directory locator not found"));
+        uint64_t eocd64_offset = decode_64_le(locator.data() + 8);
+        if (eocd64_offset > eocd_offset - locator_len - eocd64_len) throw compress_exception(TRACEMSG(
+                "Invalid ZIP64 End Of Central Directory offset: [" + sl::support::to_string(eocd64_offset) + "]"));
+        auto eocd64 = std::array<char, eocd64_len>();
+        seek_to(src, static_cast<int64_t>(eocd64_offset));
+        sl::io::read_exact(src, {eocd64.data(), eocd64.size()});
+        if (0x06064b50 != decode_32_le(eocd64.data())) throw compress_exception(TRACEMSG(
+                "Invalid ZIP64 archive: End Of Central Directory record not found"));
+        res.count = decode_64_le(eocd64.data() + 32);
+        cd_len = decode_64_le(eocd64.data() + 40);
+        res.offset = decode_64_le(eocd64.data() + 48);
+    }
+    if (res.offset > archive_len || cd_len > archive_len - res.offset ||
+            cd_len > static_cast<uint64_t>(SIZE_MAX)) throw compress_exception(TRACEMSG(
+            "Invalid ZIP archive, Central Directory offset: [" + sl::support::to_string(res.offset) + "]," +
+            " length: [" + sl::support::to_string(cd_len) + "]"));
+    // every record takes at least 46 bytes
+    if (res.count > cd_len / 46) throw compress_exception(TRACEMSG(
+            "Invalid ZIP archive, entries count: [" + sl::support::to_string(res.count) + "]," +
+            " Central Directory length: [" + sl::support::to_string(cd_len) + "]"));
+    if (cd_len > 0) {
+        seek_to(src, static_cast<int64_t>(res.offset));
+        res.records.resize(static_cast<size_t>(cd_len));
+        sl::io::read_exact(src, {&res.records.front(), res.records.size()});
+    }
+    return res;
+}
+
+/**
+ * Seeks the specified source to the start of entry data
+ * and limits it to the compressed size of the entry
+ */
+template <typename Source>
+limited_source<Source> open_entry_data(Source&& src, const zip_entry& entry) {
+    seek_to(src, static_cast<int64_t>(entry.get_offset()));
+    auto lfh = std::array<char, 30>();
+    sl::io::read_exact(src, {lfh.data(), lfh.size()});
+    if (0x04034b50 != decode_32_le(lfh.data())) throw compress_exception(TRACEMSG(
+            "Invalid local file header, entry: [" + entry.get_name() + "]"));
+    // local name and extra field lengths may differ from the CD ones
+    uint32_t skip = decode_16_le(lfh.data() + 26) + decode_16_le(lfh.data() + 28);
+    seek_to(src, skip, 'c');
+    return limited_source<Source>(std::move(src), entry.get_compressed_size());
+}
+
+} // namespace
+
+/**
+ * Reads Central Directory of the ZIP archive from the specified seekable source,
+ * source must provide "seek(offset, whence)" method (see "sl::tinydir::file_source"),
+ * ZIP64 archives (more than 65535 entries or sizes and offsets over 4GB) are supported
+ *
+ * @param src seekable source
+ * @return list of entries in the order they are recorded in Central Directory
+ */
+template <typename Source>
+std::vector<zip_entry> read_zip_central_directory(Source& src) {
+    auto cd = detail::read_central_directory(src);
+    auto res = std::vector<zip_entry>();
+    res.reserve(static_cast<size_t>(cd.count));
+    size_t pos = 0;
+    for (uint64_t i = 0; i < cd.count; i++) {
+        const char* rec = cd.records.data() + pos;
+        if (pos + 46 > cd.records.size() || 0x02014b50 != detail::decode_32_le(rec)) {
+            throw compress_exception(TRACEMSG(
+                    "Invalid Central Directory record, index: [" + sl::support::to_string(i) + "]"));
+        }
+        uint16_t name_len = detail::decode_16_le(rec + 28);
+        uint16_t extra_len = detail::decode_16_le(rec + 30);
+        uint16_t comment_len = detail::decode_16_le(rec + 32);
+        size_t rec_len = 46 + name_len + extra_len + comment_len;
+        if (pos + rec_len > cd.records.size()) throw compress_exception(TRACEMSG(
+                "Invalid Central Directory record, index: [" + sl::support::to_string(i) + "]"));
+        auto name = std::string(rec + 46, name_len);
+        uint64_t compressed_size = detail::decode_32_le(rec + 20);
+        uint64_t uncompressed_size = detail::decode_32_le(rec + 24);
+        uint64_t offset = detail::decode_32_le(rec + 42);
+        detail::read_zip64_extra(name, rec + 46 + name_len, extra_len,
+                uncompressed_size, compressed_size, offset);
+        res.emplace_back(std::move(name),
+                static_cast<zip_compression_method>(detail::decode_16_le(rec + 10)),
+                detail::decode_16_le(rec + 8),
+                detail::decode_32_le(rec + 16),
+                compressed_size,
+                uncompressed_size,
+                offset);
+        pos += rec_len;
+    }
+    return res;
+}
+
+/**
+ * Source that reads data of a single ZIP entry from a seekable source,
+ * inflates it if necessary and checks its CRC-32 and size after
+ * all the data is read
+ */
+template <typename Source>
+class zip_entry_source {
+    using raw_source_type = detail::limited_source<Source>;
+    using inflater_type = inflate_source<sl::io::reference_source<raw_source_type>>;
+
+    /**
+     * Source of the entry data as it is stored in archive
+     */
+    raw_source_type raw;
+    /**
+     * Inflater, is used only with "deflate" compression method
+     */
+    std::unique_ptr<inflater_type> inflater;
+    /**
+     * Expected CRC-32
+     */
+    uint32_t expected_crc;
+    /**
+     * Expected uncompressed size
+     */
+    uint64_t expected_size;
+    /**
+     * CRC-32 of the data read so far
+     */
+    uint32_t crc;
+    /**
+     * Number of bytes read so far
+     */
+    uint64_t count = 0;
+
+public:
+    /**
+     * Constructor, seeks the specified source to the start of entry data
+     *
+     * @param src seekable source of the ZIP archive
+     * @param entry entry to read
+     */
+    zip_entry_source(Source&& src, const zip_entry& entry) :
+    raw(detail::open_entry_data(std::move(src), check_method(entry))),
+    inflater(zip_compression_method::deflate == entry.get_method() ?
+            new inflater_type(sl::io::make_reference_source(raw)) : nullptr),
+    expected_crc(entry.get_crc()),
+    expected_size(entry.get_uncompressed_size()),
+    crc(0) { }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    zip_entry_source(const zip_entry_source&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    zip_entry_source& operator=(const zip_entry_source&) = delete;
+
+    /**
+     * Read implementation
+     *
+     * @param span output span
+     * @return number of bytes written into specified span
+     */
+    std::streamsize read(sl::io::span<char> span) {
+        auto res = nullptr != inflater.get() ? inflater->read(span) : raw.read(span);
+        if (std::char_traits<char>::eof() != res) {
+            crc = detail::zlib_crc32(crc, span.data(), res);
+            count += static_cast<uint64_t>(res);
+        } else if (crc != expected_crc || count != expected_size) {
+            throw compress_exception(TRACEMSG("ZIP entry check failed," +
+                    " expected CRC-32: [" + sl::support::to_string(expected_crc) + "]," +
+                    " actual CRC-32: [" + sl::support::to_string(crc) + "]," +
+                    " expected size: [" + sl::support::to_string(expected_size) + "]," +
+                    " actual size: [" + sl::support::to_string(count) + "]"));
+        }
+        return res;
+    }
+
+    /**
+     * Underlying source accessor
+     *
+     * @return underlying source reference
+     */
+    Source& get_source() {
+        return raw.get_source();
+    }
+
+private:
+    static const zip_entry& check_method(const zip_entry& entry) {
+        if (zip_compression_method::store != entry.get_method() &&
+                zip_compression_method::deflate != entry.get_method()) {
+            throw compress_exception(TRACEMSG("Unsupported compression method," +
+                    " entry: [" + entry.get_name() + "]," +
+                    " method: [" + sl::support::to_string(static_cast<uint16_t>(entry.get_method())) + "]"));
+        }
+        return entry;
+    }
+
+};
+
+/**
+ * Factory function for creating ZIP entry sources,
+ * created object will own the specified source
+ *
+ * @param source seekable source of the ZIP archive
+ * @param entry entry to read
+ * @return ZIP entry source
+ */
+template <typename Source,
+class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+sl::io::unique_source<zip_entry_source<Source>> make_zip_entry_source(Source&& source, const zip_entry& entry) {
+    auto ptr = new zip_entry_source<Source>(std::move(source), entry);
+    return sl::io::make_unique_source(ptr);
+}
+
+/**
+ * Factory function for creating ZIP entry sources,
+ * created object will NOT own the specified source
+ *
+ * @param source seekable source of the ZIP archive
+ * @param entry entry to read
+ * @return ZIP entry source
+ */
+template <typename Source>
+sl::io::unique_source<zip_entry_source<sl::io::reference_source<Source>>> make_zip_entry_source(
+        Source& source, const zip_entry& entry) {
+    auto ptr = new zip_entry_source<sl::io::reference_source<Source>>(
+            sl::io::make_reference_source(source), entry);
+    return sl::io::make_unique_source(ptr);
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_ZIP_READER_HPP */
+
@@ -24,86 +24,216 @@
 #ifndef STATICLIB_COMPRESS_ZIP_SINK_HPP
 #define STATICLIB_COMPRESS_ZIP_SINK_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
 #include <ios>
 #include <memory>
 #include <string>
-#include <vector>
-
-#include "zlib.h"
 
 #include "staticlib/config.hpp"
 #include "staticlib/io.hpp"
-#include "staticlib/endian.hpp"
+#include "staticlib/support.hpp"
 
 #include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/deflate_buffer.hpp"
 #include "staticlib/compress/deflate_sink.hpp"
 #include "staticlib/compress/zip_compression_method.hpp"
+#include "staticlib/compress/zip_reader.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
 
 namespace staticlib {
 namespace compress {
 
 namespace detail {
 
+/**
+ * Serializes 16-bit value in little-endian order
+ *
+ * @param dest destination buffer
+ * @param val value
+ * @return pointer to the byte after the serialized value
+ */
+inline char* put_16_le(char* dest, uint16_t val) {
+    dest[0] = static_cast<char>(val & 0xff);
+    dest[1] = static_cast<char>(val >> 8);
+    return dest + 2;
+}
+
+/**
+ * Serializes 32-bit value in little-endian order
+ *
+ * @param dest destination buffer
+ * @param val value
+ * @return pointer to the byte after the serialized value
+ */
+inline char* put_32_le(char* dest, uint32_t val) {
+    dest[0] = static_cast<char>(val & 0xff);
+    dest[1] = static_cast<char>((val >> 8) & 0xff);
+    dest[2] = static_cast<char>((val >> 16) & 0xff);
+    dest[3] = static_cast<char>(val >> 24);
+    return dest + 4;
+}
+
+/**
+ * Serializes 64-bit value in little-endian order
+ *
+ * @param dest destination buffer
+ * @param val value
+ * @return pointer to the byte after the serialized value
+ */
+inline char* put_64_le(char* dest, uint64_t val) {
+    dest = put_32_le(dest, static_cast<uint32_t>(val & 0xffffffff));
+    return put_32_le(dest, static_cast<uint32_t>(val >> 32));
+}
+
+/**
+ * Checks whether the specified size or offset does not fit into
+ * ZIP32 field, 0xFFFFFFFF in such fields denotes ZIP64 value
+ *
+ * @param value size or offset
+ * @return true if value must be written into ZIP64 extra field
+ */
+inline bool is_zip64_value(uint64_t value) {
+    return value >= UINT32_MAX;
+}
+
+/**
+ * Converts the specified size or offset into ZIP32 field value
+ *
+ * @param value size or offset
+ * @return value itself or 0xFFFFFFFF if it does not fit
+ */
+inline uint32_t zip32_field(uint64_t value) {
+    return is_zip64_value(value) ? UINT32_MAX : static_cast<uint32_t>(value);
+}
+
 /**
  * https://en.wikipedia.org/wiki/Zip_%28file_format%29
+ * 
+ * Every header is serialized into a buffer and is written
+ * with a single call to the destination sink. Sizes and offsets
+ * over 4GB are written into ZIP64 extended information extra field.
  */   
 class Header {
     std::string filename;
     uint16_t compression_method;
+    // bit 3: sizes and CRC are written in data descriptor
+    uint16_t flags = 8;
     
-    uint32_t offset = 0;
-    uint32_t compressed_size = 0;
-    uint32_t uncompressed_size = 0;
+    uint64_t offset = 0;
+    uint64_t compressed_size = 0;
+    uint64_t uncompressed_size = 0;
     uint32_t crc = 0;
     
 public:
-    
+    /**
+     * Size of the fixed part of Local File Header
+     */
+    static const size_t lfh_size = 30;
+    /**
+     * Size of the fixed part of Central Directory record
+     */
+    static const size_t cd_record_size = 46;
+
+    Header() :
+    compression_method(0) { }
+
     Header(std::string filename, uint16_t compression_method) :
     filename(std::move(filename)),
     compression_method(compression_method) { }
 
+    Header(std::string filename, uint16_t compression_method, uint16_t flags, 
+            uint64_t compressed_size, uint64_t uncompressed_size, uint32_t crc) :
+    filename(std::move(filename)),
+    compression_method(compression_method),
+    flags(flags & ~8),
+    compressed_size(compressed_size),
+    uncompressed_size(uncompressed_size),
+    crc(crc) { }
+
     template <typename Sink>
-    void write_local_file_header(Sink& sink, uint32_t offset) {
-        namespace en = staticlib::endian;
+    void write_local_file_header(Sink& sink, uint64_t offset) {
+        // sizes are known upfront only for entries without data descriptor,
+        // ZIP64 extra field in local header must contain both of them
+        bool zip64 = is_zip64_value(compressed_size) || is_zip64_value(uncompressed_size);
+        std::array<char, 512> buf;
+        std::array<char, 20> extra;
+        size_t extra_len = 0;
+        if (zip64) {
+            char* eptr = extra.data();
+            // ZIP64 extended information extra field tag and size
+            eptr = put_16_le(eptr, 0x0001);
+            eptr = put_16_le(eptr, 16);
+            // Original uncompressed file size
+            eptr = put_64_le(eptr, uncompressed_size);
+            // Size of compressed data
+            put_64_le(eptr, compressed_size);
+            extra_len = extra.size();
+        }
+        char* ptr = buf.data();
         // Local file header signature
-        en::write_32_le(sink, 0x04034b50);
+        ptr = put_32_le(ptr, 0x04034b50);
         // Version needed to extract (minimum)
-        en::write_16_le(sink, 10);
+        ptr = put_16_le(ptr, zip64 ? 45 : 10);
         // General purpose bit flag
-        en::write_16_le(sink, 8);
+        ptr = put_16_le(ptr, flags);
         // Compression method
-        en::write_16_le(sink, compression_method);
+        ptr = put_16_le(ptr, compression_method);
         // File last modification time
-        en::write_16_le(sink, 0);
+        ptr = put_16_le(ptr, 0);
         // File last modification date
-        en::write_16_le(sink, 0);
+        ptr = put_16_le(ptr, 0);
         // CRC-32
-        en::write_32_le(sink, 0);
+        ptr = put_32_le(ptr, crc);
         // Compressed size
-        en::write_32_le(sink, 0);
+        ptr = put_32_le(ptr, zip32_field(compressed_size));
         // Uncompressed size
-        en::write_32_le(sink, 0);
+        ptr = put_32_le(ptr, zip32_field(uncompressed_size));
         // File name length (n)
-        en::write_16_le(sink, filename.length());
+        ptr = put_16_le(ptr, static_cast<uint16_t>(filename.length()));
         // Extra field length (m)
-        en::write_16_le(sink, 0);
-        // File name
-        io::write_all(sink, {filename.data(), filename.length()});
+        ptr = put_16_le(ptr, static_cast<uint16_t>(extra_len));
+        // File name and extra field, long names are written separately
+        if (filename.length() + extra_len <= buf.size() - lfh_size) {
+            std::memcpy(ptr, filename.data(), filename.length());
+            std::memcpy(ptr + filename.length(), extra.data(), extra_len);
+            io::write_all(sink, {buf.data(), lfh_size + filename.length() + extra_len});
+        } else {
+            io::write_all(sink, {buf.data(), lfh_size});
+            io::write_all(sink, {filename.data(), filename.length()});
+            io::write_all(sink, {extra.data(), extra_len});
+        }
         // save offset for CD
         this->offset = offset;
     }
 
     template <typename Sink>
-    void write_data_descriptor(Sink& sink, uint32_t compressed_size, uint32_t uncompressed_size, uint32_t crc) {
-        namespace en = staticlib::endian;
+    void write_data_descriptor(Sink& sink, uint64_t compressed_size, uint64_t uncompressed_size, uint32_t crc) {
+        // sizes are not known when local header is written, so 8-byte sizes
+        // are used only when they do not fit, readers of ZIP64 archives
+        // take sizes from the Central Directory
+        bool zip64 = is_zip64_value(compressed_size) || is_zip64_value(uncompressed_size);
+        std::array<char, 24> buf;
+        char* ptr = buf.data();
         // Optional data descriptor signature 
-        en::write_32_le(sink, 0x08074b50);
+        ptr = put_32_le(ptr, 0x08074b50);
         // CRC-32
-        en::write_32_le(sink, crc);
-        // Compressed size
-        en::write_32_le(sink, compressed_size);
-        // Uncompressed size
-        en::write_32_le(sink, uncompressed_size);
+        ptr = put_32_le(ptr, crc);
+        if (zip64) {
+            // Compressed size
+            ptr = put_64_le(ptr, compressed_size);
+            // Uncompressed size
+            put_64_le(ptr, uncompressed_size);
+        } else {
+            // Compressed size
+            ptr = put_32_le(ptr, static_cast<uint32_t>(compressed_size));
+            // Uncompressed size
+            put_32_le(ptr, static_cast<uint32_t>(uncompressed_size));
+        }
+        size_t len = zip64 ? buf.size() : 16;
+        io::write_all(sink, {buf.data(), len});
         // save sizes for CD
         this->compressed_size = compressed_size;
         this->uncompressed_size = uncompressed_size;
@@ -111,95 +241,313 @@ public:
         this->crc = crc;
     }
 
-    template <typename Sink>
-    void write_cd_file_header(Sink& sink) { 
-        namespace en = staticlib::endian;
+    void append_cd_file_header(std::string& dest) const {
+        // ZIP64 extra field contains only the values that do not fit
+        std::array<char, 28> extra;
+        char* eptr = extra.data() + 4;
+        if (is_zip64_value(uncompressed_size)) {
+            eptr = put_64_le(eptr, uncompressed_size);
+        }
+        if (is_zip64_value(compressed_size)) {
+            eptr = put_64_le(eptr, compressed_size);
+        }
+        if (is_zip64_value(offset)) {
+            eptr = put_64_le(eptr, offset);
+        }
+        size_t extra_len = static_cast<size_t>(eptr - extra.data());
+        bool zip64 = extra_len > 4;
+        if (zip64) {
+            // ZIP64 extended information extra field tag and size
+            put_16_le(put_16_le(extra.data(), 0x0001), static_cast<uint16_t>(extra_len - 4));
+        } else {
+            extra_len = 0;
+        }
+        size_t start = dest.length();
+        dest.resize(start + cd_record_size);
+        char* ptr = &dest.front() + start;
         // Central directory file header signature
-        en::write_32_le(sink, 0x02014b50);
+        ptr = put_32_le(ptr, 0x02014b50);
         // Version made by
-        en::write_16_le(sink, 10);
+        ptr = put_16_le(ptr, zip64 ? 45 : 10);
         // Version needed to extract (minimum)
-        en::write_16_le(sink, 10);
+        ptr = put_16_le(ptr, zip64 ? 45 : 10);
         // General purpose bit flag
-        en::write_16_le(sink, 8);
+        ptr = put_16_le(ptr, flags);
         // Compression method
-        en::write_16_le(sink, compression_method);
+        ptr = put_16_le(ptr, compression_method);
         // File last modification time
-        en::write_16_le(sink, 0);
+        ptr = put_16_le(ptr, 0);
         // File last modification date
-        en::write_16_le(sink, 0);
+        ptr = put_16_le(ptr, 0);
         // CRC-32
-        en::write_32_le(sink, crc);
+        ptr = put_32_le(ptr, crc);
         // Compressed size
-        en::write_32_le(sink, compressed_size);
+        ptr = put_32_le(ptr, zip32_field(compressed_size));
         // Uncompressed size
-        en::write_32_le(sink, uncompressed_size);
+        ptr = put_32_le(ptr, zip32_field(uncompressed_size));
         // File name length (n)
-        en::write_16_le(sink, filename.length());
+        ptr = put_16_le(ptr, static_cast<uint16_t>(filename.length()));
         // Extra field length (m)
-        en::write_16_le(sink, 0);
+        ptr = put_16_le(ptr, static_cast<uint16_t>(extra_len));
         // File comment length (k)
-        en::write_16_le(sink, 0);
+        ptr = put_16_le(ptr, 0);
         // Disk number where file starts
-        en::write_16_le(sink, 0);
+        ptr = put_16_le(ptr, 0);
         // Internal file attributes
-        en::write_16_le(sink, 0);
+        ptr = put_16_le(ptr, 0);
         // External file attributes
-        en::write_32_le(sink, 0);
+        ptr = put_32_le(ptr, 0);
         // Relative offset of local file header.
-        en::write_32_le(sink, offset);
+        put_32_le(ptr, zip32_field(offset));
         // File name
-        io::write_all(sink, {filename.data(), filename.length()});
+        dest.append(filename);
+        // Extra field
+        dest.append(extra.data(), extra_len);
     }
     
 };
 
-template <typename Sink>
-void write_eocd(Sink& sink, uint16_t files_count, uint32_t cd_offset,  uint32_t cd_length) {
-    namespace en = staticlib::endian;
+/**
+ * Entries added from in-memory buffers up to this size are compressed
+ * with a single "deflate_into()" call, larger ones are streamed through
+ * "deflate_sink" to not double the memory used for them
+ */
+const size_t zip_whole_buffer_max_size = 1 << 22;
+
+/**
+ * Central Directory records spilled into a temporary file
+ * are read back in pieces of this size
+ */
+const size_t zip_cd_write_size = 1 << 16;
+
+/**
+ * Default in-memory limit for Central Directory records
+ */
+const size_t zip_cd_memory_limit = 1 << 24;
+
+/**
+ * Packed storage for Central Directory records of the written entries;
+ * records are kept serialized (fixed part followed by the name bytes)
+ * in a single buffer, when the buffer grows over the limit, it is
+ * spilled into a temporary file that is streamed back on "write_to()"
+ */
+class cd_arena {
+    std::string records;
+    size_t limit;
+    size_t count = 0;
+    size_t spilled = 0;
+    FILE* spill = nullptr;
+
+public:
+    /**
+     * Constructor
+     *
+     * @param limit max size of records kept in memory
+     */
+    explicit cd_arena(size_t limit) :
+    limit(limit) { }
+
+    ~cd_arena() STATICLIB_NOEXCEPT {
+        if (nullptr != spill) {
+            std::fclose(spill);
+        }
+    }
+
+    cd_arena(const cd_arena&) = delete;
+
+    cd_arena& operator=(const cd_arena&) = delete;
+
+    cd_arena(cd_arena&& other) :
+    records(std::move(other.records)),
+    limit(other.limit),
+    count(other.count),
+    spilled(other.spilled),
+    spill(other.spill) {
+        other.spill = nullptr;
+    }
+
+    cd_arena& operator=(cd_arena&& other) {
+        if (nullptr != spill) {
+            std::fclose(spill);
+        }
+        records = std::move(other.records);
+        limit = other.limit;
+        count = other.count;
+        spilled = other.spilled;
+        spill = other.spill;
+        other.spill = nullptr;
+        return *this;
+    }
+
+    void add(const Header& header) {
+        header.append_cd_file_header(records);
+        count += 1;
+        if (records.length() >= limit) {
+            spill_records();
+        }
+    }
+
+    size_t get_count() const {
+        return count;
+    }
+
+    size_t get_length() const {
+        return spilled + records.length();
+    }
+
+    bool is_spilled() const {
+        return nullptr != spill;
+    }
+
+    template <typename Sink>
+    void write_to(Sink& sink) {
+        if (nullptr != spill) {
+            if (0 != std::fseek(spill, 0, SEEK_SET)) throw compress_exception(TRACEMSG(
+                    "Error rewinding Central Directory temporary file"));
+            auto buf = std::string();
+            buf.resize(zip_cd_write_size);
+            size_t left = spilled;
+            while (left > 0) {
+                size_t len = std::min(left, buf.length());
+                if (len != std::fread(&buf.front(), 1, len, spill)) throw compress_exception(TRACEMSG(
+                        "Error reading Central Directory temporary file"));
+                io::write_all(sink, {buf.data(), len});
+                left -= len;
+            }
+        }
+        io::write_all(sink, {records.data(), records.length()});
+    }
+
+private:
+    void spill_records() {
+        if (nullptr == spill) {
+            spill = std::tmpfile();
+            if (nullptr == spill) throw compress_exception(TRACEMSG(
+                    "Error creating Central Directory temporary file"));
+        }
+        if (records.length() != std::fwrite(records.data(), 1, records.length(), spill)) {
+            throw compress_exception(TRACEMSG(
+                    "Error writing Central Directory temporary file, length: [" +
+                    sl::support::to_string(records.length()) + "]"));
+        }
+        spilled += records.length();
+        records.clear();
+    }
+};
+
+/**
+ * Checks whether ZIP64 EOCD record is required for the specified
+ * Central Directory, 0xFFFF and 0xFFFFFFFF in EOCD denote ZIP64 values
+ */
+inline bool is_zip64_eocd(uint64_t files_count, uint64_t cd_offset, uint64_t cd_length) {
+    return files_count >= UINT16_MAX || is_zip64_value(cd_offset) || is_zip64_value(cd_length);
+}
+
+inline void append_zip64_eocd(std::string& dest, uint64_t files_count, uint64_t cd_offset, uint64_t cd_length,
+        uint64_t eocd64_offset) {
+    std::array<char, 76> buf;
+    char* ptr = buf.data();
+    // ZIP64 end of central directory signature
+    ptr = put_32_le(ptr, 0x06064b50);
+    // Size of the remaining record
+    ptr = put_64_le(ptr, 44);
+    // Version made by
+    ptr = put_16_le(ptr, 45);
+    // Version needed to extract (minimum)
+    ptr = put_16_le(ptr, 45);
+    // Number of this disk
+    ptr = put_32_le(ptr, 0);
+    // Disk where central directory starts
+    ptr = put_32_le(ptr, 0);
+    // Number of central directory records on this disk
+    ptr = put_64_le(ptr, files_count);
+    // Total number of central directory records
+    ptr = put_64_le(ptr, files_count);
+    // Size of central directory (bytes)
+    ptr = put_64_le(ptr, cd_length);
+    // Offset of start of central directory
+    ptr = put_64_le(ptr, cd_offset);
+    // ZIP64 end of central directory locator signature
+    ptr = put_32_le(ptr, 0x07064b50);
+    // Disk where ZIP64 end of central directory starts
+    ptr = put_32_le(ptr, 0);
+    // Offset of ZIP64 end of central directory record
+    ptr = put_64_le(ptr, eocd64_offset);
+    // Total number of disks
+    put_32_le(ptr, 1);
+    dest.append(buf.data(), buf.size());
+}
+
+inline void append_eocd(std::string& dest, uint64_t files_count, uint64_t cd_offset, uint64_t cd_length,
+        const std::string& comment = std::string()) {
+    std::array<char, 22> buf;
+    char* ptr = buf.data();
     // End of central directory signature
-    en::write_32_le(sink, 0x06054b50);
+    ptr = put_32_le(ptr, 0x06054b50);
     // Number of this disk
-    en::write_16_le(sink, 0);
+    ptr = put_16_le(ptr, 0);
     // Disk where central directory starts
-    en::write_16_le(sink, 0);
+    ptr = put_16_le(ptr, 0);
     // Number of central directory records on this disk
-    en::write_16_le(sink, files_count);
+    uint16_t count16 = files_count >= UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(files_count);
+    ptr = put_16_le(ptr, count16);
     // Total number of central directory records
-    en::write_16_le(sink, files_count);
+    ptr = put_16_le(ptr, count16);
     // Size of central directory (bytes)
-    en::write_32_le(sink, cd_length);
+    ptr = put_32_le(ptr, zip32_field(cd_length));
     // Offset of start of central directory
-    en::write_32_le(sink, cd_offset);
+    ptr = put_32_le(ptr, zip32_field(cd_offset));
     // Comment length (n)
-    en::write_16_le(sink, 0);
+    put_16_le(ptr, static_cast<uint16_t>(comment.length()));
+    dest.append(buf.data(), buf.size());
+    // Comment
+    dest.append(comment);
 }
 
 } // namespace
 
 /**
  * Sink wrapper that creates ZIP archives,
- * CRC sum and compression of entries is NOT supported
+ * CRC sum and compression of entries is NOT supported;
+ * Central Directory records of the written entries are kept in memory
+ * up to "cd_memory_limit" bytes and are spilled into a temporary file after that.
+ * ZIP64 records are written only when they are required: for more than 65534
+ * entries, for sizes and offsets over 4GB; archives without such entries
+ * are written in plain ZIP32 format.
  */
 template <typename Sink>
 class zip_sink {
 private:
     // stream shortcuts
     using sink_ref_type = sl::io::reference_sink<sl::io::counting_sink<Sink>>;
-    using entry_counter_ref_type = sl::io::reference_sink<sl::io::counting_sink<sink_ref_type>>;
-    using deflater_type = sl::io::counting_sink<deflate_sink<entry_counter_ref_type>>;
+    using deflater_type = deflate_sink<sink_ref_type>;
 
     /**
      * Destination sink for the zipped data
      */
     zip_compression_method method = zip_compression_method::deflate;
     sl::io::counting_sink<Sink> sink;
-    std::vector<detail::Header> headers;
+    detail::cd_arena cd_records;
     bool cd_written = false;
+    /**
+     * State of the existing archive in append mode
+     */
+    uint64_t base_offset = 0;
+    detail::central_directory existing_cd;
 
-    sl::io::counting_sink<sink_ref_type> entry_counter;
+    /**
+     * State of the entry being written, sizes are taken
+     * from the archive counter and from the written spans
+     */
+    detail::Header entry_header;
     std::unique_ptr<deflater_type> entry_deflater;
     uint32_t entry_crc = 0;
+    size_t entry_start = 0;
+    uint64_t entry_size = 0;
+    /**
+     * Output buffer reused by in-memory entries
+     */
+    std::string entry_buf;
 
 public:
 
@@ -207,12 +555,32 @@ public:
      * Constructor
      * 
      * @param sink destination to write compressed data into
+     * @param cd_memory_limit max size of Central Directory records kept in memory,
+     *        records are spilled into a temporary file after that
      */
-    zip_sink(Sink&& sink) :
+    zip_sink(Sink&& sink, size_t cd_memory_limit = detail::zip_cd_memory_limit) :
     sink(sl::io::make_counting_sink(std::move(sink))),
-    entry_counter(sl::io::make_counting_sink(this->sink)),
+    cd_records(cd_memory_limit),
     entry_deflater(nullptr) { }
 
+    /**
+     * Constructor for appending entries to an existing archive.
+     * Central Directory of the existing archive is read from the specified source,
+     * new entries are written over it and the merged Central Directory is written
+     * on "finalize()", so the cost of appending depends only on the size of new data.
+     * Records and comment of the existing Central Directory are kept as is, so
+     * the resulting archive is never shorter than the existing one and
+     * the destination does not need to be truncated.
+     * 
+     * @param sink seekable destination that contains the existing archive,
+     *        must allow to overwrite the data at arbitrary positions
+     * @param archive seekable source that reads the same archive
+     * @param cd_memory_limit max size of Central Directory records kept in memory
+     */
+    template <typename Source>
+    zip_sink(Sink&& sink, Source& archive, size_t cd_memory_limit = detail::zip_cd_memory_limit) :
+    zip_sink(std::move(sink), detail::read_central_directory(archive), cd_memory_limit) { }
+
     /**
      * Destructor, will call `finalize()` if it have not been called yet
      */
@@ -247,10 +615,9 @@ public:
      */
     std::streamsize write(sl::io::span<const char> span) {
         if (nullptr != entry_deflater.get()) {
-            size_t count_before = entry_deflater->get_count();
-            entry_deflater->write(span);
-            size_t count = entry_deflater->get_count() - count_before;
-            this->entry_crc = ::crc32(entry_crc, reinterpret_cast<const Bytef*>(span.data()), static_cast<uInt>(count));
+            size_t count = static_cast<size_t>(entry_deflater->write(span));
+            this->entry_crc = detail::zlib_crc32(entry_crc, span.data(), count);
+            this->entry_size += count;
             return static_cast<std::streamsize>(count);
         } else {
             throw compress_exception(TRACEMSG("Invalid ZIP sink state: add ZIP entry before writing the data"));
@@ -265,6 +632,16 @@ public:
     std::streamsize flush() {
         return sink.flush();
     }
+
+    /**
+     * Checks whether Central Directory records were spilled
+     * into the temporary file
+     * 
+     * @return true if the in-memory limit was exceeded
+     */
+    bool is_cd_spilled() const {
+        return cd_records.is_spilled();
+    }
     
     /**
      * Add ZIP entry with the specified name to archive
@@ -272,46 +649,197 @@ public:
      * @param filename ZIP entry name
      */
     void add_entry(const std::string& filename) {
-        if (filename.empty()) throw compress_exception(TRACEMSG("Invalid empty entry name specified"));
-        if (cd_written) throw new compress_exception(TRACEMSG( 
-                "Invalid entry add attempt for finalized ZIP stream"));
-        if (headers.size() > 0) {
-            write_entry_data_descriptor();
-        }
+        close_entry(filename);
         // add new entry
-        headers.emplace_back(std::string(filename.data(), filename.length()), static_cast<uint16_t>(method));
-        headers.back().write_local_file_header(sink, static_cast<uint32_t>(sink.get_count()));
-        entry_deflater.reset(new sl::io::counting_sink<deflate_sink<entry_counter_ref_type>>(make_deflate_sink(entry_counter)));
-        entry_crc = ::crc32(0L, Z_NULL, 0);
+        entry_header = detail::Header(std::string(filename.data(), filename.length()), static_cast<uint16_t>(method));
+        entry_header.write_local_file_header(sink, current_offset());
+        entry_deflater.reset(new deflater_type(make_deflate_sink(sink)));
+        entry_crc = 0;
+        entry_start = sink.get_count();
+        entry_size = 0;
+    }
+
+    /**
+     * Add ZIP entry with the specified name and in-memory contents to archive;
+     * small entries are compressed in one shot (with libdeflate, when
+     * enabled) and are written with CRC-32 and sizes in the local header,
+     * entries larger than 4MB are streamed the same way as with "add_entry(filename)"
+     * 
+     * @param filename ZIP entry name
+     * @param data entry contents
+     */
+    void add_entry(const std::string& filename, sl::io::span<const char> data) {
+        if (data.size() > detail::zip_whole_buffer_max_size) {
+            add_entry(filename);
+            sl::io::write_all(*this, data);
+            return;
+        }
+        close_entry(filename);
+        size_t bound = deflate_bound(data.size());
+        if (entry_buf.length() < bound) {
+            entry_buf.resize(bound);
+        }
+        size_t len = deflate_into(data, {&entry_buf.front(), bound});
+        uint32_t crc = detail::zlib_crc32(0, data.data(), data.size());
+        auto header = detail::Header(std::string(filename.data(), filename.length()),
+                static_cast<uint16_t>(zip_compression_method::deflate), 0, len, data.size(), crc);
+        header.write_local_file_header(sink, current_offset());
+        io::write_all(sink, {entry_buf.data(), len});
+        cd_records.add(header);
+    }
+
+    /**
+     * Add ZIP entry, which data is already compressed, to archive;
+     * data is copied as is without recompression, and CRC-32
+     * and sizes are written directly into entry headers
+     * 
+     * @param filename ZIP entry name
+     * @param data source of compressed entry data
+     * @param method compression method that was used for the data
+     * @param crc CRC-32 of the uncompressed data
+     * @param compressed_size number of bytes to copy from data source
+     * @param uncompressed_size size of the data after decompression
+     */
+    template <typename Source>
+    void add_raw_entry(const std::string& filename, Source& data, zip_compression_method method,
+            uint32_t crc, uint64_t compressed_size, uint64_t uncompressed_size) {
+        close_entry(filename);
+        auto limited = detail::limited_source<sl::io::reference_source<Source>>(
+                sl::io::make_reference_source(data), compressed_size);
+        write_raw_entry(detail::Header(std::string(filename.data(), filename.length()),
+                static_cast<uint16_t>(method), 0, compressed_size, uncompressed_size, crc), limited);
+    }
+
+    /**
+     * Add ZIP entry, copied from another archive, to this archive;
+     * compressed entry data is copied as is without recompression
+     * 
+     * @param filename ZIP entry name in this archive
+     * @param archive seekable source of the archive that contains the entry
+     * @param entry entry description from the Central Directory of that archive
+     */
+    template <typename Source>
+    void add_raw_entry(const std::string& filename, Source& archive, const zip_entry& entry) {
+        close_entry(filename);
+        auto data = detail::open_entry_data(sl::io::make_reference_source(archive), entry);
+        write_raw_entry(detail::Header(std::string(filename.data(), filename.length()),
+                static_cast<uint16_t>(entry.get_method()), entry.get_flags(),
+                entry.get_compressed_size(), entry.get_uncompressed_size(), entry.get_crc()), data);
     }
     
+    /**
+     * Add ZIP entry, which data is already compressed with raw Deflate
+     * (without zlib or gzip wrapper), to archive; data is copied as is
+     * until the end of the source, data descriptor is written after it
+     * 
+     * @param filename ZIP entry name
+     * @param deflated source of Deflate-compressed data
+     * @param crc CRC-32 of the uncompressed data
+     * @param uncompressed_size size of the data after decompression
+     */
+    template <typename Source>
+    void add_deflated_entry(const std::string& filename, Source& deflated,
+            uint32_t crc, uint64_t uncompressed_size) {
+        close_entry(filename);
+        auto header = detail::Header(std::string(filename.data(), filename.length()),
+                static_cast<uint16_t>(zip_compression_method::deflate));
+        header.write_local_file_header(sink, current_offset());
+        size_t count_before = sink.get_count();
+        sl::io::copy_all(deflated, sink);
+        uint64_t compressed_size = sink.get_count() - count_before;
+        header.write_data_descriptor(sink, compressed_size, uncompressed_size, crc);
+        cd_records.add(header);
+    }
+
+    /**
+     * Add ZIP entry, which data is already compressed with raw Deflate,
+     * to archive; CRC-32 and size are computed reading the specified
+     * uncompressed source, that is much cheaper than recompression
+     * 
+     * @param filename ZIP entry name
+     * @param deflated source of Deflate-compressed data
+     * @param uncompressed source of the same data in uncompressed form
+     */
+    template <typename Source, typename UncompressedSource>
+    void add_deflated_entry(const std::string& filename, Source& deflated, UncompressedSource& uncompressed) {
+        auto buf = std::array<char, 4096>();
+        uint32_t crc = 0;
+        uint64_t size = 0;
+        for (;;) {
+            auto read = uncompressed.read({buf.data(), buf.size()});
+            if (std::char_traits<char>::eof() == read) break;
+            crc = detail::zlib_crc32(crc, buf.data(), read);
+            size += static_cast<uint64_t>(read);
+        }
+        add_deflated_entry(filename, deflated, crc, size);
+    }
+
     /**
      * Finalizes ZIP archive writing Central Directory,
      * may be safely called multiple times,
      * will be called from destructor if not called explicitely
      */
     void finalize() {
-        if (!cd_written && headers.size() > 0) {
+        if (nullptr != entry_deflater.get()) {
             write_entry_data_descriptor();
-            uint32_t cd_offset = static_cast<uint32_t>(sink.get_count());
-            for (detail::Header& he : headers) {
-                he.write_cd_file_header(sink);
+        }
+        if (!cd_written && cd_records.get_count() > 0) {
+            uint64_t cd_offset = current_offset();
+            // records of the existing archive go first
+            const std::string& existing = existing_cd.records;
+            io::write_all(sink, {existing.data(), existing.length()});
+            cd_records.write_to(sink);
+            uint64_t cd_len = current_offset() - cd_offset;
+            uint64_t files_count = existing_cd.count + cd_records.get_count();
+            auto buf = std::string();
+            if (detail::is_zip64_eocd(files_count, cd_offset, cd_len)) {
+                detail::append_zip64_eocd(buf, files_count, cd_offset, cd_len, current_offset());
             }
-            size_t cd_len = sink.get_count() - cd_offset;
-            detail::write_eocd(sink, static_cast<uint16_t>(headers.size()), cd_offset, static_cast<uint32_t>(cd_len));
+            detail::append_eocd(buf, files_count, cd_offset, cd_len, existing_cd.comment);
+            io::write_all(sink, {buf.data(), buf.length()});
             cd_written = true;
         }
     }
 
 private:
+    zip_sink(Sink&& sink, detail::central_directory&& cd, size_t cd_memory_limit) :
+    sink(sl::io::make_counting_sink(seek_sink(std::move(sink), cd.offset))),
+    cd_records(cd_memory_limit),
+    base_offset(cd.offset),
+    existing_cd(std::move(cd)),
+    entry_deflater(nullptr) { }
+
+    static Sink seek_sink(Sink&& sink, uint64_t offset) {
+        detail::seek_to(sink, static_cast<int64_t>(offset));
+        return std::move(sink);
+    }
+
+    uint64_t current_offset() {
+        return base_offset + sink.get_count();
+    }
+
+    void close_entry(const std::string& filename) {
+        if (filename.empty()) throw compress_exception(TRACEMSG("Invalid empty entry name specified"));
+        if (cd_written) throw compress_exception(TRACEMSG(
+                "Invalid entry add attempt for finalized ZIP stream"));
+        if (nullptr != entry_deflater.get()) {
+            write_entry_data_descriptor();
+        }
+    }
+
+    template <typename Source>
+    void write_raw_entry(detail::Header&& header, detail::limited_source<Source>& data) {
+        header.write_local_file_header(sink, current_offset());
+        sl::io::copy_all(data, sink);
+        cd_records.add(header);
+    }
+
     void write_entry_data_descriptor() {
-        // get size and close current entry
-        uint32_t uncompressed_size = static_cast<uint32_t>(entry_deflater->get_count());
+        // close current entry, remaining compressed data is written on destruction
         entry_deflater.reset(nullptr);
-        // get size and reset counter
-        uint32_t compressed_size = static_cast<uint32_t>(entry_counter.get_count());
-        entry_counter = sl::io::make_counting_sink(sink);
-        headers.back().write_data_descriptor(sink, compressed_size, uncompressed_size, entry_crc);
+        uint64_t compressed_size = sink.get_count() - entry_start;
+        entry_header.write_data_descriptor(sink, compressed_size, entry_size, entry_crc);
+        cd_records.add(entry_header);
     }
     
 };
@@ -321,12 +849,14 @@ private:
  * created object will own the specified sink
  * 
  * @param sink output sink
+ * @param cd_memory_limit max size of Central Directory records kept in memory
  * @return zip sink
  */
 template <typename Sink,
 class = typename std::enable_if<!std::is_lvalue_reference<Sink>::value>::type>
-sl::io::unique_sink<zip_sink<Sink>> make_zip_sink(Sink&& sink) {
-    auto ptr = new zip_sink<Sink>(std::move(sink));
+sl::io::unique_sink<zip_sink<Sink>> make_zip_sink(Sink&& sink,
+        size_t cd_memory_limit = detail::zip_cd_memory_limit) {
+    auto ptr = new zip_sink<Sink>(std::move(sink), cd_memory_limit);
     return sl::io::make_unique_sink(ptr);
 }
 
@@ -335,12 +865,48 @@ sl::io::unique_sink<zip_sink<Sink>> make_zip_sink(Sink&& sink) {
  * created object will NOT own the specified sink
  * 
  * @param sink output sink
+ * @param cd_memory_limit max size of Central Directory records kept in memory
  * @return zip sink
  */
 template <typename Sink>
-sl::io::unique_sink<zip_sink<sl::io::reference_sink<Sink>>> make_zip_sink(Sink& sink) {
+sl::io::unique_sink<zip_sink<sl::io::reference_sink<Sink>>> make_zip_sink(Sink& sink,
+        size_t cd_memory_limit = detail::zip_cd_memory_limit) {
+    auto ptr = new zip_sink<sl::io::reference_sink<Sink>> (
+            sl::io::make_reference_sink(sink), cd_memory_limit);
+    return sl::io::make_unique_sink(ptr);
+}
+
+/**
+ * Factory function for creating zip sinks that append entries
+ * to an existing archive, created object will own the specified sink
+ * 
+ * @param sink seekable output sink that contains the existing archive
+ * @param archive seekable source that reads the same archive
+ * @param cd_memory_limit max size of Central Directory records kept in memory
+ * @return zip sink
+ */
+template <typename Sink, typename Source,
+class = typename std::enable_if<!std::is_lvalue_reference<Sink>::value>::type>
+sl::io::unique_sink<zip_sink<Sink>> make_zip_append_sink(Sink&& sink, Source& archive,
+        size_t cd_memory_limit = detail::zip_cd_memory_limit) {
+    auto ptr = new zip_sink<Sink>(std::move(sink), archive, cd_memory_limit);
+    return sl::io::make_unique_sink(ptr);
+}
+
+/**
+ * Factory function for creating zip sinks that append entries
+ * to an existing archive, created object will NOT own the specified sink
+ * 
+ * @param sink seekable output sink that contains the existing archive
+ * @param archive seekable source that reads the same archive
+ * @param cd_memory_limit max size of Central Directory records kept in memory
+ * @return zip sink
+ */
+template <typename Sink, typename Source>
+sl::io::unique_sink<zip_sink<sl::io::reference_sink<Sink>>> make_zip_append_sink(Sink& sink, Source& archive,
+        size_t cd_memory_limit = detail::zip_cd_memory_limit) {
     auto ptr = new zip_sink<sl::io::reference_sink<Sink>> (
-            sl::io::make_reference_sink(sink));
+            sl::io::make_reference_sink(sink), archive, cd_memory_limit);
     return sl::io::make_unique_sink(ptr);
 }
 
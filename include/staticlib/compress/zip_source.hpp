@@ -0,0 +1,429 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zip_source.hpp
+ * Author: alex
+ *
+ * Created on October 22, 2026, 10:15 AM
+ */
+
+#ifndef STATICLIB_COMPRESS_ZIP_SOURCE_HPP
+#define STATICLIB_COMPRESS_ZIP_SOURCE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <ios>
+#include <string>
+#include <type_traits>
+
+#include "staticlib/config.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+#include "staticlib/compress/inflate_decoder.hpp"
+#include "staticlib/compress/zip_compression_method.hpp"
+#include "staticlib/compress/zip_entry.hpp"
+#include "staticlib/compress/zip_reader.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
+
+namespace staticlib {
+namespace compress {
+
+/**
+ * Forward-only reader of ZIP archives, that walks Local File Headers
+ * and does not require a seekable source (pipe, HTTP body). Entries
+ * are returned in the order they are stored, data of the current entry
+ * is read from this source, CRC-32 and sizes are checked after all
+ * entry data is read. Entries with data descriptor (general purpose
+ * bit 3, as written by "zip_sink") are supported for "deflate" method,
+ * the end of entry data is detected from the end of Deflate stream.
+ * ZIP64 sizes are read from the local header extra field, data descriptor
+ * is expected to have 8-byte sizes when local header has ZIP64 extra field
+ * or when the entry sizes do not fit into 4 bytes (as written by "zip_sink").
+ * Reading stops at the Central Directory.
+ */
+template <typename Source, std::size_t buf_size = 4096>
+class zip_source {
+    /**
+     * Source of the ZIP archive
+     */
+    Source src;
+    /**
+     * Internal buffer
+     */
+    std::array<char, buf_size> buf;
+    /**
+     * Start position in internal buffer
+     */
+    size_t pos = 0;
+    /**
+     * Number of bytes available in internal buffer
+     */
+    size_t avail = 0;
+    /**
+     * Source EOF flag
+     */
+    bool exhausted = false;
+    /**
+     * Number of archive bytes consumed
+     */
+    uint64_t offset = 0;
+    /**
+     * Current entry, as described by its Local File Header
+     */
+    zip_entry entry;
+    /**
+     * Whether entry data is being read
+     */
+    bool reading = false;
+    /**
+     * Decoder for "deflate" method
+     */
+    inflate_decoder decoder;
+    /**
+     * Compressed bytes of current entry consumed
+     */
+    uint64_t compressed_count = 0;
+    /**
+     * Uncompressed bytes of current entry read
+     */
+    uint64_t uncompressed_count = 0;
+    /**
+     * CRC-32 of the entry data read so far
+     */
+    uint32_t crc = 0;
+    /**
+     * Whether local header of the current entry has ZIP64 extra field
+     */
+    bool zip64 = false;
+
+public:
+    /**
+     * Constructor, created object will own the specified source
+     *
+     * @param src source of the ZIP archive
+     */
+    zip_source(Source src) :
+    src(std::move(src)),
+    entry("", zip_compression_method::store, 0, 0, 0, 0, 0) { }
+
+    /**
+     * Deleted copy constructor
+     *
+     * @param other instance
+     */
+    zip_source(const zip_source&) = delete;
+
+    /**
+     * Deleted copy assignment operator
+     *
+     * @param other instance
+     * @return this instance
+     */
+    zip_source& operator=(const zip_source&) = delete;
+
+    /**
+     * Move constructor
+     *
+     * @param other other instance
+     */
+    zip_source(zip_source&& other) :
+    src(std::move(other.src)),
+    buf(std::move(other.buf)),
+    pos(other.pos),
+    avail(other.avail),
+    exhausted(other.exhausted),
+    offset(other.offset),
+    entry(std::move(other.entry)),
+    reading(other.reading),
+    decoder(std::move(other.decoder)),
+    compressed_count(other.compressed_count),
+    uncompressed_count(other.uncompressed_count),
+    crc(other.crc),
+    zip64(other.zip64) { }
+
+    /**
+     * Move assignment operator
+     *
+     * @param other other instance
+     * @return this instance
+     */
+    zip_source& operator=(zip_source&& other) {
+        src = std::move(other.src);
+        buf = std::move(other.buf);
+        pos = other.pos;
+        avail = other.avail;
+        exhausted = other.exhausted;
+        offset = other.offset;
+        entry = std::move(other.entry);
+        reading = other.reading;
+        decoder = std::move(other.decoder);
+        compressed_count = other.compressed_count;
+        uncompressed_count = other.uncompressed_count;
+        crc = other.crc;
+        zip64 = other.zip64;
+        return *this;
+    }
+
+    /**
+     * Moves to the next entry in archive, unread data of the
+     * current entry is skipped (and checked)
+     *
+     * @return false if there are no more entries
+     * @throws compress_exception on invalid or unsupported archive
+     */
+    bool next_entry() {
+        if (reading) {
+            auto scratch = std::array<char, 4096>();
+            while (std::char_traits<char>::eof() != read({scratch.data(), scratch.size()})) { }
+        }
+        fill(30);
+        if (avail < 4) {
+            if (0 == avail) return false;
+            throw compress_exception(TRACEMSG("Unexpected end of ZIP archive," +
+                    " offset: [" + sl::support::to_string(offset) + "]"));
+        }
+        uint32_t sig = detail::decode_32_le(buf.data() + pos);
+        // Central Directory or (ZIP64) End of Central Directory
+        if (0x02014b50 == sig || 0x06054b50 == sig || 0x06064b50 == sig) return false;
+        if (0x04034b50 != sig || avail < 30) throw compress_exception(TRACEMSG(
+                "Invalid Local File Header, offset: [" + sl::support::to_string(offset) + "]"));
+        const char* lfh = buf.data() + pos;
+        uint16_t flags = detail::decode_16_le(lfh + 6);
+        auto method = static_cast<zip_compression_method>(detail::decode_16_le(lfh + 8));
+        uint32_t header_crc = detail::decode_32_le(lfh + 14);
+        uint64_t csize = detail::decode_32_le(lfh + 18);
+        uint64_t usize = detail::decode_32_le(lfh + 22);
+        uint16_t name_len = detail::decode_16_le(lfh + 26);
+        uint16_t extra_len = detail::decode_16_le(lfh + 28);
+        uint64_t header_offset = offset;
+        consume(30);
+        auto name = std::string();
+        read_raw(name, name_len);
+        auto extra = std::string();
+        read_raw(extra, extra_len);
+        uint64_t no_offset = 0;
+        zip64 = detail::read_zip64_extra(name, extra.data(), extra.length(), usize, csize, no_offset);
+        if (zip_compression_method::store != method && zip_compression_method::deflate != method) {
+            throw compress_exception(TRACEMSG("Unsupported compression method," +
+                    " entry: [" + name + "]," +
+                    " method: [" + sl::support::to_string(static_cast<uint16_t>(method)) + "]"));
+        }
+        if (has_descriptor(flags) && zip_compression_method::store == method) throw compress_exception(TRACEMSG(
+                "Stored entry with data descriptor cannot be read sequentially," +
+                " entry: [" + name + "]"));
+        entry = zip_entry(std::move(name), method, flags, header_crc, csize, usize, header_offset);
+        reading = true;
+        compressed_count = 0;
+        uncompressed_count = 0;
+        crc = 0;
+        if (zip_compression_method::deflate == method) {
+            decoder.reset();
+        }
+        return true;
+    }
+
+    /**
+     * Current entry accessor, for entries with data descriptor
+     * CRC-32 and sizes are available only after all entry data is read
+     *
+     * @return current entry
+     */
+    const zip_entry& get_entry() const {
+        return entry;
+    }
+
+    /**
+     * Reads (and inflates if necessary) data of the current entry
+     *
+     * @param span output span
+     * @return number of bytes written into specified span
+     */
+    std::streamsize read(sl::io::span<char> span) {
+        if (!reading) {
+            return std::char_traits<char>::eof();
+        }
+        size_t written = zip_compression_method::deflate == entry.get_method() ?
+                read_deflated(span) : read_stored(span);
+        if (written > 0) {
+            crc = detail::zlib_crc32(crc, span.data(), written);
+            uncompressed_count += written;
+            return static_cast<std::streamsize>(written);
+        }
+        if (0 == span.size()) {
+            return 0;
+        }
+        finish_entry();
+        return std::char_traits<char>::eof();
+    }
+
+    /**
+     * Underlying source accessor
+     *
+     * @return underlying source reference
+     */
+    Source& get_source() {
+        return src;
+    }
+
+private:
+    static bool has_descriptor(uint16_t flags) {
+        return 0 != (flags & 8);
+    }
+
+    void fill(size_t min_avail) {
+        if (avail >= min_avail || exhausted) return;
+        if (avail > 0 && pos > 0) {
+            std::memmove(buf.data(), buf.data() + pos, avail);
+        }
+        pos = 0;
+        size_t len = buf.size() - avail;
+        size_t read = sl::io::read_all(src, {buf.data() + avail, len});
+        avail += read;
+        exhausted = read < len;
+    }
+
+    void consume(size_t len) {
+        pos += len;
+        avail -= len;
+        offset += len;
+    }
+
+    void read_raw(std::string& dest, size_t len) {
+        dest.reserve(len);
+        while (dest.length() < len) {
+            fill(1);
+            if (0 == avail) throw compress_exception(TRACEMSG("Unexpected end of ZIP archive," +
+                    " offset: [" + sl::support::to_string(offset) + "]"));
+            size_t chunk = std::min(avail, len - dest.length());
+            dest.append(buf.data() + pos, chunk);
+            consume(chunk);
+        }
+    }
+
+    size_t read_stored(sl::io::span<char> span) {
+        uint64_t left = entry.get_compressed_size() - compressed_count;
+        if (0 == left) {
+            return 0;
+        }
+        fill(1);
+        if (0 == avail) throw compress_exception(TRACEMSG("Unexpected end of ZIP archive," +
+                " entry: [" + entry.get_name() + "]"));
+        size_t len = std::min(span.size(), avail);
+        if (left < len) {
+            len = static_cast<size_t>(left);
+        }
+        std::memcpy(span.data(), buf.data() + pos, len);
+        consume(len);
+        compressed_count += len;
+        return len;
+    }
+
+    size_t read_deflated(sl::io::span<char> span) {
+        while (!decoder.is_done()) {
+            fill(1);
+            size_t in_len = avail;
+            if (!has_descriptor(entry.get_flags())) {
+                uint64_t left = entry.get_compressed_size() - compressed_count;
+                in_len = static_cast<size_t>(std::min(static_cast<uint64_t>(avail), left));
+            }
+            auto res = decoder.decode({buf.data() + pos, in_len}, span);
+            consume(res.get_consumed());
+            compressed_count += res.get_consumed();
+            if (res.get_produced() > 0 || 0 == span.size()) {
+                return res.get_produced();
+            }
+            if (!res.is_done() && 0 == res.get_consumed()) throw compress_exception(TRACEMSG(
+                    "Unexpected end of ZIP entry data, entry: [" + entry.get_name() + "]"));
+        }
+        return 0;
+    }
+
+    void finish_entry() {
+        reading = false;
+        uint32_t expected_crc = entry.get_crc();
+        uint64_t expected_csize = entry.get_compressed_size();
+        uint64_t expected_usize = entry.get_uncompressed_size();
+        if (has_descriptor(entry.get_flags())) {
+            bool sizes64 = zip64 || compressed_count >= UINT32_MAX || uncompressed_count >= UINT32_MAX;
+            size_t desc_len = sizes64 ? 20 : 12;
+            fill(desc_len + 4);
+            if (avail >= 4 && 0x08074b50 == detail::decode_32_le(buf.data() + pos)) {
+                consume(4);
+            }
+            if (avail < desc_len) throw compress_exception(TRACEMSG(
+                    "Invalid data descriptor, entry: [" + entry.get_name() + "]"));
+            expected_crc = detail::decode_32_le(buf.data() + pos);
+            if (sizes64) {
+                expected_csize = detail::decode_64_le(buf.data() + pos + 4);
+                expected_usize = detail::decode_64_le(buf.data() + pos + 12);
+            } else {
+                expected_csize = detail::decode_32_le(buf.data() + pos + 4);
+                expected_usize = detail::decode_32_le(buf.data() + pos + 8);
+            }
+            consume(desc_len);
+            entry = zip_entry(entry.get_name(), entry.get_method(), entry.get_flags(), expected_crc,
+                    expected_csize, expected_usize, entry.get_offset());
+        }
+        if (crc != expected_crc || compressed_count != expected_csize || uncompressed_count != expected_usize) {
+            throw compress_exception(TRACEMSG("ZIP entry check failed," +
+                    " entry: [" + entry.get_name() + "]," +
+                    " expected CRC-32: [" + sl::support::to_string(expected_crc) + "]," +
+                    " actual CRC-32: [" + sl::support::to_string(crc) + "]," +
+                    " expected compressed size: [" + sl::support::to_string(expected_csize) + "]," +
+                    " actual compressed size: [" + sl::support::to_string(compressed_count) + "]," +
+                    " expected size: [" + sl::support::to_string(expected_usize) + "]," +
+                    " actual size: [" + sl::support::to_string(uncompressed_count) + "]"));
+        }
+    }
+
+};
+
+/**
+ * Factory function for creating sequential ZIP sources,
+ * created object will own the specified source
+ *
+ * @param source source of the ZIP archive
+ * @return ZIP source
+ */
+template <typename Source,
+        class = typename std::enable_if<!std::is_lvalue_reference<Source>::value>::type>
+zip_source<Source> make_zip_source(Source&& source) {
+    return zip_source<Source>(std::move(source));
+}
+
+/**
+ * Factory function for creating sequential ZIP sources,
+ * created object will NOT own the specified source
+ *
+ * @param source source of the ZIP archive
+ * @return ZIP source
+ */
+template <typename Source>
+zip_source<sl::io::reference_source<Source>> make_zip_source(Source& source) {
+    return zip_source<sl::io::reference_source<Source>> (
+            sl::io::make_reference_source(source));
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_ZIP_SOURCE_HPP */
+
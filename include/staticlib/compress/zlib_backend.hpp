@@ -0,0 +1,209 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zlib_backend.hpp
+ * Author: alex
+ *
+ * Created on October 22, 2026, 2:10 PM
+ */
+
+#ifndef STATICLIB_COMPRESS_ZLIB_BACKEND_HPP
+#define STATICLIB_COMPRESS_ZLIB_BACKEND_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef STATICLIB_COMPRESS_ENABLE_ZLIB_NG
+#include "zlib-ng.h"
+#else // stock zlib
+#include "zlib.h"
+#endif // STATICLIB_COMPRESS_ENABLE_ZLIB_NG
+
+namespace staticlib {
+namespace compress {
+
+namespace detail {
+
+// Deflate backend traits: the rest of the library uses only these
+// names, so the backend is selected at build time without any changes
+// to the public API. Constants (Z_OK, Z_FINISH, MAX_WBITS etc)
+// have the same names in all the supported backends.
+
+#ifdef STATICLIB_COMPRESS_ENABLE_ZLIB_NG
+
+using zlib_stream = zng_stream;
+using zlib_byte = uint8_t;
+using zlib_uint = uint32_t;
+
+inline int zlib_deflate_init2(zlib_stream* strm, int level, int window_bits, int mem_level, int strategy) {
+    return ::zng_deflateInit2(strm, level, Z_DEFLATED, window_bits, mem_level, strategy);
+}
+
+inline int zlib_deflate(zlib_stream* strm, int flush) {
+    return ::zng_deflate(strm, flush);
+}
+
+inline int zlib_deflate_end(zlib_stream* strm) {
+    return ::zng_deflateEnd(strm);
+}
+
+inline int zlib_deflate_reset(zlib_stream* strm) {
+    return ::zng_deflateReset(strm);
+}
+
+inline int zlib_deflate_params(zlib_stream* strm, int level, int strategy) {
+    return ::zng_deflateParams(strm, level, strategy);
+}
+
+inline size_t zlib_deflate_bound(zlib_stream* strm, size_t len) {
+    return static_cast<size_t>(::zng_deflateBound(strm, len));
+}
+
+inline int zlib_deflate_set_dictionary(zlib_stream* strm, const char* dict, size_t len) {
+    return ::zng_deflateSetDictionary(strm, reinterpret_cast<const uint8_t*>(dict), static_cast<uint32_t>(len));
+}
+
+inline int zlib_inflate_init2(zlib_stream* strm, int window_bits) {
+    return ::zng_inflateInit2(strm, window_bits);
+}
+
+inline int zlib_inflate(zlib_stream* strm, int flush) {
+    return ::zng_inflate(strm, flush);
+}
+
+inline int zlib_inflate_end(zlib_stream* strm) {
+    return ::zng_inflateEnd(strm);
+}
+
+inline int zlib_inflate_reset(zlib_stream* strm) {
+    return ::zng_inflateReset(strm);
+}
+
+inline int zlib_inflate_reset2(zlib_stream* strm, int window_bits) {
+    return ::zng_inflateReset2(strm, window_bits);
+}
+
+inline int zlib_inflate_set_dictionary(zlib_stream* strm, const char* dict, size_t len) {
+    return ::zng_inflateSetDictionary(strm, reinterpret_cast<const uint8_t*>(dict), static_cast<uint32_t>(len));
+}
+
+inline int zlib_inflate_prime(zlib_stream* strm, int bits, int value) {
+    return ::zng_inflatePrime(strm, bits, value);
+}
+
+inline uint32_t zlib_crc32(uint32_t crc, const char* data, size_t len) {
+    return static_cast<uint32_t>(::zng_crc32(crc, reinterpret_cast<const uint8_t*>(data), static_cast<uint32_t>(len)));
+}
+
+inline const char* zlib_error(int err) {
+    return ::zng_zError(err);
+}
+
+#else // stock zlib
+
+using zlib_stream = z_stream;
+using zlib_byte = Bytef;
+using zlib_uint = uInt;
+
+inline int zlib_deflate_init2(zlib_stream* strm, int level, int window_bits, int mem_level, int strategy) {
+    return deflateInit2(strm, level, Z_DEFLATED, window_bits, mem_level, strategy);
+}
+
+inline int zlib_deflate(zlib_stream* strm, int flush) {
+    return ::deflate(strm, flush);
+}
+
+inline int zlib_deflate_end(zlib_stream* strm) {
+    return ::deflateEnd(strm);
+}
+
+inline int zlib_deflate_reset(zlib_stream* strm) {
+    return ::deflateReset(strm);
+}
+
+inline int zlib_deflate_params(zlib_stream* strm, int level, int strategy) {
+    return ::deflateParams(strm, level, strategy);
+}
+
+inline size_t zlib_deflate_bound(zlib_stream* strm, size_t len) {
+    return static_cast<size_t>(::deflateBound(strm, static_cast<uLong>(len)));
+}
+
+inline int zlib_deflate_set_dictionary(zlib_stream* strm, const char* dict, size_t len) {
+    return ::deflateSetDictionary(strm, reinterpret_cast<const Bytef*>(dict), static_cast<uInt>(len));
+}
+
+inline int zlib_inflate_init2(zlib_stream* strm, int window_bits) {
+    return inflateInit2(strm, window_bits);
+}
+
+inline int zlib_inflate(zlib_stream* strm, int flush) {
+    return ::inflate(strm, flush);
+}
+
+inline int zlib_inflate_end(zlib_stream* strm) {
+    return ::inflateEnd(strm);
+}
+
+inline int zlib_inflate_reset(zlib_stream* strm) {
+    return ::inflateReset(strm);
+}
+
+inline int zlib_inflate_reset2(zlib_stream* strm, int window_bits) {
+    return ::inflateReset2(strm, window_bits);
+}
+
+inline int zlib_inflate_set_dictionary(zlib_stream* strm, const char* dict, size_t len) {
+    return ::inflateSetDictionary(strm, reinterpret_cast<const Bytef*>(dict), static_cast<uInt>(len));
+}
+
+inline int zlib_inflate_prime(zlib_stream* strm, int bits, int value) {
+    return ::inflatePrime(strm, bits, value);
+}
+
+inline uint32_t zlib_crc32(uint32_t crc, const char* data, size_t len) {
+    return static_cast<uint32_t>(::crc32(crc, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(len)));
+}
+
+inline const char* zlib_error(int err) {
+    return ::zError(err);
+}
+
+#endif // STATICLIB_COMPRESS_ENABLE_ZLIB_NG
+
+} // namespace
+
+/**
+ * Returns the name and version of the Deflate implementation
+ * the library is built with, is intended to label benchmark results
+ *
+ * @return backend name, e.g. "zlib 1.2.13"
+ */
+inline std::string deflate_backend_name() {
+#ifdef STATICLIB_COMPRESS_ENABLE_ZLIB_NG
+    return std::string("zlib-ng ") + ::zlibng_version();
+#else
+    return std::string("zlib ") + ::zlibVersion();
+#endif // STATICLIB_COMPRESS_ENABLE_ZLIB_NG
+}
+
+} // namespace
+}
+
+#endif /* STATICLIB_COMPRESS_ZLIB_BACKEND_HPP */
+
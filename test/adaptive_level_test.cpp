@@ -0,0 +1,148 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   adaptive_level_test.cpp
+ * Author: alex
+ *
+ * Created on October 20, 2026, 3:50 PM
+ */
+
+#include "staticlib/compress/adaptive_level.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/deflate_sink.hpp"
+#include "staticlib/compress/inflate_source.hpp"
+
+class slow_sink {
+    std::string& data;
+
+public:
+    slow_sink(std::string& data) :
+    data(data) { }
+
+    std::streamsize write(sl::io::span<const char> span) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        data.append(span.data(), span.size());
+        return span.size_signed();
+    }
+
+    std::streamsize flush() {
+        return 0;
+    }
+};
+
+std::string make_data(size_t len) {
+    auto res = std::string();
+    uint32_t state = 42;
+    for (size_t i = 0; i < len; i++) {
+        state = state * 1103515245 + 12345;
+        res.push_back(static_cast<char>('a' + (state >> 16) % 8));
+    }
+    return res;
+}
+
+std::string inflate(const std::string& compressed) {
+    auto src = sl::compress::make_inflate_source(sl::io::array_source(compressed.data(), compressed.length()));
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(src, sink);
+    return sink.get_string();
+}
+
+void test_controller() {
+    auto ctl = sl::compress::adaptive_level(2, 7, 100);
+    ctl.reset(9);
+    slassert(7 == ctl.get_level());
+    slassert(!ctl.record(50, 1000, 10));
+    slassert(ctl.record(50, 1000, 10));
+    // codec-bound
+    slassert(6 == ctl.adjust());
+    ctl.record(100, 10, 1000);
+    // sink-bound
+    slassert(7 == ctl.adjust());
+    ctl.record(100, 10, 1000);
+    slassert(7 == ctl.adjust());
+    // balanced
+    ctl.record(100, 1000, 1000);
+    slassert(7 == ctl.adjust());
+    for (size_t i = 0; i < 10; i++) {
+        ctl.record(100, 1000, 0);
+        ctl.adjust();
+    }
+    slassert(2 == ctl.get_level());
+}
+
+void test_invalid() {
+    bool thrown = false;
+    try {
+        sl::compress::adaptive_level(5, 3);
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+void test_fast_sink() {
+    auto data = make_data(1 << 20);
+    auto ss = sl::io::string_sink();
+    int level = 0;
+    {
+        auto deflater = sl::compress::make_deflate_sink(ss, sl::compress::adaptive_level(1, 9, 64 * 1024));
+        slassert(6 == deflater.get_compression_level());
+        sl::io::write_all(deflater, {data.data(), data.length()});
+        level = deflater.get_compression_level();
+    }
+    // compression is the bottleneck
+    slassert(level < 6);
+    slassert(data == inflate(ss.get_string()));
+}
+
+void test_slow_sink() {
+    auto data = make_data(1 << 20);
+    auto compressed = std::string();
+    int level = 0;
+    {
+        auto deflater = sl::compress::make_deflate_sink(slow_sink(compressed),
+                sl::compress::adaptive_level(1, 9, 64 * 1024));
+        for (size_t i = 0; i < data.length(); i += 4096) {
+            sl::io::write_all(deflater, {data.data() + i, 4096});
+        }
+        level = deflater.get_compression_level();
+    }
+    // sink is the bottleneck
+    slassert(level > 6);
+    slassert(data == inflate(compressed));
+}
+
+int main() {
+    try {
+        test_controller();
+        test_invalid();
+        test_fast_sink();
+        test_slow_sink();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
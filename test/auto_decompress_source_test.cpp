@@ -0,0 +1,153 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   auto_decompress_source_test.cpp
+ * Author: alex
+ *
+ * Created on October 20, 2026, 6:05 PM
+ */
+
+#include "staticlib/compress/auto_decompress_source.hpp"
+
+#include <cstring>
+#include <array>
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/tinydir.hpp"
+
+#include "staticlib/compress/deflate_buffer.hpp"
+#include "staticlib/compress/lzma_buffer.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
+
+std::string read_file(const std::string& path) {
+    auto fd = sl::tinydir::file_source(path);
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(fd, sink);
+    return sink.get_string();
+}
+
+std::string zlib_compress(const std::string& data, int window_bits) {
+    sl::compress::detail::zlib_stream strm;
+    std::memset(std::addressof(strm), 0, sizeof(strm));
+    sl::compress::detail::zlib_deflate_init2(std::addressof(strm), 6, window_bits, 8, Z_DEFAULT_STRATEGY);
+    auto res = std::string();
+    res.resize(sl::compress::detail::zlib_deflate_bound(std::addressof(strm), data.length()) + 32);
+    strm.next_in = reinterpret_cast<const unsigned char*> (data.data());
+    strm.avail_in = static_cast<sl::compress::detail::zlib_uint> (data.length());
+    strm.next_out = reinterpret_cast<unsigned char*> (&res.front());
+    strm.avail_out = static_cast<sl::compress::detail::zlib_uint> (res.length());
+    slassert(Z_STREAM_END == sl::compress::detail::zlib_deflate(std::addressof(strm), Z_FINISH));
+    res.resize(strm.total_out);
+    sl::compress::detail::zlib_deflate_end(std::addressof(strm));
+    return res;
+}
+
+std::string decompress(const std::string& compressed, sl::compress::compression_format& format) {
+    auto src = sl::compress::make_auto_decompress_source(sl::io::array_source(compressed.data(), compressed.length()));
+    auto res = std::string();
+    // small reads to cross member boundaries mid-call
+    auto buf = std::array<char, 100>();
+    for (;;) {
+        std::streamsize len = src.read({buf.data(), buf.size()});
+        if (std::char_traits<char>::eof() == len) break;
+        res.append(buf.data(), static_cast<size_t>(len));
+    }
+    format = src.get_format();
+    return res;
+}
+
+std::string make_data(size_t len, size_t seed) {
+    auto res = std::string();
+    for (size_t i = 0; i < len; i++) {
+        res.push_back(static_cast<char>('a' + (i * i + seed) % 19));
+    }
+    return res;
+}
+
+void test_detect() {
+    auto deflated = read_file("../test/data/hello.txt.deflate");
+    auto xz = read_file("../test/data/hello.txt.xz");
+    auto zlib = zlib_compress("hello", MAX_WBITS);
+    auto gzip = zlib_compress("hello", MAX_WBITS + 16);
+    slassert(sl::compress::compression_format::raw_deflate == sl::compress::detect_compression_format(
+            {deflated.data(), deflated.length()}));
+    slassert(sl::compress::compression_format::xz == sl::compress::detect_compression_format(
+            {xz.data(), xz.length()}));
+    slassert(sl::compress::compression_format::zlib == sl::compress::detect_compression_format(
+            {zlib.data(), zlib.length()}));
+    slassert(sl::compress::compression_format::gzip == sl::compress::detect_compression_format(
+            {gzip.data(), gzip.length()}));
+    slassert(sl::compress::compression_format::unknown == sl::compress::detect_compression_format(
+            {"", 0}));
+}
+
+void test_single() {
+    auto data = make_data(50000, 1);
+    auto format = sl::compress::compression_format::unknown;
+    slassert(data == decompress(sl::compress::deflate_buffer({data.data(), data.length()}), format));
+    slassert(sl::compress::compression_format::raw_deflate == format);
+    slassert(data == decompress(zlib_compress(data, MAX_WBITS), format));
+    slassert(sl::compress::compression_format::zlib == format);
+    slassert(data == decompress(zlib_compress(data, MAX_WBITS + 16), format));
+    slassert(sl::compress::compression_format::gzip == format);
+    slassert(data == decompress(sl::compress::lzma_encode_buffer({data.data(), data.length()}), format));
+    slassert(sl::compress::compression_format::xz == format);
+}
+
+void test_concatenated() {
+    auto d1 = make_data(10000, 1);
+    auto d2 = make_data(20000, 2);
+    auto d3 = make_data(30000, 3);
+    auto d4 = make_data(5000, 4);
+    auto compressed = zlib_compress(d1, MAX_WBITS + 16) +
+            sl::compress::lzma_encode_buffer({d2.data(), d2.length()}) + std::string(8, '\0') +
+            zlib_compress(d3, MAX_WBITS) +
+            sl::compress::deflate_buffer({d4.data(), d4.length()});
+    auto format = sl::compress::compression_format::unknown;
+    slassert(d1 + d2 + d3 + d4 == decompress(compressed, format));
+    slassert(sl::compress::compression_format::raw_deflate == format);
+}
+
+void test_truncated() {
+    auto data = make_data(50000, 1);
+    auto compressed = zlib_compress(data, MAX_WBITS + 16);
+    compressed.resize(compressed.length() / 2);
+    auto format = sl::compress::compression_format::unknown;
+    bool thrown = false;
+    try {
+        decompress(compressed, format);
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+int main() {
+    try {
+        test_detect();
+        test_single();
+        test_concatenated();
+        test_truncated();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
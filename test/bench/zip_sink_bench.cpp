@@ -0,0 +1,263 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   zip_sink_bench.cpp
+ * Author: alex
+ *
+ * Created on October 24, 2026, 4:30 PM
+ */
+
+// Entry-count scaling benchmark for zip_sink: archives with many tiny
+// entries are written into a null sink and into a file, per-entry
+// throughput, heap usage and peak RSS are reported for each run.
+// On POSIX every run is done in a forked child, so peak RSS belongs
+// to that run only; on Windows it is the growth of the process peak
+// during the run, that is understated after larger runs.
+//
+// Usage: zip_sink_bench [max_entries] [output_file]
+//
+// Entry counts are 1k, 10k, 100k and so on up to max_entries (5M by default),
+// archives with more than 65534 entries are written with ZIP64 records.
+
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else // !_WIN32
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+
+#include "staticlib/compress/zip_sink.hpp"
+#include "staticlib/compress/zlib_backend.hpp"
+
+namespace { // anonymous
+
+std::atomic<uint64_t> heap_bytes(0);
+std::atomic<uint64_t> heap_calls(0);
+
+void count_alloc(size_t size) {
+    heap_bytes.fetch_add(size, std::memory_order_relaxed);
+    heap_calls.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+#ifdef __GLIBC__
+// glibc allows to interpose malloc from the executable, that also
+// covers allocations made by zlib and by the default operator new
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) {
+    count_alloc(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    count_alloc(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    count_alloc(size);
+    return __libc_realloc(ptr, size);
+}
+
+} // extern "C"
+
+#else // !__GLIBC__
+// only C++ allocations are counted, zlib state is visible in peak RSS
+
+void* operator new(size_t size) {
+    count_alloc(size);
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if (nullptr == ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) STATICLIB_NOEXCEPT {
+    std::free(ptr);
+}
+
+#endif // __GLIBC__
+
+namespace { // anonymous
+
+#ifdef _WIN32
+
+uint64_t peak_rss_kb() {
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+    return static_cast<uint64_t>(pmc.PeakWorkingSetSize >> 10);
+}
+
+uint64_t current_rss_kb() {
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+    return static_cast<uint64_t>(pmc.WorkingSetSize >> 10);
+}
+
+#else // !_WIN32
+
+uint64_t rusage_rss_kb(const struct rusage& ru) {
+#ifdef __APPLE__
+    return static_cast<uint64_t>(ru.ru_maxrss >> 10);
+#else // linux
+    return static_cast<uint64_t>(ru.ru_maxrss);
+#endif // __APPLE__
+}
+
+#endif // _WIN32
+
+enum class entry_api { streamed, in_memory };
+
+template <typename Sink>
+void write_entries(Sink&& sink, size_t entries_count, const std::string& data, entry_api api) {
+    auto sink_ptr = sl::compress::make_zip_sink(std::move(sink));
+    auto& zip = sink_ptr.get_sink();
+    auto name = std::string();
+    for (size_t i = 0; i < entries_count; i++) {
+        name.assign("dir_");
+        name.append(sl::support::to_string(i % 1000));
+        name.append("/file_");
+        name.append(sl::support::to_string(i));
+        name.append(".txt");
+        if (entry_api::streamed == api) {
+            zip.add_entry(name);
+            sl::io::write_all(zip, {data.data(), data.length()});
+        } else {
+            zip.add_entry(name, {data.data(), data.length()});
+        }
+    }
+    zip.finalize();
+}
+
+template <typename Sink>
+void measure(const std::string& label, Sink&& sink, size_t entries_count, size_t entry_size, entry_api api) {
+    auto data = std::string();
+    for (size_t i = 0; i < entry_size; i++) {
+        data.push_back(static_cast<char>('a' + (i * 7 + i / 13) % 26));
+    }
+    uint64_t bytes_before = heap_bytes.load();
+    uint64_t calls_before = heap_calls.load();
+    auto start = std::chrono::steady_clock::now();
+    write_entries(std::move(sink), entries_count, data, api);
+    auto dur = std::chrono::steady_clock::now() - start;
+    double secs = std::chrono::duration_cast<std::chrono::duration<double>>(dur).count();
+    double bytes = static_cast<double>(heap_bytes.load() - bytes_before);
+    double calls = static_cast<double>(heap_calls.load() - calls_before);
+    std::cout << label <<
+            "\t" << entries_count <<
+            "\t" << entry_size <<
+            "\t" << (entry_api::streamed == api ? "streamed" : "in_memory") <<
+            "\t" << static_cast<uint64_t>(static_cast<double>(entries_count) / secs) <<
+            "\t" << static_cast<uint64_t>(bytes / static_cast<double>(entries_count)) <<
+            "\t" << (calls / static_cast<double>(entries_count)) << std::flush;
+}
+
+// sink is created inside the measured process, so file runs
+// do not share the descriptor with the parent
+template <typename Factory>
+void run(const std::string& label, Factory factory, size_t entries_count, size_t entry_size, entry_api api) {
+#ifdef _WIN32
+    uint64_t rss_before = current_rss_kb();
+    measure(label, factory(), entries_count, entry_size, api);
+    uint64_t peak = peak_rss_kb();
+    std::cout << "\t" << (peak > rss_before ? peak - rss_before : 0) << std::endl;
+#else // !_WIN32
+    pid_t pid = fork();
+    if (pid < 0) throw std::runtime_error("'fork' failed");
+    if (0 == pid) {
+        int code = 0;
+        try {
+            measure(label, factory(), entries_count, entry_size, api);
+        } catch (const std::exception& e) {
+            std::cout << "\t" << e.what() << std::flush;
+            code = 1;
+        }
+        std::_Exit(code);
+    }
+    int status = 0;
+    struct rusage ru;
+    if (pid != wait4(pid, std::addressof(status), 0, std::addressof(ru))) {
+        throw std::runtime_error("'wait4' failed");
+    }
+    std::cout << "\t" << rusage_rss_kb(ru) << std::endl;
+    if (!WIFEXITED(status) || 0 != WEXITSTATUS(status)) {
+        throw std::runtime_error("Benchmark run failed: [" + label + "]");
+    }
+#endif // _WIN32
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        size_t max_entries = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : 5000000;
+        std::string path = argc > 2 ? std::string(argv[2]) : std::string("zip_sink_bench.zip");
+        std::cout << "backend: " << sl::compress::deflate_backend_name() << std::endl;
+        std::cout << "sink\tentries\tsize\tapi\tentries/s\theap_bytes/entry\tallocs/entry\tpeak_rss_kb" << std::endl;
+        auto sizes = std::vector<size_t>{0, 64, 1024};
+        auto apis = std::vector<entry_api>{entry_api::streamed, entry_api::in_memory};
+        auto null_factory = [] {
+            return sl::io::null_sink();
+        };
+        auto file_factory = [&path] {
+            return sl::tinydir::file_sink(path);
+        };
+        auto counts = std::vector<size_t>();
+        for (size_t count = 1000; count < max_entries; count *= 10) {
+            counts.push_back(count);
+        }
+        counts.push_back(max_entries);
+        for (size_t count : counts) {
+            for (size_t size : sizes) {
+                for (entry_api api : apis) {
+                    run("null", null_factory, count, size, api);
+                    run("file", file_factory, count, size, api);
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   compress_batch_test.cpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 3:50 PM
+ */
+
+#include "staticlib/compress/compress_batch.hpp"
+
+#include <array>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+std::vector<std::string> make_records() {
+    auto res = std::vector<std::string>();
+    for (size_t i = 0; i < 1000; i++) {
+        auto rec = std::string();
+        for (size_t j = 0; j < i % 37; j++) {
+            rec += "record_" + sl::support::to_string(i) + "_" + sl::support::to_string(j % 5) + ";";
+        }
+        res.push_back(rec);
+    }
+    return res;
+}
+
+std::vector<sl::io::span<const char>> to_spans(const std::vector<std::string>& records) {
+    auto res = std::vector<sl::io::span<const char>>();
+    for (auto& rec : records) {
+        res.emplace_back(rec.data(), rec.length());
+    }
+    return res;
+}
+
+void test_deflate() {
+    auto records = make_records();
+    auto batch = sl::compress::compress_batch(to_spans(records), sl::compress::batch_codec::deflate, 6, 4);
+    slassert(records.size() == batch.size());
+    slassert(batch.get_data().length() == batch.get_offsets().back());
+    // buffer allocated for compression bounds is not kept
+    slassert(batch.get_data().capacity() - batch.get_data().length() <= batch.get_data().length() / 8);
+    for (size_t i = 0; i < records.size(); i++) {
+        auto span = batch.get(i);
+        slassert(records[i] == sl::compress::inflate_buffer(span, records[i].length()));
+    }
+}
+
+void test_lzma() {
+    auto records = make_records();
+    auto batch = sl::compress::compress_batch(to_spans(records), sl::compress::batch_codec::lzma, 1, 3);
+    slassert(records.size() == batch.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        auto span = batch.get(i);
+        slassert(records[i] == sl::compress::lzma_decode_buffer(span, records[i].length()));
+    }
+}
+
+void test_empty() {
+    auto batch = sl::compress::compress_batch(std::vector<sl::io::span<const char>>());
+    slassert(0 == batch.size());
+    slassert(batch.get_data().empty());
+}
+
+int main() {
+    try {
+        test_deflate();
+        test_lzma();
+        test_empty();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   compressed_buffer_test.cpp
+ * Author: alex
+ *
+ * Created on October 27, 2026, 11:45 AM
+ */
+
+#include "staticlib/compress/compressed_buffer.hpp"
+
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+std::string make_data(size_t len) {
+    auto res = std::string();
+    for (size_t i = 0; res.length() < len; i++) {
+        res += "line_" + sl::support::to_string(i % 1000) + "_" + sl::support::to_string(i % 7) + "\n";
+    }
+    res.resize(len);
+    return res;
+}
+
+void fill(sl::compress::compressed_buffer& buf, const std::string& data) {
+    size_t pos = 0;
+    for (size_t i = 1; pos < data.length(); i++) {
+        size_t len = std::min(i * 113, data.length() - pos);
+        buf.append({data.data() + pos, len});
+        pos += len;
+    }
+}
+
+void check_random_reads(sl::compress::compressed_buffer& buf, const std::string& data) {
+    auto rng = std::mt19937(42);
+    auto out = std::string();
+    for (size_t i = 0; i < 500; i++) {
+        size_t offset = rng() % data.length();
+        size_t len = rng() % 10000;
+        out.resize(len);
+        size_t read = buf.read(offset, {&out.front(), out.length()});
+        slassert(read == std::min(len, data.length() - offset));
+        slassert(0 == data.compare(offset, read, out.data(), read));
+    }
+}
+
+void test_deflate() {
+    auto data = make_data(1000003);
+    auto buf = sl::compress::compressed_buffer(sl::compress::batch_codec::deflate, 1 << 14, 6, 2);
+    fill(buf, data);
+    slassert(data.length() == buf.size());
+    slassert(data.length() / (1 << 14) == buf.blocks_count());
+    slassert(buf.compressed_size() < data.length() / 4);
+    check_random_reads(buf, data);
+    slassert(buf.get_cache_misses() > 0);
+
+    // sequential read through cache
+    auto out = std::string(data.length(), '\0');
+    size_t pos = 0;
+    while (pos < out.length()) {
+        pos += buf.read(pos, {&out.front() + pos, std::min(static_cast<size_t>(1000), out.length() - pos)});
+    }
+    slassert(data == out);
+    slassert(buf.get_cache_hits() > buf.get_cache_misses());
+    slassert(0 == buf.read(buf.size(), {&out.front(), 1}));
+    bool thrown = false;
+    try {
+        buf.read(buf.size() + 1, {&out.front(), 1});
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+void test_lzma() {
+    auto data = make_data(300007);
+    auto buf = sl::compress::compressed_buffer(sl::compress::batch_codec::lzma, 1 << 16, 1);
+    fill(buf, data);
+    slassert(data.length() == buf.size());
+    slassert(buf.compressed_size() < data.length() / 4);
+    check_random_reads(buf, data);
+}
+
+void test_sink() {
+    auto data = make_data(100000);
+    auto buf = sl::compress::compressed_buffer(sl::compress::batch_codec::deflate, 4096);
+    auto src = sl::io::array_source(data.data(), data.length());
+    auto chunk = std::string(1000, '\0');
+    for (;;) {
+        auto read = src.read({&chunk.front(), chunk.length()});
+        if (std::char_traits<char>::eof() == read) break;
+        buf.write({chunk.data(), static_cast<size_t>(read)});
+    }
+    slassert(data.length() == buf.size());
+    buf.shrink_to_fit();
+    auto moved = std::move(buf);
+    auto out = std::string(data.length(), '\0');
+    slassert(data.length() == moved.read(0, {&out.front(), out.length()}));
+    slassert(data == out);
+}
+
+void test_empty() {
+    auto buf = sl::compress::compressed_buffer();
+    slassert(0 == buf.size());
+    slassert(0 == buf.blocks_count());
+    auto out = std::string(1, '\0');
+    slassert(0 == buf.read(0, {&out.front(), out.length()}));
+}
+
+int main() {
+    try {
+        test_deflate();
+        test_lzma();
+        test_sink();
+        test_empty();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   deflate_buffer_test.cpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 12:10 PM
+ */
+
+#include "staticlib/compress/deflate_buffer.hpp"
+
+#include <array>
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/tinydir.hpp"
+
+std::string read_file(const std::string& path) {
+    auto fd = sl::tinydir::file_source(path);
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(fd, sink);
+    return sink.get_string();
+}
+
+void test_deflate() {
+    auto expected = read_file("../test/data/hello.txt.deflate");
+    auto data = read_file("../test/data/hello.txt");
+    auto compressed = sl::compress::deflate_buffer({data.data(), data.length()});
+#ifdef STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+    // libdeflate output differs from zlib one
+    slassert(data == sl::compress::inflate_buffer({compressed.data(), compressed.length()}));
+    (void) expected;
+#else
+    slassert(expected == compressed);
+    // second call reuses thread-local state
+    slassert(expected == sl::compress::deflate_buffer({data.data(), data.length()}));
+#endif // STATICLIB_COMPRESS_ENABLE_LIBDEFLATE
+}
+
+void test_inflate() {
+    auto compressed = read_file("../test/data/hello.txt.deflate");
+    auto data = sl::compress::inflate_buffer({compressed.data(), compressed.length()});
+    slassert("hello" == data);
+    auto buf = std::array<char, 5>();
+    size_t len = sl::compress::inflate_into({compressed.data(), compressed.length()}, {buf.data(), buf.size()});
+    slassert(5 == len);
+    slassert("hello" == std::string(buf.data(), len));
+}
+
+void test_roundtrip() {
+    auto data = std::string();
+    for (size_t i = 0; i < 100000; i++) {
+        data.push_back(static_cast<char>('a' + (i * i) % 7));
+    }
+    for (int level = 1; level <= 9; level++) {
+        auto compressed = sl::compress::deflate_buffer({data.data(), data.length()}, level);
+        slassert(compressed.length() <= sl::compress::deflate_bound(data.length(), level));
+        // unknown size, output buffer is grown
+        slassert(data == sl::compress::inflate_buffer({compressed.data(), compressed.length()}));
+        slassert(data == sl::compress::inflate_buffer({compressed.data(), compressed.length()}, data.length()));
+    }
+}
+
+void test_small_output() {
+    auto data = std::string(1000, 'x');
+    auto buf = std::array<char, 2>();
+    bool thrown = false;
+    try {
+        sl::compress::deflate_into({data.data(), data.length()}, {buf.data(), buf.size()});
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+int main() {
+    try {
+        test_deflate();
+        test_inflate();
+        test_roundtrip();
+        test_small_output();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
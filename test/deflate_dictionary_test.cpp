@@ -0,0 +1,112 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   deflate_dictionary_test.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 4:10 PM
+ */
+
+#include "staticlib/compress/deflate_dictionary.hpp"
+
+#include <array>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/deflate_sink.hpp"
+#include "staticlib/compress/inflate_source.hpp"
+
+std::string make_message(size_t idx) {
+    return "{\"id\": " + sl::support::to_string(idx * 7919 % 100003) + "," +
+            " \"type\": \"" + (0 == idx % 3 ? "order" : "payment") + "\"," +
+            " \"status\": \"" + (0 == idx % 2 ? "accepted" : "rejected") + "\"," +
+            " \"customer\": {\"name\": \"customer_" + sl::support::to_string(idx) + "\"," +
+            " \"country\": \"" + (0 == idx % 5 ? "Netherlands" : "Germany") + "\"}," +
+            " \"amount\": " + sl::support::to_string(idx * 31 % 977) + "." + sl::support::to_string(idx % 100) + "," +
+            " \"currency\": \"EUR\", \"created\": \"2026-10-18T15:" + sl::support::to_string(10 + idx % 50) + ":00Z\"}";
+}
+
+std::string compress(const std::string& msg, const sl::compress::deflate_dictionary* dict) {
+    auto sink = sl::io::string_sink();
+    if (nullptr != dict) {
+        auto deflater = sl::compress::make_deflate_sink(sink, *dict);
+        sl::io::write_all(deflater, {msg.data(), msg.length()});
+    } else {
+        auto deflater = sl::compress::make_deflate_sink(sink);
+        sl::io::write_all(deflater, {msg.data(), msg.length()});
+    }
+    return sink.get_string();
+}
+
+void test_dictionary() {
+    auto samples = std::vector<std::string>();
+    for (size_t i = 0; i < 500; i++) {
+        samples.push_back(make_message(i));
+    }
+    auto data = sl::compress::train_deflate_dictionary(samples, 4096);
+    slassert(data.length() > 0);
+    slassert(data.length() <= 4096);
+    auto dict = sl::compress::global_dictionary_registry().put(sl::compress::deflate_dictionary(42, data));
+    slassert(dict.get() == sl::compress::global_dictionary_registry().get(42).get());
+
+    auto msg = make_message(1000);
+    auto plain = compress(msg, nullptr);
+    auto with_dict = compress(msg, dict.get());
+    slassert(with_dict.length() * 2 < plain.length());
+
+    // shared dictionary is referenced only until the stream is created
+    auto shared_sink = sl::io::string_sink();
+    {
+        auto deflater = sl::compress::make_deflate_sink(shared_sink, dict);
+        slassert(!deflater.is_initialized());
+        slassert(dict.use_count() > 2);
+        sl::io::write_all(deflater, {msg.data(), msg.length()});
+        slassert(deflater.is_initialized());
+        slassert(2 == dict.use_count());
+    }
+    slassert(with_dict == shared_sink.get_string());
+
+    auto src = sl::io::string_source(with_dict);
+    auto inflater = sl::compress::make_inflate_source(src, *sl::compress::global_dictionary_registry().get(42));
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(inflater, sink);
+    slassert(msg == sink.get_string());
+
+    slassert(sl::compress::global_dictionary_registry().remove(42));
+    bool thrown = false;
+    try {
+        sl::compress::global_dictionary_registry().get(42);
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+int main() {
+    try {
+        test_dictionary();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
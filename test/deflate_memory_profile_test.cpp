@@ -0,0 +1,136 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   deflate_memory_profile_test.cpp
+ * Author: alex
+ *
+ * Created on October 24, 2026, 12:05 PM
+ */
+
+#include "staticlib/compress/deflate_memory_profile.hpp"
+
+#include <array>
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/deflate_sink.hpp"
+#include "staticlib/compress/inflate_decoder.hpp"
+#include "staticlib/compress/inflate_source.hpp"
+
+// decodes the stream prefix that is not yet completed with final block
+std::string inflate_partial(const std::string& compressed) {
+    auto dec = sl::compress::inflate_decoder();
+    auto buf = std::array<char, 1024>();
+    auto out = std::string();
+    size_t pos = 0;
+    for (;;) {
+        auto res = dec.decode({compressed.data() + pos, compressed.length() - pos}, {buf.data(), buf.size()});
+        pos += res.get_consumed();
+        out.append(buf.data(), res.get_produced());
+        if (sl::compress::decode_status::output_full != res.get_status()) break;
+    }
+    return out;
+}
+
+std::string inflate(const std::string& compressed) {
+    auto src = sl::compress::make_inflate_source(sl::io::array_source(compressed.data(), compressed.length()));
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(src, sink);
+    return sink.get_string();
+}
+
+void test_profile() {
+    auto standard = sl::compress::deflate_memory_profile();
+    slassert(MAX_WBITS == standard.get_window_bits());
+    slassert(8 == standard.get_mem_level());
+    slassert(standard.is_context_takeover());
+    auto low = sl::compress::deflate_memory_profile::low_memory();
+    slassert(!low.is_context_takeover());
+    slassert(low.state_size() * 16 < standard.state_size());
+}
+
+void test_invalid() {
+    bool thrown = false;
+    try {
+        sl::compress::deflate_memory_profile(8, 8);
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+    thrown = false;
+    try {
+        sl::compress::deflate_memory_profile(MAX_WBITS, 10);
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+void test_messages() {
+    auto ss = sl::io::string_sink();
+    auto expected = std::string();
+    {
+        auto deflater = sl::compress::make_deflate_sink(ss, sl::compress::deflate_memory_profile::low_memory());
+        slassert(!deflater.is_initialized());
+        for (size_t i = 0; i < 10; i++) {
+            auto msg = "message " + sl::support::to_string(i) + ", message " + sl::support::to_string(i);
+            sl::io::write_all(deflater, {msg.data(), msg.length()});
+            expected += msg;
+            slassert(deflater.is_initialized());
+            size_t len_before = ss.get_string().length();
+            deflater.end_message();
+            // state is released between messages
+            slassert(!deflater.is_initialized());
+            // messages are flushed completely
+            slassert(ss.get_string().length() > len_before);
+            slassert(expected == inflate_partial(ss.get_string()));
+        }
+    }
+    slassert(expected == inflate(ss.get_string()));
+}
+
+void test_context_takeover() {
+    auto ss = sl::io::string_sink();
+    auto msg = std::string("message with context takeover");
+    {
+        auto deflater = sl::compress::make_deflate_sink(ss, sl::compress::deflate_memory_profile(12, 4, true));
+        for (size_t i = 0; i < 3; i++) {
+            sl::io::write_all(deflater, {msg.data(), msg.length()});
+            deflater.end_message();
+            slassert(deflater.is_initialized());
+        }
+    }
+    slassert(msg + msg + msg == inflate(ss.get_string()));
+}
+
+int main() {
+    try {
+        test_profile();
+        test_invalid();
+        test_messages();
+        test_context_takeover();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -23,13 +23,18 @@
 
 #include "staticlib/compress/deflate_sink.hpp"
 
+#include <algorithm>
 #include <array>
 #include <iostream>
+#include <string>
 
 #include "staticlib/config/assert.hpp"
 #include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
 #include "staticlib/tinydir.hpp"
 
+#include "staticlib/compress/inflate_source.hpp"
+
 void test_deflate() {
     auto fd_comp = sl::tinydir::file_source("../test/data/hello.txt.deflate");
     auto ss_comp = sl::io::string_sink();
@@ -45,6 +50,60 @@ void test_deflate() {
     slassert(ss_comp.get_string() == ss.get_string());
 }
 
+void test_lazy() {
+    auto ss = sl::io::string_sink();
+    {
+        auto deflater = sl::compress::make_deflate_sink(ss);
+        slassert(!deflater.is_initialized());
+        deflater.write({"", 0});
+        slassert(!deflater.is_initialized());
+    }
+    // empty stream is still valid
+    auto src = sl::compress::make_inflate_source(sl::io::array_source(ss.get_string().data(), ss.get_string().length()));
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(src, sink);
+    slassert(sink.get_string().empty());
+}
+
+std::string deflate_rsyncable(const std::string& data, bool full_flush) {
+    auto ss = sl::io::string_sink();
+    {
+        auto deflater = sl::compress::make_deflate_sink(ss, sl::compress::rsyncable_chunker(13, 1024, full_flush));
+        for (size_t i = 0; i < data.length(); i += 1000) {
+            sl::io::write_all(deflater, {data.data() + i, std::min(data.length() - i, static_cast<size_t>(1000))});
+        }
+    }
+    return ss.get_string();
+}
+
+size_t common_suffix(const std::string& first, const std::string& second) {
+    size_t res = 0;
+    while (res < first.length() && res < second.length() &&
+            first[first.length() - res - 1] == second[second.length() - res - 1]) {
+        res += 1;
+    }
+    return res;
+}
+
+void test_rsyncable() {
+    auto data = std::string();
+    for (size_t i = 0; data.length() < (1 << 20); i++) {
+        data += "line " + sl::support::to_string(i * 7919 % 100003) + " of rsyncable test\n";
+    }
+    auto edited = data;
+    edited[100] = 'X';
+    for (bool full_flush : {false, true}) {
+        auto orig = deflate_rsyncable(data, full_flush);
+        auto changed = deflate_rsyncable(edited, full_flush);
+        // output resynchronizes after the edit
+        slassert(common_suffix(orig, changed) * 10 > orig.length() * 9);
+        auto src = sl::compress::make_inflate_source(sl::io::array_source(changed.data(), changed.length()));
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        slassert(edited == sink.get_string());
+    }
+}
+
 void test_huge() {
     auto fd_in = sl::tinydir::file_source("/home/alex/vbox/hd/winxp_printer.vdi");
     auto deflater = sl::compress::make_deflate_sink(sl::tinydir::file_sink("winxp_printer.vdi.deflate"));
@@ -54,6 +113,8 @@ void test_huge() {
 int main() {
     try {
         test_deflate();
+        test_lazy();
+        test_rsyncable();
 //        test_huge();
     } catch (const std::exception& e) {
         std::cout << e.what() << std::endl;
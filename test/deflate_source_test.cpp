@@ -0,0 +1,119 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   deflate_source_test.cpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 4:45 PM
+ */
+
+#include "staticlib/compress/deflate_source.hpp"
+
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+
+#include "staticlib/compress/deflate_sink.hpp"
+#include "staticlib/compress/inflate_source.hpp"
+
+std::string read_file(const std::string& path) {
+    auto fd = sl::tinydir::file_source(path);
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(fd, sink);
+    return sink.get_string();
+}
+
+void test_deflate() {
+    auto expected = read_file("../test/data/hello.txt.deflate");
+    auto src = sl::compress::make_deflate_source(sl::tinydir::file_source("../test/data/hello.txt"));
+    auto ss = sl::io::string_sink();
+    sl::io::copy_all(src, ss);
+    slassert(expected == ss.get_string());
+}
+
+void test_roundtrip() {
+    auto data = std::string();
+    for (size_t i = 0; i < 100000; i++) {
+        data.push_back(static_cast<char>('a' + (i * i) % 13));
+    }
+    // same output as deflate_sink
+    auto expected = sl::io::string_sink();
+    {
+        auto sink = sl::compress::make_deflate_sink(expected);
+        sl::io::write_all(sink, {data.data(), data.length()});
+    }
+    auto arr = sl::io::array_source(data.data(), data.length());
+    auto deflater = sl::compress::make_deflate_source(arr);
+    auto compressed = sl::io::string_sink();
+    sl::io::copy_all(deflater, compressed);
+    slassert(expected.get_string() == compressed.get_string());
+
+    // pipeline without intermediate buffers
+    auto inflater = sl::compress::make_inflate_source(sl::compress::make_deflate_source(
+            sl::io::array_source(data.data(), data.length())));
+    auto result = sl::io::string_sink();
+    sl::io::copy_all(inflater, result);
+    slassert(data == result.get_string());
+}
+
+void test_options() {
+    auto data = std::string();
+    for (size_t i = 0; i < 10000; i++) {
+        data += "{\"id\": " + sl::support::to_string(i % 97) + ", \"status\": \"active\"}\n";
+    }
+    auto dict = sl::compress::deflate_dictionary(1, "{\"id\": , \"status\": \"active\"}\n");
+    auto profile = sl::compress::deflate_memory_profile::low_memory();
+
+    // same output as deflate_sink with the same options
+    auto expected_dict = sl::io::string_sink();
+    {
+        auto sink = sl::compress::make_deflate_sink(expected_dict, dict);
+        sl::io::write_all(sink, {data.data(), data.length()});
+    }
+    auto arr = sl::io::array_source(data.data(), data.length());
+    auto with_dict = sl::compress::make_deflate_source(arr, dict);
+    auto compressed_dict = sl::io::string_sink();
+    sl::io::copy_all(with_dict, compressed_dict);
+    slassert(expected_dict.get_string() == compressed_dict.get_string());
+
+    auto expected_profile = sl::io::string_sink();
+    {
+        auto sink = sl::compress::make_deflate_sink(expected_profile, profile);
+        sl::io::write_all(sink, {data.data(), data.length()});
+    }
+    auto with_profile = sl::compress::make_deflate_source(
+            sl::io::array_source(data.data(), data.length()), profile);
+    auto compressed_profile = sl::io::string_sink();
+    sl::io::copy_all(with_profile, compressed_profile);
+    slassert(expected_profile.get_string() == compressed_profile.get_string());
+}
+
+int main() {
+    try {
+        test_deflate();
+        test_roundtrip();
+        test_options();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   inflate_decoder_test.cpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 12:00 PM
+ */
+
+#include "staticlib/compress/inflate_decoder.hpp"
+
+#include <array>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/deflate_buffer.hpp"
+#include "staticlib/compress/deflate_sink.hpp"
+
+std::string make_data(size_t len) {
+    auto res = std::string();
+    for (size_t i = 0; i < len; i++) {
+        res.push_back(static_cast<char>('a' + (i * i) % 17));
+    }
+    return res;
+}
+
+void test_feed() {
+    auto data = make_data(100000);
+    auto compressed = sl::compress::deflate_buffer({data.data(), data.length()});
+    // trailing data after the end of stream
+    compressed.append("tail");
+    auto dec = sl::compress::inflate_decoder();
+    auto out = std::string();
+    size_t pos = 0;
+    // data arrives in small packets
+    while (!dec.is_done()) {
+        size_t len = std::min(static_cast<size_t>(333), compressed.length() - pos);
+        auto res = dec.feed({compressed.data() + pos, len}, [&out](sl::io::span<const char> sp) {
+            out.append(sp.data(), sp.size());
+        });
+        pos += res.get_consumed();
+        if (!res.is_done()) {
+            slassert(sl::compress::decode_status::need_input == res.get_status());
+            slassert(len == res.get_consumed());
+        }
+    }
+    slassert(data == out);
+    slassert("tail" == compressed.substr(pos));
+    // further input is ignored
+    auto res = dec.feed({"foo", 3}, [](sl::io::span<const char>) {});
+    slassert(res.is_done());
+    slassert(0 == res.get_consumed());
+}
+
+void test_decode() {
+    auto data = make_data(10000);
+    auto compressed = sl::compress::deflate_buffer({data.data(), data.length()});
+    auto dec = sl::compress::inflate_decoder();
+    auto buf = std::array<char, 1000>();
+    auto res = dec.decode({compressed.data(), compressed.length()}, {buf.data(), buf.size()});
+    slassert(sl::compress::decode_status::output_full == res.get_status());
+    slassert(1000 == res.get_produced());
+    auto out = std::string(buf.data(), res.get_produced());
+    size_t pos = res.get_consumed();
+    while (!res.is_done()) {
+        res = dec.decode({compressed.data() + pos, compressed.length() - pos}, {buf.data(), buf.size()});
+        pos += res.get_consumed();
+        out.append(buf.data(), res.get_produced());
+    }
+    slassert(data == out);
+
+    // reuse for the next stream
+    dec.reset();
+    auto data2 = make_data(500);
+    auto compressed2 = sl::compress::deflate_buffer({data2.data(), data2.length()});
+    res = dec.decode({compressed2.data(), compressed2.length()}, {buf.data(), buf.size()});
+    slassert(res.is_done());
+    slassert(data2 == std::string(buf.data(), res.get_produced()));
+}
+
+void test_dictionary() {
+    auto dict = sl::compress::deflate_dictionary(1, "hello world, hello dictionary");
+    auto ss = sl::io::string_sink();
+    auto data = std::string("hello world, hello dictionary, bye");
+    {
+        auto sink = sl::compress::make_deflate_sink(ss, dict);
+        sl::io::write_all(sink, {data.data(), data.length()});
+    }
+    auto& compressed = ss.get_string();
+    auto dec = sl::compress::inflate_decoder(dict);
+    auto out = std::string();
+    auto res = dec.feed({compressed.data(), compressed.length()}, [&out](sl::io::span<const char> sp) {
+        out.append(sp.data(), sp.size());
+    });
+    slassert(res.is_done());
+    slassert(data == out);
+
+    // reset with dictionary passed by reference
+    out.clear();
+    dec.reset({dict.get_data().data(), dict.get_data().length()});
+    res = dec.feed({compressed.data(), compressed.length()}, [&out](sl::io::span<const char> sp) {
+        out.append(sp.data(), sp.size());
+    });
+    slassert(res.is_done());
+    slassert(data == out);
+
+    // shared dictionary is not copied and is applied again on reset
+    auto shared = std::make_shared<const sl::compress::deflate_dictionary>(dict);
+    auto dec_shared = sl::compress::inflate_decoder(shared);
+    slassert(2 == shared.use_count());
+    for (size_t i = 0; i < 2; i++) {
+        out.clear();
+        res = dec_shared.feed({compressed.data(), compressed.length()}, [&out](sl::io::span<const char> sp) {
+            out.append(sp.data(), sp.size());
+        });
+        slassert(res.is_done());
+        slassert(data == out);
+        dec_shared.reset();
+    }
+}
+
+void test_invalid() {
+    auto dec = sl::compress::inflate_decoder();
+    bool thrown = false;
+    try {
+        dec.feed({"\xff\xff\xff\xff", 4}, [](sl::io::span<const char>) {});
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+int main() {
+    try {
+        test_feed();
+        test_decode();
+        test_dictionary();
+        test_invalid();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
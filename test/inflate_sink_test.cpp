@@ -0,0 +1,85 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   inflate_sink_test.cpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 4:30 PM
+ */
+
+#include "staticlib/compress/inflate_sink.hpp"
+
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/tinydir.hpp"
+
+#include "staticlib/compress/deflate_buffer.hpp"
+
+void test_inflate() {
+    auto fd = sl::tinydir::file_source("../test/data/hello.txt.deflate");
+    auto ss = sl::io::string_sink();
+    {
+        auto inflater = sl::compress::make_inflate_sink(ss);
+        sl::io::copy_all(fd, inflater);
+        slassert(inflater.is_done());
+    }
+    slassert("hello" == ss.get_string());
+}
+
+void test_chunked() {
+    auto data = std::string();
+    for (size_t i = 0; i < 100000; i++) {
+        data.push_back(static_cast<char>('a' + (i * i) % 13));
+    }
+    auto compressed = sl::compress::deflate_buffer({data.data(), data.length()});
+    auto inflater = sl::compress::make_inflate_sink(sl::io::string_sink());
+    for (size_t i = 0; i < compressed.length(); i += 100) {
+        size_t len = std::min(static_cast<size_t>(100), compressed.length() - i);
+        sl::io::write_all(inflater, {compressed.data() + i, len});
+        slassert(inflater.is_done() == (i + len == compressed.length()));
+    }
+    slassert(data == inflater.get_sink().get_string());
+}
+
+void test_trailing() {
+    auto compressed = sl::compress::deflate_buffer({"hello", 5});
+    compressed.append("tail");
+    auto inflater = sl::compress::make_inflate_sink(sl::io::string_sink());
+    bool thrown = false;
+    try {
+        sl::io::write_all(inflater, {compressed.data(), compressed.length()});
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+    slassert("hello" == inflater.get_sink().get_string());
+}
+
+int main() {
+    try {
+        test_inflate();
+        test_chunked();
+        test_trailing();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   latency_histogram_test.cpp
+ * Author: alex
+ *
+ * Created on October 25, 2026, 1:10 PM
+ */
+
+#include "staticlib/compress/latency_histogram.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+
+bool near(uint64_t value, uint64_t expected) {
+    // 32 sub-buckets give about 3% precision
+    uint64_t diff = value > expected ? value - expected : expected - value;
+    return diff * 32 <= expected;
+}
+
+void test_percentiles() {
+    auto hist = sl::compress::latency_histogram();
+    slassert(0 == hist.get_percentile(99));
+    for (uint64_t i = 1; i <= 100000; i++) {
+        hist.record(i * 1000);
+    }
+    slassert(100000 == hist.get_count());
+    slassert(1000 == hist.get_min());
+    slassert(100000000 == hist.get_max());
+    slassert(50000500 == hist.get_mean());
+    slassert(near(hist.get_percentile(50), 50000000));
+    slassert(near(hist.get_percentile(90), 90000000));
+    slassert(near(hist.get_percentile(99), 99000000));
+    slassert(near(hist.get_percentile(99.9), 99900000));
+    slassert(100000000 == hist.get_percentile(100));
+    slassert(1000 == hist.get_percentile(0));
+}
+
+void test_small_and_huge() {
+    auto hist = sl::compress::latency_histogram();
+    for (uint64_t i = 0; i < 32; i++) {
+        hist.record(i);
+    }
+    // exact below 32
+    slassert(15 == hist.get_percentile(50));
+    hist.record(UINT64_MAX);
+    slassert(UINT64_MAX == hist.get_percentile(100));
+}
+
+void test_tail() {
+    auto hist = sl::compress::latency_histogram();
+    for (size_t i = 0; i < 990; i++) {
+        hist.record(2000);
+    }
+    for (size_t i = 0; i < 10; i++) {
+        hist.record(5000000);
+    }
+    slassert(near(hist.get_percentile(50), 2000));
+    slassert(near(hist.get_percentile(99), 2000));
+    slassert(near(hist.get_percentile(99.9), 5000000));
+    auto summary = hist.summary();
+    slassert(std::string::npos != summary.find("count: 1000"));
+    slassert(std::string::npos != summary.find("p50: 2.0us"));
+    slassert(std::string::npos != summary.find("max: 5000.0us"));
+}
+
+void test_merge() {
+    auto first = sl::compress::latency_histogram();
+    auto second = sl::compress::latency_histogram();
+    first.record(100);
+    second.record(300);
+    first.merge(second);
+    slassert(2 == first.get_count());
+    slassert(100 == first.get_min());
+    slassert(300 == first.get_max());
+    first.reset();
+    slassert(0 == first.get_count());
+    slassert(0 == first.get_min());
+}
+
+void test_recorder() {
+    auto rec = sl::compress::latency_recorder();
+    rec.begin_call();
+    rec.add_io(300);
+    rec.add_io(200);
+    rec.end_call(sl::compress::latency_op::write, 1500);
+    rec.begin_call();
+    rec.end_call(sl::compress::latency_op::write, 700);
+    auto& codec = rec.get_codec(sl::compress::latency_op::write);
+    auto& io = rec.get_io(sl::compress::latency_op::write);
+    slassert(2 == codec.get_count());
+    slassert(1000 == codec.get_max());
+    slassert(700 == codec.get_min());
+    // calls without I/O are not recorded
+    slassert(1 == io.get_count());
+    slassert(500 == io.get_max());
+    slassert(0 == rec.get_codec(sl::compress::latency_op::read).get_count());
+    auto summary = rec.summary();
+    slassert(std::string::npos != summary.find("write codec: count: 2"));
+    slassert(std::string::npos != summary.find("write io: count: 1"));
+    slassert(std::string::npos == summary.find("read"));
+}
+
+int main() {
+    try {
+        test_percentiles();
+        test_small_and_huge();
+        test_tail();
+        test_merge();
+        test_recorder();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
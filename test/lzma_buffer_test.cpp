@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lzma_buffer_test.cpp
+ * Author: alex
+ *
+ * Created on October 19, 2026, 12:10 PM
+ */
+
+#include "staticlib/compress/lzma_buffer.hpp"
+
+#include <array>
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/tinydir.hpp"
+
+std::string read_file(const std::string& path) {
+    auto fd = sl::tinydir::file_source(path);
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(fd, sink);
+    return sink.get_string();
+}
+
+void test_encode() {
+    auto expected = read_file("../test/data/hello.txt.xz");
+    auto data = read_file("../test/data/hello.txt");
+    auto compressed = sl::compress::lzma_encode_buffer({data.data(), data.length()});
+    slassert(expected == compressed);
+    // second call reuses thread-local state
+    slassert(expected == sl::compress::lzma_encode_buffer({data.data(), data.length()}));
+}
+
+void test_decode() {
+    auto compressed = read_file("../test/data/hello.txt.xz");
+    auto data = sl::compress::lzma_decode_buffer({compressed.data(), compressed.length()});
+    slassert("hello" == data);
+    auto buf = std::array<char, 5>();
+    size_t len = sl::compress::lzma_decode_into({compressed.data(), compressed.length()}, {buf.data(), buf.size()});
+    slassert(5 == len);
+    slassert("hello" == std::string(buf.data(), len));
+}
+
+void test_roundtrip() {
+    auto data = std::string();
+    for (size_t i = 0; i < 100000; i++) {
+        data.push_back(static_cast<char>('a' + (i * i) % 7));
+    }
+    auto compressed = sl::compress::lzma_encode_buffer({data.data(), data.length()}, 1);
+    slassert(compressed.length() <= sl::compress::lzma_encode_bound(data.length()));
+    // unknown size, output buffer is grown
+    slassert(data == sl::compress::lzma_decode_buffer({compressed.data(), compressed.length()}));
+    slassert(data == sl::compress::lzma_decode_buffer({compressed.data(), compressed.length()}, data.length()));
+}
+
+int main() {
+    try {
+        test_encode();
+        test_decode();
+        test_roundtrip();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
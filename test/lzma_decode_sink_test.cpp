@@ -0,0 +1,70 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lzma_decode_sink_test.cpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 5:00 PM
+ */
+
+#include "staticlib/compress/lzma_decode_sink.hpp"
+
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/tinydir.hpp"
+
+#include "staticlib/compress/lzma_buffer.hpp"
+
+void test_decode() {
+    auto fd = sl::tinydir::file_source("../test/data/hello.txt.xz");
+    auto ss = sl::io::string_sink();
+    {
+        auto decoder = sl::compress::make_lzma_decode_sink(ss);
+        sl::io::copy_all(fd, decoder);
+        slassert(decoder.is_done());
+    }
+    slassert("hello" == ss.get_string());
+}
+
+void test_chunked() {
+    auto data = std::string();
+    for (size_t i = 0; i < 100000; i++) {
+        data.push_back(static_cast<char>('a' + (i * i) % 13));
+    }
+    auto compressed = sl::compress::lzma_encode_buffer({data.data(), data.length()});
+    auto decoder = sl::compress::make_lzma_decode_sink(sl::io::string_sink());
+    for (size_t i = 0; i < compressed.length(); i += 100) {
+        size_t len = std::min(static_cast<size_t>(100), compressed.length() - i);
+        sl::io::write_all(decoder, {compressed.data() + i, len});
+    }
+    slassert(decoder.is_done());
+    slassert(data == decoder.get_sink().get_string());
+}
+
+int main() {
+    try {
+        test_decode();
+        test_chunked();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
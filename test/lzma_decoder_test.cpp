@@ -0,0 +1,91 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lzma_decoder_test.cpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 12:30 PM
+ */
+
+#include "staticlib/compress/lzma_decoder.hpp"
+
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/lzma_buffer.hpp"
+
+std::string make_data(size_t len) {
+    auto res = std::string();
+    for (size_t i = 0; i < len; i++) {
+        res.push_back(static_cast<char>('a' + (i * i) % 17));
+    }
+    return res;
+}
+
+void test_feed() {
+    auto data = make_data(100000);
+    auto compressed = sl::compress::lzma_encode_buffer({data.data(), data.length()});
+    auto dec = sl::compress::lzma_decoder();
+    auto out = std::string();
+    size_t pos = 0;
+    while (!dec.is_done()) {
+        size_t len = std::min(static_cast<size_t>(100), compressed.length() - pos);
+        auto res = dec.feed({compressed.data() + pos, len}, [&out](sl::io::span<const char> sp) {
+            out.append(sp.data(), sp.size());
+        });
+        pos += res.get_consumed();
+    }
+    slassert(data == out);
+    slassert(compressed.length() == pos);
+
+    // reuse for the next stream
+    dec.reset();
+    out.clear();
+    auto res = dec.feed({compressed.data(), compressed.length()}, [&out](sl::io::span<const char> sp) {
+        out.append(sp.data(), sp.size());
+    });
+    slassert(res.is_done());
+    slassert(data.length() == res.get_produced());
+    slassert(data == out);
+}
+
+void test_memlimit() {
+    auto data = make_data(1000);
+    auto compressed = sl::compress::lzma_encode_buffer({data.data(), data.length()});
+    auto dec = sl::compress::lzma_decoder(1024);
+    bool thrown = false;
+    try {
+        dec.feed({compressed.data(), compressed.length()}, [](sl::io::span<const char>) {});
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+int main() {
+    try {
+        test_feed();
+        test_memlimit();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lzma_encode_source_test.cpp
+ * Author: alex
+ *
+ * Created on October 21, 2026, 5:10 PM
+ */
+
+#include "staticlib/compress/lzma_encode_source.hpp"
+
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/tinydir.hpp"
+
+#include "staticlib/compress/lzma_source.hpp"
+
+std::string read_file(const std::string& path) {
+    auto fd = sl::tinydir::file_source(path);
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(fd, sink);
+    return sink.get_string();
+}
+
+void test_encode() {
+    auto expected = read_file("../test/data/hello.txt.xz");
+    auto src = sl::compress::make_lzma_encode_source(sl::tinydir::file_source("../test/data/hello.txt"));
+    auto ss = sl::io::string_sink();
+    sl::io::copy_all(src, ss);
+    slassert(expected == ss.get_string());
+}
+
+void test_filter_chain() {
+    auto data = std::string();
+    for (size_t i = 0; i < 100000; i++) {
+        data.push_back(static_cast<char>(i % 251));
+    }
+    auto chain = sl::compress::lzma_filter_chain(1);
+    chain.add_delta(1);
+    auto decoder = sl::compress::make_lzma_source(sl::compress::make_lzma_encode_source(
+            sl::io::array_source(data.data(), data.length()), chain));
+    auto ss = sl::io::string_sink();
+    sl::io::copy_all(decoder, ss);
+    slassert(data == ss.get_string());
+}
+
+int main() {
+    try {
+        test_encode();
+        test_filter_chain();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
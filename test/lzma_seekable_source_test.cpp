@@ -0,0 +1,153 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   lzma_seekable_source_test.cpp
+ * Author: alex
+ *
+ * Created on October 20, 2026, 11:30 AM
+ */
+
+#include "staticlib/compress/lzma_seekable_source.hpp"
+
+#include <array>
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/tinydir.hpp"
+
+#include "staticlib/compress/lzma_buffer.hpp"
+
+std::string make_data(size_t len, size_t seed) {
+    auto res = std::string();
+    for (size_t i = 0; i < len; i++) {
+        res.push_back(static_cast<char>('a' + (i * i + seed) % 23));
+    }
+    return res;
+}
+
+void test_single_block() {
+    auto src = sl::compress::make_lzma_seekable_source(sl::tinydir::file_source("../test/data/hello.txt.xz"));
+    slassert(5 == src.size());
+    slassert(1 == src.blocks_count());
+    auto buf = std::array<char, 3>();
+    slassert(3 == src.read_at(2, {buf.data(), buf.size()}));
+    slassert("llo" == std::string(buf.data(), buf.size()));
+    slassert(2 == src.read_at(3, {buf.data(), buf.size()}));
+    slassert("lo" == std::string(buf.data(), 2));
+    slassert(0 == src.read_at(5, {buf.data(), buf.size()}));
+}
+
+void test_concatenated() {
+    // three streams, one block each, with stream padding
+    auto data = std::string();
+    {
+        auto sink = sl::tinydir::file_sink("test_seekable.xz");
+        for (size_t i = 0; i < 3; i++) {
+            auto part = make_data(10000 + i * 5000, i);
+            auto compressed = sl::compress::lzma_encode_buffer({part.data(), part.length()}, 1);
+            sink.write({compressed.data(), compressed.length()});
+            sink.write({"\0\0\0\0", 4});
+            data += part;
+        }
+    }
+    auto fd = sl::tinydir::file_source("test_seekable.xz");
+    auto src = sl::compress::make_lzma_seekable_source(fd, 2);
+    slassert(data.length() == src.size());
+    slassert(3 == src.blocks_count());
+
+    // reads across block boundaries, backwards
+    auto buf = std::array<char, 100>();
+    for (uint64_t offset : {29950u, 9950u, 24990u, 0u, 14999u}) {
+        size_t len = src.read_at(offset, {buf.data(), buf.size()});
+        slassert(std::min(static_cast<size_t>(100), data.length() - static_cast<size_t>(offset)) == len);
+        slassert(data.substr(static_cast<size_t>(offset), len) == std::string(buf.data(), len));
+    }
+
+    // sequential read from the middle
+    src.seek(-20000, 'e');
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(src, sink);
+    slassert(data.substr(data.length() - 20000) == sink.get_string());
+}
+
+void test_window() {
+    // single large block, decoded in small windows
+    auto data = make_data(300000, 42);
+    auto compressed = sl::compress::lzma_encode_buffer({data.data(), data.length()}, 1);
+    {
+        auto sink = sl::tinydir::file_sink("test_seekable.xz");
+        sink.write({compressed.data(), compressed.length()});
+    }
+    auto fd = sl::tinydir::file_source("test_seekable.xz");
+    auto src = sl::compress::make_lzma_seekable_source(fd, 2, 4096);
+    slassert(1 == src.blocks_count());
+    auto buf = std::array<char, 10000>();
+    for (uint64_t offset : {250000u, 4090u, 299999u, 0u, 100000u, 100010u}) {
+        size_t len = src.read_at(offset, {buf.data(), buf.size()});
+        slassert(std::min(buf.size(), data.length() - static_cast<size_t>(offset)) == len);
+        slassert(data.substr(static_cast<size_t>(offset), len) == std::string(buf.data(), len));
+    }
+    src.seek(12345);
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(src, sink);
+    slassert(data.substr(12345) == sink.get_string());
+}
+
+void test_memory_limit() {
+    auto data = make_data(1000, 42);
+    auto compressed = sl::compress::lzma_encode_buffer({data.data(), data.length()}, 6);
+    {
+        auto sink = sl::tinydir::file_sink("test_seekable.xz");
+        sink.write({compressed.data(), compressed.length()});
+    }
+    auto fd = sl::tinydir::file_source("test_seekable.xz");
+    auto src = sl::compress::make_lzma_seekable_source(fd, 4, 4096, 1 << 20);
+    auto buf = std::array<char, 10>();
+    bool thrown = false;
+    try {
+        src.read_at(0, {buf.data(), buf.size()});
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+void test_invalid() {
+    bool thrown = false;
+    try {
+        auto src = sl::compress::make_lzma_seekable_source(sl::tinydir::file_source("../test/data/hello.txt"));
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+int main() {
+    try {
+        test_single_block();
+        test_concatenated();
+        test_window();
+        test_memory_limit();
+        test_invalid();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -30,6 +30,8 @@
 #include "staticlib/io.hpp"
 #include "staticlib/tinydir.hpp"
 
+#include "staticlib/compress/lzma_source.hpp"
+
 void test_lzma() {
     auto fd_comp = sl::tinydir::file_source("../test/data/hello.txt.xz");
     auto ss_comp = sl::io::string_sink();
@@ -45,6 +47,63 @@ void test_lzma() {
     slassert(ss_comp.get_string() == ss.get_string());
 }
 
+std::string compress_with(const std::string& data, const sl::compress::lzma_filter_chain& chain) {
+    auto ss = sl::io::string_sink();
+    {
+        auto coder = sl::compress::make_lzma_sink(ss, chain);
+        sl::io::write_all(coder, {data.data(), data.length()});
+    }
+    return ss.get_string();
+}
+
+std::string decompress(const std::string& compressed) {
+    auto src = sl::compress::make_lzma_source(sl::io::array_source(compressed.data(), compressed.length()));
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(src, sink);
+    return sink.get_string();
+}
+
+void test_filter_chain() {
+    // fixed-width records with slowly changing values
+    auto table = std::string();
+    for (uint32_t i = 0; i < 20000; i++) {
+        uint32_t val = 1000000 + i * 37 + (i % 5);
+        table.append(reinterpret_cast<const char*>(std::addressof(val)), 4);
+        uint32_t ts = 1700000000 + i * 60;
+        table.append(reinterpret_cast<const char*>(std::addressof(ts)), 4);
+    }
+    auto plain = compress_with(table, sl::compress::lzma_filter_chain());
+    auto delta = compress_with(table, sl::compress::lzma_filter_chain().add_delta(8));
+    slassert(delta.length() < plain.length());
+    slassert(table == decompress(plain));
+    slassert(table == decompress(delta));
+
+    auto chain = sl::compress::lzma_filter_chain(1);
+    chain.add_x86()
+            .set_dict_size(1 << 16)
+            .set_nice_len(64)
+            .set_mode(sl::compress::lzma2_mode::fast)
+            .set_match_finder(sl::compress::lzma2_match_finder::hc4);
+    slassert(table == decompress(compress_with(table, chain)));
+}
+
+void test_filter_chain_invalid() {
+    bool thrown = false;
+    try {
+        sl::compress::lzma_filter_chain().add_delta(0);
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+    thrown = false;
+    try {
+        sl::compress::lzma_filter_chain().add_x86().add_delta(4).add_x86().add_delta(4);
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
 void test_huge() {
     auto fd_in = sl::tinydir::file_source("/home/alex/ebook/maugham/bondage.txt");
     auto coder = sl::compress::make_lzma_sink(sl::tinydir::file_sink("bondage.txt.xz"));
@@ -54,6 +113,8 @@ void test_huge() {
 int main() {
     try {
         test_lzma();
+        test_filter_chain();
+        test_filter_chain_invalid();
 //        test_huge();
     } catch (const std::exception& e) {
         std::cout << e.what() << std::endl;
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   parallel_inflate_source_test.cpp
+ * Author: alex
+ *
+ * Created on October 23, 2026, 5:30 PM
+ */
+
+#include "staticlib/compress/parallel_inflate_source.hpp"
+
+#include <array>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/deflate_buffer.hpp"
+#include "staticlib/compress/deflate_sink.hpp"
+
+std::string make_text(size_t len) {
+    auto res = std::string();
+    std::mt19937 rng(42);
+    const char* words[] = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta"};
+    while (res.length() < len) {
+        res += words[rng() % 8];
+        res += 0 == rng() % 10 ? "\n" : " ";
+        if (0 == rng() % 50) {
+            res += sl::support::to_string(rng());
+        }
+    }
+    res.resize(len);
+    return res;
+}
+
+std::string decompress(const std::string& compressed, size_t threads, size_t chunk_size, size_t& sequential_from) {
+    auto src = sl::compress::parallel_inflate_source<sl::io::array_source>(
+            sl::io::array_source(compressed.data(), compressed.length()), threads, chunk_size);
+    auto res = std::string();
+    auto buf = std::array<char, 10000>();
+    sequential_from = std::string::npos;
+    for (;;) {
+        std::streamsize len = src.read({buf.data(), buf.size()});
+        if (std::char_traits<char>::eof() == len) break;
+        if (std::string::npos == sequential_from && src.is_sequential()) {
+            sequential_from = res.length();
+        }
+        res.append(buf.data(), static_cast<size_t>(len));
+    }
+    return res;
+}
+
+void test_parallel() {
+    auto data = make_text(4 << 20);
+    for (int level : {1, 6, 9}) {
+        auto compressed = sl::compress::deflate_buffer({data.data(), data.length()}, level);
+        size_t sequential_from = 0;
+        auto res = decompress(compressed, 4, 1 << 16, sequential_from);
+        slassert(data == res);
+        // only the tail, that is smaller than 2 chunks, is decoded sequentially
+        slassert(sequential_from > data.length() / 2);
+    }
+}
+
+void test_stream_compressed() {
+    auto data = make_text(3 << 20);
+    auto dest = sl::io::string_sink();
+    {
+        auto sink = sl::compress::make_deflate_sink(dest);
+        for (size_t pos = 0; pos < data.length(); pos += 7777) {
+            sink.write({data.data() + pos, std::min(static_cast<size_t>(7777), data.length() - pos)});
+        }
+    }
+    auto& compressed = dest.get_string();
+    size_t sequential_from = 0;
+    slassert(data == decompress(compressed, 3, 1 << 16, sequential_from));
+    slassert(sequential_from > data.length() / 2);
+}
+
+void test_fallback() {
+    // incompressible data is stored, there are no boundaries to speculate on
+    auto data = std::string();
+    std::mt19937 rng(1);
+    for (size_t i = 0; i < (1 << 20); i++) {
+        data.push_back(static_cast<char>(rng()));
+    }
+    data += make_text(1 << 20);
+    auto compressed = sl::compress::deflate_buffer({data.data(), data.length()});
+    size_t sequential_from = 0;
+    slassert(data == decompress(compressed, 4, 1 << 16, sequential_from));
+    slassert(sequential_from < data.length() / 2);
+}
+
+void test_small() {
+    auto data = std::string("hello parallel inflate");
+    auto compressed = sl::compress::deflate_buffer({data.data(), data.length()});
+    size_t sequential_from = 0;
+    slassert(data == decompress(compressed, 4, 1 << 16, sequential_from));
+    slassert(0 == sequential_from);
+    auto empty = sl::compress::deflate_buffer({"", 0});
+    slassert(decompress(empty, 4, 1 << 16, sequential_from).empty());
+}
+
+void test_truncated() {
+    auto data = make_text(1 << 20);
+    auto compressed = sl::compress::deflate_buffer({data.data(), data.length()});
+    compressed.resize(compressed.length() / 2);
+    bool thrown = false;
+    try {
+        size_t sequential_from = 0;
+        decompress(compressed, 4, 1 << 16, sequential_from);
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+int main() {
+    try {
+        test_parallel();
+        test_stream_compressed();
+        test_fallback();
+        test_small();
+        test_truncated();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   rsyncable_chunker_test.cpp
+ * Author: alex
+ *
+ * Created on October 26, 2026, 12:15 PM
+ */
+
+#include "staticlib/compress/rsyncable_chunker.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/compress_exception.hpp"
+
+std::string make_data(size_t len) {
+    auto res = std::string();
+    uint32_t state = 42;
+    while (res.length() < len) {
+        state = state * 1103515245 + 12345;
+        res.push_back(static_cast<char>('a' + (state >> 16) % 26));
+    }
+    return res;
+}
+
+std::vector<size_t> boundaries(const std::string& data, size_t write_size) {
+    auto chunker = sl::compress::rsyncable_chunker();
+    auto res = std::vector<size_t>();
+    size_t chunk_start = 0;
+    for (size_t pos = 0; pos < data.length(); pos += write_size) {
+        size_t len = std::min(write_size, data.length() - pos);
+        size_t off = 0;
+        while (off < len) {
+            size_t found = chunker.next_boundary({data.data() + pos + off, len - off});
+            if (0 == found) break;
+            off += found;
+            chunk_start = pos + off;
+            res.push_back(chunk_start);
+        }
+    }
+    return res;
+}
+
+void test_boundaries() {
+    auto data = make_data(1 << 20);
+    auto whole = boundaries(data, data.length());
+    // average is 8KB + 1KB
+    slassert(whole.size() > 50);
+    slassert(whole.size() < 250);
+    size_t prev = 0;
+    for (size_t b : whole) {
+        slassert(b - prev >= 1024);
+        prev = b;
+    }
+    // do not depend on the write sizes
+    slassert(whole == boundaries(data, 1000));
+    slassert(whole == boundaries(data, 1));
+}
+
+void test_resync() {
+    auto data = make_data(1 << 20);
+    auto edited = data;
+    edited.insert(1000, "inserted text");
+    auto orig = boundaries(data, data.length());
+    auto changed = boundaries(edited, edited.length());
+    // all the boundaries after the edit are at the same content positions
+    size_t common = 0;
+    for (size_t b : changed) {
+        for (size_t o : orig) {
+            if (o + 13 == b) {
+                common += 1;
+            }
+        }
+    }
+    slassert(common + 1 >= orig.size());
+}
+
+void test_invalid() {
+    for (int bits : {-1, 7, 21, 30, 40}) {
+        bool thrown = false;
+        try {
+            auto chunker = sl::compress::rsyncable_chunker(bits);
+            (void) chunker;
+        } catch (const sl::compress::compress_exception&) {
+            thrown = true;
+        }
+        slassert(thrown);
+    }
+    auto chunker = sl::compress::rsyncable_chunker(12, 512, true);
+    slassert(4096 + 512 == chunker.get_average_size());
+    slassert(chunker.is_full_flush());
+}
+
+int main() {
+    try {
+        test_boundaries();
+        test_resync();
+        test_invalid();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
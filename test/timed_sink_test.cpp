@@ -0,0 +1,120 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   timed_sink_test.cpp
+ * Author: alex
+ *
+ * Created on October 25, 2026, 1:40 PM
+ */
+
+#include "staticlib/compress/timed_sink.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/deflate_sink.hpp"
+#include "staticlib/compress/inflate_source.hpp"
+
+class slow_sink {
+    std::string& data;
+
+public:
+    slow_sink(std::string& data) :
+    data(data) { }
+
+    std::streamsize write(sl::io::span<const char> span) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        data.append(span.data(), span.size());
+        return span.size_signed();
+    }
+
+    std::streamsize flush() {
+        return 0;
+    }
+};
+
+std::string make_data(size_t len) {
+    auto res = std::string();
+    for (size_t i = 0; res.length() < len; i++) {
+        res += "line " + sl::support::to_string(i * 7919 % 10007) + "\n";
+    }
+    return res;
+}
+
+void test_deflate() {
+    namespace sc = sl::compress;
+    auto rec = sc::latency_recorder();
+    auto compressed = std::string();
+    auto data = make_data(1 << 20);
+    {
+        auto sink = sc::make_timed_sink(sc::make_deflate_sink(
+                sc::make_timed_sink(slow_sink(compressed), rec, sc::latency_role::io)),
+                rec, sc::latency_role::codec);
+        for (size_t i = 0; i < data.length(); i += 4096) {
+            sink.write({data.data() + i, std::min(data.length() - i, static_cast<size_t>(4096))});
+        }
+        sink.flush();
+    }
+    auto& write_codec = rec.get_codec(sc::latency_op::write);
+    auto& write_io = rec.get_io(sc::latency_op::write);
+    slassert((data.length() + 4095) / 4096 == write_codec.get_count());
+    // only some of the writes reach the destination
+    slassert(write_io.get_count() > 0);
+    slassert(write_io.get_count() < write_codec.get_count());
+    // sleep in destination is not counted as codec time
+    slassert(write_io.get_percentile(50) >= 2000000);
+    slassert(write_codec.get_percentile(50) < 2000000);
+    slassert(1 == rec.get_codec(sc::latency_op::flush).get_count());
+    // compressor writes the stream end on destruction
+    slassert(1 == rec.get_codec(sc::latency_op::finalize).get_count());
+    slassert(1 == rec.get_io(sc::latency_op::finalize).get_count());
+    auto src = sc::make_inflate_source(sl::io::array_source(compressed.data(), compressed.length()));
+    auto out = sl::io::string_sink();
+    sl::io::copy_all(src, out);
+    slassert(data == out.get_string());
+}
+
+void test_reference() {
+    namespace sc = sl::compress;
+    auto rec = sc::latency_recorder();
+    auto dest = sl::io::string_sink();
+    {
+        auto sink = sc::make_timed_sink(dest, rec, sc::latency_role::codec);
+        sink.write({"hello", 5});
+    }
+    slassert("hello" == dest.get_string());
+    slassert(1 == rec.get_codec(sc::latency_op::write).get_count());
+    slassert(0 == rec.get_io(sc::latency_op::write).get_count());
+}
+
+int main() {
+    try {
+        test_deflate();
+        test_reference();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
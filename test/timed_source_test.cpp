@@ -0,0 +1,97 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   timed_source_test.cpp
+ * Author: alex
+ *
+ * Created on October 25, 2026, 2:05 PM
+ */
+
+#include "staticlib/compress/timed_source.hpp"
+
+#include <array>
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+
+#include "staticlib/compress/deflate_buffer.hpp"
+#include "staticlib/compress/inflate_source.hpp"
+
+std::string make_data(size_t len) {
+    auto res = std::string();
+    for (size_t i = 0; res.length() < len; i++) {
+        res += "line " + sl::support::to_string(i * 7919 % 10007) + "\n";
+    }
+    return res;
+}
+
+void test_inflate() {
+    namespace sc = sl::compress;
+    auto rec = sc::latency_recorder();
+    auto data = make_data(1 << 18);
+    auto compressed = sc::deflate_buffer({data.data(), data.length()});
+    auto out = sl::io::string_sink();
+    {
+        auto src = sc::make_timed_source(sc::make_inflate_source(
+                sc::make_timed_source(sl::io::array_source(compressed.data(), compressed.length()),
+                        rec, sc::latency_role::io)),
+                rec, sc::latency_role::codec);
+        auto buf = std::array<char, 1024>();
+        for (;;) {
+            auto read = src.read({buf.data(), buf.size()});
+            if (std::char_traits<char>::eof() == read) break;
+            sl::io::write_all(out, {buf.data(), static_cast<size_t>(read)});
+        }
+    }
+    slassert(data == out.get_string());
+    auto& read_codec = rec.get_codec(sc::latency_op::read);
+    auto& read_io = rec.get_io(sc::latency_op::read);
+    // every read returns at most 1024 bytes, plus EOF
+    slassert(read_codec.get_count() > data.length() / 1024);
+    slassert(read_io.get_count() > 0);
+    slassert(read_io.get_count() < read_codec.get_count());
+    slassert(1 == rec.get_codec(sc::latency_op::finalize).get_count());
+}
+
+void test_reference() {
+    namespace sc = sl::compress;
+    auto rec = sc::latency_recorder();
+    auto data = std::string("hello");
+    auto arr = sl::io::array_source(data.data(), data.length());
+    {
+        auto src = sc::make_timed_source(arr, rec, sc::latency_role::codec);
+        auto out = sl::io::string_sink();
+        sl::io::copy_all(src, out);
+        slassert(data == out.get_string());
+    }
+    slassert(rec.get_codec(sc::latency_op::read).get_count() >= 2);
+}
+
+int main() {
+    try {
+        test_inflate();
+        test_reference();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * File:   zip_entry_cache_test.cpp
+ * Author: alex
+ *
+ * Created on October 28, 2026, 11:20 AM
+ */
+
+#include "staticlib/compress/zip_entry_cache.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+
+#include "staticlib/compress/zip_sink.hpp"
+
+std::string make_contents(size_t idx) {
+    auto res = std::string();
+    for (size_t i = 0; i < 100 + idx * 10; i++) {
+        res += "entry_" + sl::support::to_string(idx) + "_line_" + sl::support::to_string(i) + "\n";
+    }
+    return res;
+}
+
+std::vector<sl::compress::zip_entry> write_archive(const std::string& path, size_t count) {
+    {
+        auto sink = sl::compress::make_zip_sink(sl::tinydir::file_sink(path));
+        for (size_t i = 0; i < count; i++) {
+            sink.get_sink().add_entry("file_" + sl::support::to_string(i) + ".txt");
+            auto contents = make_contents(i);
+            sink.write({contents.data(), contents.length()});
+        }
+    }
+    auto src = sl::tinydir::file_source(path);
+    return sl::compress::read_zip_central_directory(src);
+}
+
+void test_hit_miss() {
+    auto entries = write_archive("test_cache.zip", 10);
+    auto cache = sl::compress::zip_entry_cache(1 << 20, 4);
+    auto src = sl::tinydir::file_source("test_cache.zip");
+    for (size_t i = 0; i < entries.size(); i++) {
+        auto data = cache.read_entry(src, "test_cache.zip", entries[i]);
+        slassert(make_contents(i) == *data);
+    }
+    slassert(0 == cache.get_hits());
+    slassert(10 == cache.get_misses());
+    slassert(10 == cache.get_count());
+    auto first = cache.read_entry(src, "test_cache.zip", entries[0]);
+    slassert(make_contents(0) == *first);
+    slassert(1 == cache.get_hits());
+    // same offset in other archive is a different entry
+    slassert(nullptr == cache.get("other.zip", entries[0]).get());
+    slassert(11 == cache.get_misses());
+    cache.clear();
+    slassert(0 == cache.get_count());
+    slassert(0 == cache.get_size_bytes());
+    // evicted data stays valid
+    slassert(make_contents(0) == *first);
+}
+
+void test_eviction() {
+    auto entries = write_archive("test_cache.zip", 10);
+    auto src = sl::tinydir::file_source("test_cache.zip");
+    // single shard fits about 3 entries
+    auto cache = sl::compress::zip_entry_cache(3 * (make_contents(9).length() + 200), 1);
+    for (size_t i = 0; i < entries.size(); i++) {
+        cache.read_entry(src, "test_cache.zip", entries[i]);
+        slassert(cache.get_size_bytes() <= cache.get_max_bytes());
+    }
+    slassert(3 == cache.get_count());
+    // least recently used are evicted
+    slassert(nullptr == cache.get("test_cache.zip", entries[0]).get());
+    slassert(nullptr != cache.get("test_cache.zip", entries[9]).get());
+    slassert(nullptr != cache.get("test_cache.zip", entries[7]).get());
+    cache.read_entry(src, "test_cache.zip", entries[0]);
+    slassert(nullptr == cache.get("test_cache.zip", entries[8]).get());
+    slassert(nullptr != cache.get("test_cache.zip", entries[7]).get());
+
+    // too large for cache
+    auto tiny = sl::compress::zip_entry_cache(100, 1);
+    auto data = tiny.read_entry(src, "test_cache.zip", entries[0]);
+    slassert(make_contents(0) == *data);
+    slassert(0 == tiny.get_count());
+}
+
+void test_concurrent() {
+    auto entries = write_archive("test_cache.zip", 20);
+    auto cache = sl::compress::zip_entry_cache(1 << 20);
+    std::atomic<bool> failed(false);
+    auto threads = std::vector<std::thread>();
+    for (size_t t = 0; t < 4; t++) {
+        threads.emplace_back([&entries, &cache, &failed, t] {
+            try {
+                auto src = sl::tinydir::file_source("test_cache.zip");
+                for (size_t i = 0; i < 200; i++) {
+                    size_t idx = (i * 7 + t) % entries.size();
+                    auto data = cache.read_entry(src, "test_cache.zip", entries[idx]);
+                    if (make_contents(idx) != *data) {
+                        failed = true;
+                    }
+                }
+            } catch (const std::exception&) {
+                failed = true;
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    slassert(!failed);
+    slassert(800 == cache.get_hits() + cache.get_misses());
+    slassert(cache.get_hits() >= 800 - 4 * entries.size());
+    slassert(entries.size() == cache.get_count());
+}
+
+int main() {
+    try {
+        test_hit_miss();
+        test_eviction();
+        test_concurrent();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
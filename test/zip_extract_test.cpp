@@ -0,0 +1,135 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zip_extract_test.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 12:40 PM
+ */
+
+#include "staticlib/compress/zip_extract.hpp"
+
+#include <array>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
+#include "staticlib/tinydir.hpp"
+
+#include "staticlib/compress/zip_sink.hpp"
+
+void test_extract() {
+    auto expected = std::map<std::string, std::string>();
+    {
+        auto sink = sl::compress::make_zip_sink(sl::tinydir::file_sink("test_extract.zip"));
+        for (size_t i = 0; i < 20; i++) {
+            auto name = "entry_" + sl::support::to_string(i) + ".txt";
+            auto data = std::string();
+            for (size_t j = 0; j < i * 1000; j++) {
+                data.push_back(static_cast<char>('a' + (j * i) % 26));
+            }
+            sink.get_sink().add_entry(name);
+            sl::io::write_all(sink, {data.data(), data.length()});
+            expected[name] = data;
+        }
+    }
+    // sinks are created upfront, so the map is not modified by workers
+    auto actual = std::map<std::string, sl::io::string_sink>();
+    for (auto& pa : expected) {
+        actual[pa.first] = sl::io::string_sink();
+    }
+    size_t count = sl::compress::extract_all([] {
+        return sl::tinydir::file_source("test_extract.zip");
+    }, [&actual](const sl::compress::zip_entry& en) {
+        return sl::io::make_reference_sink(actual.at(en.get_name()));
+    }, 4);
+    slassert(20 == count);
+    for (auto& pa : expected) {
+        slassert(pa.second == actual.at(pa.first).get_string());
+    }
+}
+
+std::string read_file(const std::string& path) {
+    auto src = sl::tinydir::file_source(path);
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(src, sink);
+    return sink.get_string();
+}
+
+void test_extract_dir() {
+    {
+        auto sink = sl::compress::make_zip_sink(sl::tinydir::file_sink("test_extract_dir.zip"));
+        sink.get_sink().add_entry("foo.txt");
+        sl::io::write_all(sink, {"foo", 3});
+        sink.get_sink().add_entry("empty/");
+        sink.get_sink().add_entry("bar/./baz/baz.txt");
+        sl::io::write_all(sink, {"baz", 3});
+    }
+    size_t count = sl::compress::extract_all([] {
+        return sl::tinydir::file_source("test_extract_dir.zip");
+    }, "test_extract_dir", 2);
+    slassert(3 == count);
+    slassert("foo" == read_file("test_extract_dir/foo.txt"));
+    slassert("baz" == read_file("test_extract_dir/bar/baz/baz.txt"));
+    // directory entry is created
+    auto empty = sl::tinydir::file_sink("test_extract_dir/empty/check.txt");
+    (void) empty;
+}
+
+void test_extract_zip_slip() {
+    for (auto name : {"../evil.txt", "foo/../../evil.txt", "/tmp/evil.txt", "\\evil.txt", "C:/evil.txt", "foo\\..\\..\\evil.txt"}) {
+        {
+            auto sink = sl::compress::make_zip_sink(sl::tinydir::file_sink("test_extract_slip.zip"));
+            sink.get_sink().add_entry("good.txt");
+            sl::io::write_all(sink, {"good", 4});
+            sink.get_sink().add_entry(name);
+            sl::io::write_all(sink, {"evil", 4});
+        }
+        bool caught = false;
+        try {
+            sl::compress::extract_all([] {
+                return sl::tinydir::file_source("test_extract_slip.zip");
+            }, "test_extract_slip", 2);
+        } catch (const sl::compress::compress_exception&) {
+            caught = true;
+        }
+        slassert(caught);
+    }
+    // nothing is extracted when any of the names is rejected
+    bool exists = true;
+    try {
+        sl::tinydir::file_source("test_extract_slip/good.txt");
+    } catch (const std::exception&) {
+        exists = false;
+    }
+    slassert(!exists);
+}
+
+int main() {
+    try {
+        test_extract();
+        test_extract_dir();
+        test_extract_zip_slip();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
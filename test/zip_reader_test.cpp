@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zip_reader_test.cpp
+ * Author: alex
+ *
+ * Created on October 18, 2026, 11:30 AM
+ */
+
+#include "staticlib/compress/zip_reader.hpp"
+
+#include <array>
+#include <iostream>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+#include "staticlib/tinydir.hpp"
+
+#include "staticlib/compress/zip_sink.hpp"
+
+void test_read() {
+    {
+        auto sink = sl::compress::make_zip_sink(sl::tinydir::file_sink("test_reader.zip"));
+        sink.get_sink().add_entry("foo.txt");
+        sink.write({"hello", 5});
+        sink.get_sink().add_entry("bar/baz.txt");
+        sink.write({"bye", 3});
+    }
+    auto src = sl::tinydir::file_source("test_reader.zip");
+    auto entries = sl::compress::read_zip_central_directory(src);
+    slassert(2 == entries.size());
+    slassert("foo.txt" == entries[0].get_name());
+    slassert(sl::compress::zip_compression_method::deflate == entries[0].get_method());
+    slassert(5 == entries[0].get_uncompressed_size());
+    slassert("bar/baz.txt" == entries[1].get_name());
+    slassert(3 == entries[1].get_uncompressed_size());
+
+    auto foo = sl::compress::make_zip_entry_source(src, entries[0]);
+    auto foo_sink = sl::io::string_sink();
+    sl::io::copy_all(foo, foo_sink);
+    slassert("hello" == foo_sink.get_string());
+
+    auto baz = sl::compress::make_zip_entry_source(src, entries[1]);
+    auto baz_sink = sl::io::string_sink();
+    sl::io::copy_all(baz, baz_sink);
+    slassert("bye" == baz_sink.get_string());
+}
+
+void test_crc_mismatch() {
+    auto src = sl::tinydir::file_source("test_reader.zip");
+    auto entries = sl::compress::read_zip_central_directory(src);
+    auto en = entries[0];
+    auto broken = sl::compress::zip_entry(en.get_name(), en.get_method(), en.get_flags(), en.get_crc() + 1,
+            en.get_compressed_size(), en.get_uncompressed_size(), en.get_offset());
+    auto foo = sl::compress::make_zip_entry_source(src, broken);
+    auto foo_sink = sl::io::string_sink();
+    bool thrown = false;
+    try {
+        sl::io::copy_all(foo, foo_sink);
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+int main() {
+    try {
+        test_read();
+        test_crc_mismatch();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
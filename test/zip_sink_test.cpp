@@ -23,13 +23,66 @@
 
 #include "staticlib/compress/zip_sink.hpp"
 
+#include <cstdint>
+#include <algorithm>
 #include <array>
+#include <cstring>
 #include <iostream>
+#include <string>
 
 #include "staticlib/config/assert.hpp"
 #include "staticlib/io.hpp"
+#include "staticlib/support.hpp"
 #include "staticlib/tinydir.hpp"
 
+#include "staticlib/compress/zip_reader.hpp"
+
+class seekable_string {
+    std::string& data;
+    size_t pos = 0;
+
+public:
+    seekable_string(std::string& data) :
+    data(data) { }
+
+    std::streamsize read(sl::io::span<char> span) {
+        if (pos >= data.length()) return std::char_traits<char>::eof();
+        size_t len = std::min(span.size(), data.length() - pos);
+        std::memcpy(span.data(), data.data() + pos, len);
+        pos += len;
+        return static_cast<std::streamsize>(len);
+    }
+
+    std::streamsize write(sl::io::span<const char> span) {
+        if (pos + span.size() > data.length()) {
+            data.resize(pos + span.size());
+        }
+        std::memcpy(&data[pos], span.data(), span.size());
+        pos += span.size();
+        return span.size_signed();
+    }
+
+    std::streamsize flush() {
+        return 0;
+    }
+
+    std::streampos seek(std::streamsize offset, char whence = 'b') {
+        switch (whence) {
+        case 'c': pos += offset; break;
+        case 'e': pos = data.length() + offset; break;
+        default: pos = offset;
+        }
+        return static_cast<std::streampos>(pos);
+    }
+};
+
+std::string read_entry(std::string& archive, const sl::compress::zip_entry& en) {
+    auto src = sl::compress::make_zip_entry_source(seekable_string(archive), en);
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(src, sink);
+    return sink.get_string();
+}
+
 void test_store() {
     auto sink = sl::compress::make_zip_sink(sl::tinydir::file_sink("test.zip"));
     sink.get_sink().add_entry("foo.txt");
@@ -38,9 +91,297 @@ void test_store() {
     sink.write({"bye", 3});
 }
 
+void test_append() {
+    auto archive = std::string();
+    {
+        auto sink = sl::compress::make_zip_sink(seekable_string(archive));
+        sink.get_sink().add_entry("foo.txt");
+        sink.write({"hello", 5});
+        sink.get_sink().add_entry("bar/baz.txt");
+        sink.write({"bye", 3});
+    }
+    size_t initial_len = archive.length();
+    {
+        auto src = seekable_string(archive);
+        auto sink = sl::compress::make_zip_append_sink(seekable_string(archive), src);
+        sink.get_sink().add_entry("appended.txt");
+        sink.write({"again", 5});
+    }
+    slassert(archive.length() > initial_len);
+    auto src = seekable_string(archive);
+    auto entries = sl::compress::read_zip_central_directory(src);
+    slassert(3 == entries.size());
+    slassert("foo.txt" == entries[0].get_name());
+    slassert("bar/baz.txt" == entries[1].get_name());
+    slassert("appended.txt" == entries[2].get_name());
+    slassert("hello" == read_entry(archive, entries[0]));
+    slassert("bye" == read_entry(archive, entries[1]));
+    slassert("again" == read_entry(archive, entries[2]));
+}
+
+void test_raw_copy() {
+    auto source_archive = std::string();
+    {
+        auto sink = sl::compress::make_zip_sink(seekable_string(source_archive));
+        sink.get_sink().add_entry("foo.txt");
+        sink.write({"hello", 5});
+        sink.get_sink().add_entry("bar/baz.txt");
+        sink.write({"bye", 3});
+    }
+    auto src = seekable_string(source_archive);
+    auto entries = sl::compress::read_zip_central_directory(src);
+    auto archive = std::string();
+    {
+        auto sink = sl::compress::make_zip_sink(seekable_string(archive));
+        sink.get_sink().add_entry("first.txt");
+        sink.write({"first", 5});
+        sink.get_sink().add_raw_entry("renamed/foo.txt", src, entries[0]);
+        sink.get_sink().add_raw_entry("copied_baz.txt", src, entries[1]);
+        sink.get_sink().add_entry("last.txt");
+        sink.write({"last", 4});
+    }
+    auto archive_src = seekable_string(archive);
+    auto copied = sl::compress::read_zip_central_directory(archive_src);
+    slassert(4 == copied.size());
+    slassert("renamed/foo.txt" == copied[1].get_name());
+    slassert(entries[0].get_crc() == copied[1].get_crc());
+    slassert(entries[0].get_compressed_size() == copied[1].get_compressed_size());
+    slassert("first" == read_entry(archive, copied[0]));
+    slassert("hello" == read_entry(archive, copied[1]));
+    slassert("bye" == read_entry(archive, copied[2]));
+    slassert("last" == read_entry(archive, copied[3]));
+}
+
+void test_precompressed() {
+    auto data = std::string("precompressed payload, precompressed payload");
+    auto deflated = sl::io::string_sink();
+    {
+        auto deflater = sl::compress::make_deflate_sink(deflated);
+        sl::io::write_all(deflater, {data.data(), data.length()});
+    }
+    auto archive = std::string();
+    {
+        auto sink = sl::compress::make_zip_sink(seekable_string(archive));
+        sink.get_sink().add_entry("first.txt");
+        sink.write({"first", 5});
+        auto deflated_src1 = sl::io::string_source(deflated.get_string());
+        auto uncompressed = sl::io::string_source(data);
+        sink.get_sink().add_deflated_entry("computed.txt", deflated_src1, uncompressed);
+        auto deflated_src2 = sl::io::string_source(deflated.get_string());
+        uint32_t crc = sl::compress::detail::zlib_crc32(0, data.data(), data.length());
+        sink.get_sink().add_deflated_entry("known.txt", deflated_src2, crc, static_cast<uint32_t>(data.length()));
+    }
+    auto archive_src = seekable_string(archive);
+    auto entries = sl::compress::read_zip_central_directory(archive_src);
+    slassert(3 == entries.size());
+    slassert(deflated.get_string().length() == entries[1].get_compressed_size());
+    slassert("first" == read_entry(archive, entries[0]));
+    slassert(data == read_entry(archive, entries[1]));
+    slassert(data == read_entry(archive, entries[2]));
+}
+
+void test_in_memory() {
+    auto archive = std::string();
+    auto large = std::string();
+    for (size_t i = 0; large.length() <= (1 << 22); i++) {
+        large += "large entry line " + sl::support::to_string(i) + "\n";
+    }
+    {
+        auto sink = sl::compress::make_zip_sink(seekable_string(archive));
+        sink.get_sink().add_entry("small.txt", {"hello in-memory", 15});
+        sink.get_sink().add_entry("empty.txt", {"", 0});
+        sink.get_sink().add_entry("large.txt", {large.data(), large.length()});
+        sink.get_sink().add_entry("streamed.txt");
+        sink.write({"bye", 3});
+    }
+    auto src = seekable_string(archive);
+    auto entries = sl::compress::read_zip_central_directory(src);
+    slassert(4 == entries.size());
+    slassert(15 == entries[0].get_uncompressed_size());
+    slassert("hello in-memory" == read_entry(archive, entries[0]));
+    slassert("" == read_entry(archive, entries[1]));
+    slassert(large == read_entry(archive, entries[2]));
+    slassert("bye" == read_entry(archive, entries[3]));
+}
+
+void test_cd_spill() {
+    auto archive = std::string();
+    {
+        // records are spilled into temporary file after 1KB
+        auto dest = seekable_string(archive);
+        auto zip = sl::compress::make_zip_sink(std::move(dest), 1024);
+        auto& sink = zip.get_sink();
+        slassert(!sink.is_cd_spilled());
+        for (size_t i = 0; i < 200; i++) {
+            auto name = "entry_" + sl::support::to_string(i) + ".txt";
+            if (0 == i % 2) {
+                sink.add_entry(name);
+                sink.write({name.data(), name.length()});
+            } else {
+                sink.add_entry(name, {name.data(), name.length()});
+            }
+        }
+        slassert(sink.is_cd_spilled());
+    }
+    auto src = seekable_string(archive);
+    auto entries = sl::compress::read_zip_central_directory(src);
+    slassert(200 == entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        auto name = "entry_" + sl::support::to_string(i) + ".txt";
+        slassert(name == entries[i].get_name());
+        slassert(name == read_entry(archive, entries[i]));
+    }
+}
+
+/**
+ * Source of the specified number of zero bytes
+ */
+class zeros_source {
+    uint64_t remaining;
+
+public:
+    zeros_source(uint64_t len) :
+    remaining(len) { }
+
+    std::streamsize read(sl::io::span<char> span) {
+        if (0 == remaining) return std::char_traits<char>::eof();
+        size_t len = static_cast<size_t>(std::min(static_cast<uint64_t>(span.size()), remaining));
+        std::memset(span.data(), 0, len);
+        remaining -= len;
+        return static_cast<std::streamsize>(len);
+    }
+};
+
+/**
+ * Seekable archive that keeps only the data written after the specified
+ * position, data before it is read back as zeros
+ */
+class sparse_archive {
+    uint64_t keep_from;
+    std::string tail;
+    uint64_t length = 0;
+    uint64_t pos = 0;
+
+public:
+    sparse_archive(uint64_t keep_from) :
+    keep_from(keep_from) { }
+
+    std::streamsize read(sl::io::span<char> span) {
+        if (pos >= length) return std::char_traits<char>::eof();
+        size_t len = static_cast<size_t>(std::min(static_cast<uint64_t>(span.size()), length - pos));
+        if (pos < keep_from) {
+            len = static_cast<size_t>(std::min(static_cast<uint64_t>(len), keep_from - pos));
+            std::memset(span.data(), 0, len);
+        } else {
+            std::memcpy(span.data(), tail.data() + (pos - keep_from), len);
+        }
+        pos += len;
+        return static_cast<std::streamsize>(len);
+    }
+
+    std::streamsize write(sl::io::span<const char> span) {
+        slassert(pos == length);
+        uint64_t end = pos + span.size();
+        if (end > keep_from) {
+            uint64_t start = std::max(pos, keep_from);
+            tail.append(span.data() + (start - pos), static_cast<size_t>(end - start));
+        }
+        pos = end;
+        length = end;
+        return span.size_signed();
+    }
+
+    std::streamsize flush() {
+        return 0;
+    }
+
+    std::streampos seek(std::streamsize offset, char whence = 'b') {
+        switch (whence) {
+        case 'c': pos += offset; break;
+        case 'e': pos = length + offset; break;
+        default: pos = offset;
+        }
+        return static_cast<std::streampos>(pos);
+    }
+};
+
+void test_zip64_entries() {
+    const size_t count = 70000;
+    auto archive = std::string();
+    {
+        auto zip = sl::compress::make_zip_sink(seekable_string(archive));
+        for (size_t i = 0; i < count; i++) {
+            auto name = "entry_" + sl::support::to_string(i) + ".txt";
+            zip.get_sink().add_entry(name, {name.data(), name.length()});
+        }
+    }
+    // EOCD count is saturated
+    slassert(0xFFFF == sl::compress::detail::decode_16_le(archive.data() + archive.length() - 22 + 10));
+    {
+        auto src = seekable_string(archive);
+        auto entries = sl::compress::read_zip_central_directory(src);
+        slassert(count == entries.size());
+        for (size_t i = 0; i < count; i++) {
+            auto name = "entry_" + sl::support::to_string(i) + ".txt";
+            slassert(name == entries[i].get_name());
+            if (0 == i % 1000 || count - 1 == i) {
+                slassert(name == read_entry(archive, entries[i]));
+            }
+        }
+    }
+    // append to ZIP64 archive
+    {
+        auto src = seekable_string(archive);
+        auto sink = sl::compress::make_zip_append_sink(seekable_string(archive), src);
+        sink.get_sink().add_entry("appended.txt");
+        sink.write({"again", 5});
+    }
+    auto src = seekable_string(archive);
+    auto entries = sl::compress::read_zip_central_directory(src);
+    slassert(count + 1 == entries.size());
+    slassert("entry_0.txt" == read_entry(archive, entries[0]));
+    slassert("again" == read_entry(archive, entries[count]));
+}
+
+void test_zip64_offsets() {
+    const uint64_t big_size = static_cast<uint64_t>(UINT32_MAX) + 10;
+    auto archive = sparse_archive(static_cast<uint64_t>(1) << 32);
+    {
+        auto zip = sl::compress::make_zip_sink(archive);
+        auto& sink = zip.get_sink();
+        auto zeros = zeros_source(big_size);
+        sink.add_raw_entry("big.bin", zeros, sl::compress::zip_compression_method::store,
+                0, big_size, big_size);
+        sink.add_entry("next.txt", {"next", 4});
+        sink.add_entry("streamed.txt");
+        sink.write({"streamed", 8});
+    }
+    auto entries = sl::compress::read_zip_central_directory(archive);
+    slassert(3 == entries.size());
+    slassert("big.bin" == entries[0].get_name());
+    slassert(big_size == entries[0].get_compressed_size());
+    slassert(big_size == entries[0].get_uncompressed_size());
+    slassert(0 == entries[0].get_offset());
+    slassert(entries[1].get_offset() > big_size);
+    slassert(entries[2].get_offset() > entries[1].get_offset());
+    for (size_t i = 1; i < entries.size(); i++) {
+        auto src = sl::compress::make_zip_entry_source(archive, entries[i]);
+        auto sink = sl::io::string_sink();
+        sl::io::copy_all(src, sink);
+        slassert((1 == i ? "next" : "streamed") == sink.get_string());
+    }
+}
+
 int main() {
     try {
         test_store();
+        test_append();
+        test_raw_copy();
+        test_precompressed();
+        test_in_memory();
+        test_cd_spill();
+        test_zip64_entries();
+        test_zip64_offsets();
     } catch (const std::exception& e) {
         std::cout << e.what() << std::endl;
         return 1;
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zip_source_test.cpp
+ * Author: alex
+ *
+ * Created on October 22, 2026, 11:20 AM
+ */
+
+#include "staticlib/compress/zip_source.hpp"
+
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+#include "staticlib/io.hpp"
+
+#include "staticlib/compress/zip_sink.hpp"
+
+std::string make_data(size_t len) {
+    auto res = std::string();
+    for (size_t i = 0; i < len; i++) {
+        res.push_back(static_cast<char>('a' + (i * i) % 11));
+    }
+    return res;
+}
+
+std::string make_archive(const std::string& big) {
+    auto ss = sl::io::string_sink();
+    {
+        auto sink = sl::compress::make_zip_sink(ss);
+        sink.get_sink().add_entry("foo.txt");
+        sink.write({"hello", 5});
+        // stored entry without data descriptor
+        auto stored = std::string("stored data");
+        auto crc = sl::compress::detail::zlib_crc32(0, stored.data(), stored.length());
+        auto src = sl::io::array_source(stored.data(), stored.length());
+        sink.get_sink().add_raw_entry("stored.txt", src, sl::compress::zip_compression_method::store,
+                crc, static_cast<uint32_t>(stored.length()), static_cast<uint32_t>(stored.length()));
+        sink.get_sink().add_entry("big.txt");
+        sl::io::write_all(sink, {big.data(), big.length()});
+        sink.get_sink().add_entry("bar/baz.txt");
+        sink.write({"bye", 3});
+    }
+    return ss.get_string();
+}
+
+std::string read_current(sl::compress::zip_source<sl::io::array_source>& zs) {
+    auto sink = sl::io::string_sink();
+    sl::io::copy_all(zs, sink);
+    return sink.get_string();
+}
+
+void test_read() {
+    auto big = make_data(100000);
+    auto archive = make_archive(big);
+    // not seekable
+    auto zs = sl::compress::make_zip_source(sl::io::array_source(archive.data(), archive.length()));
+
+    slassert(zs.next_entry());
+    slassert("foo.txt" == zs.get_entry().get_name());
+    slassert(sl::compress::zip_compression_method::deflate == zs.get_entry().get_method());
+    slassert(0 == zs.get_entry().get_offset());
+    slassert("hello" == read_current(zs));
+    // sizes from data descriptor
+    slassert(5 == zs.get_entry().get_uncompressed_size());
+
+    slassert(zs.next_entry());
+    slassert("stored.txt" == zs.get_entry().get_name());
+    slassert(sl::compress::zip_compression_method::store == zs.get_entry().get_method());
+    slassert("stored data" == read_current(zs));
+
+    slassert(zs.next_entry());
+    slassert("big.txt" == zs.get_entry().get_name());
+    slassert(big == read_current(zs));
+
+    slassert(zs.next_entry());
+    slassert("bar/baz.txt" == zs.get_entry().get_name());
+    slassert("bye" == read_current(zs));
+
+    slassert(!zs.next_entry());
+}
+
+void test_skip() {
+    auto big = make_data(100000);
+    auto archive = make_archive(big);
+    auto zs = sl::compress::make_zip_source(sl::io::array_source(archive.data(), archive.length()));
+    size_t count = 0;
+    while (zs.next_entry()) {
+        count += 1;
+    }
+    slassert(4 == count);
+}
+
+void test_corrupted() {
+    auto big = make_data(100000);
+    auto archive = make_archive(big);
+    // corrupt data descriptor CRC of the first entry
+    size_t desc = archive.find(std::string("\x50\x4b\x07\x08", 4));
+    slassert(std::string::npos != desc);
+    archive[desc + 4] ^= 1;
+    auto zs = sl::compress::make_zip_source(sl::io::array_source(archive.data(), archive.length()));
+    slassert(zs.next_entry());
+    bool thrown = false;
+    try {
+        read_current(zs);
+    } catch (const sl::compress::compress_exception&) {
+        thrown = true;
+    }
+    slassert(thrown);
+}
+
+int main() {
+    try {
+        test_read();
+        test_skip();
+        test_corrupted();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
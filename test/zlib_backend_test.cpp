@@ -0,0 +1,72 @@
+/*
+ * Copyright 2026, alex at staticlibs.net
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * File:   zlib_backend_test.cpp
+ * Author: alex
+ *
+ * Created on October 22, 2026, 3:05 PM
+ */
+
+#include "staticlib/compress/zlib_backend.hpp"
+
+#include <iostream>
+#include <string>
+
+#include "staticlib/config/assert.hpp"
+
+#include "staticlib/compress/deflate_buffer.hpp"
+
+void test_name() {
+    auto name = sl::compress::deflate_backend_name();
+#ifdef STATICLIB_COMPRESS_ENABLE_ZLIB_NG
+    slassert(0 == name.find("zlib-ng "));
+#else
+    slassert(0 == name.find("zlib "));
+#endif // STATICLIB_COMPRESS_ENABLE_ZLIB_NG
+    slassert(name.length() > 5);
+}
+
+void test_crc32() {
+    auto data = std::string("The quick brown fox jumps over the lazy dog");
+    slassert(0x414fa339 == sl::compress::detail::zlib_crc32(0, data.data(), data.length()));
+    // incremental
+    uint32_t crc = sl::compress::detail::zlib_crc32(0, data.data(), 10);
+    crc = sl::compress::detail::zlib_crc32(crc, data.data() + 10, data.length() - 10);
+    slassert(0x414fa339 == crc);
+}
+
+void test_roundtrip() {
+    auto data = std::string();
+    for (size_t i = 0; i < 1000; i++) {
+        data += "hello backend ";
+    }
+    auto compressed = sl::compress::deflate_buffer({data.data(), data.length()});
+    slassert(compressed.length() < data.length());
+    slassert(data == sl::compress::inflate_buffer({compressed.data(), compressed.length()}));
+}
+
+int main() {
+    try {
+        test_name();
+        test_crc32();
+        test_roundtrip();
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}